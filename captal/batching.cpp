@@ -0,0 +1,168 @@
+#include <iostream>
+#include <chrono>
+#include <array>
+
+#include <captal/engine.hpp>
+#include <captal/render_texture.hpp>
+#include <captal/render_batch.hpp>
+#include <captal/instanced_renderable.hpp>
+
+#include <captal/components/camera.hpp>
+#include <captal/components/drawable.hpp>
+#include <captal/components/node.hpp>
+
+#include <captal/systems/render.hpp>
+#include <captal/systems/frame.hpp>
+
+//Headless benchmark of cpt::systems::render against cpt::systems::batched_render and cpt::instanced_sprite.
+//It only needs a Vulkan device, so it also runs on software implementations such as lavapipe.
+
+namespace comp = cpt::components;
+
+static constexpr std::uint32_t target_size{1024};
+static constexpr std::uint32_t frame_count{200};
+static constexpr std::uint32_t texture_count{4};
+
+static std::array<cpt::texture_ptr, texture_count> make_textures()
+{
+    std::array<cpt::texture_ptr, texture_count> output{};
+
+    for(std::uint32_t i{}; i < texture_count; ++i)
+    {
+        const std::array<std::uint8_t, 4> pixel{static_cast<std::uint8_t>(64 * i), 128, 255, 255};
+
+        output[i] = cpt::make_texture(1, 1, std::data(pixel));
+    }
+
+    return output;
+}
+
+static void setup(entt::registry& world, const cpt::render_target_ptr& target, const std::array<cpt::texture_ptr, texture_count>& textures, std::uint32_t sprite_count)
+{
+    const auto camera{world.create()};
+    world.emplace<comp::node>(camera);
+    world.emplace<comp::camera>(camera, target).attachment().fit(target_size, target_size);
+
+    //Sprites are grouped in runs sharing the same texture, as a sorted scene would be
+    const std::uint32_t run_size{std::max(sprite_count / (texture_count * 4), 1u)};
+
+    for(std::uint32_t i{}; i < sprite_count; ++i)
+    {
+        const auto x{static_cast<float>((i * 7) % target_size)};
+        const auto y{static_cast<float>((i * 13) % target_size)};
+
+        const auto entity{world.create()};
+        world.emplace<comp::node>(entity, cpt::vec3f{x, y, 0.0f}, cpt::vec3f{4.0f, 4.0f, 0.0f}, cpt::vec3f{1.0f}, static_cast<float>(i) * 0.01f);
+        world.emplace<comp::drawable>(entity, std::in_place_type<cpt::sprite>, 8, 8, textures[(i / run_size) % texture_count]);
+    }
+}
+
+template<typename Render>
+static std::chrono::nanoseconds run(entt::registry& world, const cpt::render_texture_ptr& target, Render&& render)
+{
+    std::chrono::nanoseconds output{};
+
+    for(std::uint32_t i{}; i < frame_count; ++i)
+    {
+        //Move everything, so each frame has to transform all vertices again
+        world.view<comp::node>().each([](comp::node& node)
+        {
+            node.rotate(0.01f);
+        });
+
+        const auto begin{std::chrono::steady_clock::now()};
+
+        render(cpt::begin_render_options::reset);
+        cpt::engine::instance().submit_transfers();
+        target->present();
+
+        output += std::chrono::steady_clock::now() - begin;
+
+        target->wait();
+        cpt::systems::end_frame(world);
+    }
+
+    return output / frame_count;
+}
+
+static std::chrono::nanoseconds run_instanced(const cpt::render_texture_ptr& target, const cpt::texture_ptr& texture, std::uint32_t sprite_count)
+{
+    cpt::view view{target, cpt::render_technique_info{}, nullptr, cpt::render_technique_options::instanced};
+    view.fit(target_size, target_size);
+
+    cpt::instanced_sprite sprites{8, 8, texture, sprite_count};
+
+    std::chrono::nanoseconds output{};
+
+    for(std::uint32_t i{}; i < frame_count; ++i)
+    {
+        const auto begin{std::chrono::steady_clock::now()};
+
+        for(std::uint32_t j{}; j < sprite_count; ++j)
+        {
+            const auto x{static_cast<float>((j * 7) % target_size)};
+            const auto y{static_cast<float>((j * 13) % target_size)};
+
+            sprites.set_instance(j, cpt::vec3f{x, y, 0.0f}, static_cast<float>(j + i) * 0.01f, cpt::vec3f{1.0f}, cpt::vec3f{4.0f, 4.0f, 0.0f});
+        }
+
+        auto transfer{cpt::engine::instance().begin_transfer()};
+        view.upload(transfer);
+        sprites.upload(transfer);
+
+        if(auto render{target->begin_render(cpt::begin_render_options::reset)}; render)
+        {
+            view.bind(*render);
+            sprites.draw(*render, view);
+        }
+
+        cpt::engine::instance().submit_transfers();
+        target->present();
+
+        output += std::chrono::steady_clock::now() - begin;
+
+        target->wait();
+    }
+
+    return output / frame_count;
+}
+
+int main()
+{
+    cpt::engine engine{"captal_batching", cpt::version{0, 1, 0}};
+
+    const auto textures{make_textures()};
+
+    const tph::texture_info info{.format = tph::texture_format::r8g8b8a8_unorm, .usage = tph::texture_usage::color_attachment | tph::texture_usage::sampled};
+    const auto target{cpt::make_render_texture(cpt::make_texture(target_size, target_size, info))};
+
+    std::cout << "sprites;unbatched draws;unbatched us/frame;batched draws;batched us/frame;instanced us/frame\n";
+
+    for(const std::uint32_t sprite_count : {100u, 1000u, 10000u, 50000u})
+    {
+        entt::registry world{};
+        setup(world, target, textures, sprite_count);
+
+        const auto unbatched{run(world, target, [&world](cpt::begin_render_options options)
+        {
+            cpt::systems::render(world, options);
+        })};
+
+        cpt::render_batch batch{};
+
+        const auto batched{run(world, target, [&world, &batch](cpt::begin_render_options options)
+        {
+            cpt::systems::batched_render(world, batch, options);
+        })};
+
+        const auto draws{batch.statistics().draw_count / frame_count};
+        const auto instanced{run_instanced(target, textures[0], sprite_count)};
+
+        std::cout << sprite_count << ";"
+                  << sprite_count << ";"
+                  << std::chrono::duration<double, std::micro>{unbatched}.count() << ";"
+                  << draws << ";"
+                  << std::chrono::duration<double, std::micro>{batched}.count() << ";"
+                  << std::chrono::duration<double, std::micro>{instanced}.count() << "\n";
+    }
+}
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+
+#include <captal/engine.hpp>
+#include <captal/render_texture.hpp>
+#include <captal/renderable.hpp>
+#include <captal/view.hpp>
+
+//Headless benchmark of descriptor set allocation: creates, binds and destroys a large amount of renderables.
+//The first round allocates new descriptor pools, the next ones recycle the sets of the previous round.
+
+static constexpr std::uint32_t target_size{256};
+static constexpr std::uint32_t renderable_count{100000};
+static constexpr std::uint32_t round_count{5};
+
+int main()
+{
+    cpt::engine engine{"captal_descriptors", cpt::version{0, 1, 0}};
+
+    const tph::texture_info info{.format = tph::texture_format::r8g8b8a8_unorm, .usage = tph::texture_usage::color_attachment | tph::texture_usage::sampled};
+    const auto target{cpt::make_render_texture(cpt::make_texture(target_size, target_size, info))};
+
+    cpt::view view{target};
+    view.fit(target_size, target_size);
+
+    std::cout << "round;create us;bind us;destroy us\n";
+
+    for(std::uint32_t round{}; round < round_count; ++round)
+    {
+        std::vector<cpt::sprite> sprites{};
+        sprites.reserve(renderable_count);
+
+        const auto create_begin{std::chrono::steady_clock::now()};
+
+        for(std::uint32_t i{}; i < renderable_count; ++i)
+        {
+            sprites.emplace_back(1, 1);
+        }
+
+        const auto bind_begin{std::chrono::steady_clock::now()};
+
+        if(auto render{target->begin_render(cpt::begin_render_options::reset)}; render)
+        {
+            view.bind(*render);
+
+            //Binding allocates the descriptor set of each renderable
+            for(auto& sprite : sprites)
+            {
+                sprite.bind(*render, view);
+            }
+        }
+
+        const auto bind_end{std::chrono::steady_clock::now()};
+
+        auto transfer{cpt::engine::instance().begin_transfer()};
+        view.upload(transfer);
+
+        cpt::engine::instance().submit_transfers();
+        target->present();
+        target->wait();
+
+        const auto destroy_begin{std::chrono::steady_clock::now()};
+        sprites.clear();
+        const auto destroy_end{std::chrono::steady_clock::now()};
+
+        std::cout << round << ";"
+                  << std::chrono::duration<double, std::micro>{bind_begin - create_begin}.count() << ";"
+                  << std::chrono::duration<double, std::micro>{bind_end - bind_begin}.count() << ";"
+                  << std::chrono::duration<double, std::micro>{destroy_end - destroy_begin}.count() << "\n";
+    }
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+#include <captal/engine.hpp>
+#include <captal/render_texture.hpp>
+#include <captal/parallel_recorder.hpp>
+
+#include <captal/components/camera.hpp>
+#include <captal/components/drawable.hpp>
+#include <captal/components/node.hpp>
+
+#include <captal/systems/render.hpp>
+#include <captal/systems/frame.hpp>
+
+//Headless benchmark of cpt::systems::parallel_render with an increasing amount of recording threads.
+
+namespace comp = cpt::components;
+
+static constexpr std::uint32_t target_size{1024};
+static constexpr std::uint32_t frame_count{100};
+static constexpr std::uint32_t sprite_count{50000};
+
+static void setup(entt::registry& world, const cpt::render_target_ptr& target)
+{
+    const auto camera{world.create()};
+    world.emplace<comp::node>(camera);
+    world.emplace<comp::camera>(camera, target).attachment().fit(target_size, target_size);
+
+    for(std::uint32_t i{}; i < sprite_count; ++i)
+    {
+        const auto x{static_cast<float>((i * 7) % target_size)};
+        const auto y{static_cast<float>((i * 13) % target_size)};
+
+        const auto entity{world.create()};
+        world.emplace<comp::node>(entity, cpt::vec3f{x, y, 0.0f}, cpt::vec3f{4.0f, 4.0f, 0.0f});
+        world.emplace<comp::drawable>(entity, std::in_place_type<cpt::sprite>, 8, 8);
+    }
+}
+
+template<typename Render>
+static std::chrono::nanoseconds run(entt::registry& world, const cpt::render_texture_ptr& target, Render&& render)
+{
+    std::chrono::nanoseconds output{};
+
+    for(std::uint32_t i{}; i < frame_count; ++i)
+    {
+        world.view<comp::node>().each([](comp::node& node)
+        {
+            node.rotate(0.01f);
+        });
+
+        const auto begin{std::chrono::steady_clock::now()};
+
+        render(cpt::begin_render_options::reset);
+        cpt::engine::instance().submit_transfers();
+        target->present();
+
+        output += std::chrono::steady_clock::now() - begin;
+
+        target->wait();
+        cpt::systems::end_frame(world);
+    }
+
+    return output / frame_count;
+}
+
+int main()
+{
+    cpt::engine engine{"captal_parallel", cpt::version{0, 1, 0}};
+
+    const tph::texture_info info{.format = tph::texture_format::r8g8b8a8_unorm, .usage = tph::texture_usage::color_attachment | tph::texture_usage::sampled};
+    const auto target{cpt::make_render_texture(cpt::make_texture(target_size, target_size, info))};
+
+    entt::registry world{};
+    setup(world, target);
+
+    const auto reference{run(world, target, [&world](cpt::begin_render_options options)
+    {
+        cpt::systems::render(world, options);
+    })};
+
+    std::cout << "threads;us/frame;speedup\n";
+    std::cout << "serial;" << std::chrono::duration<double, std::micro>{reference}.count() << ";1\n";
+
+    const std::size_t max_threads{std::max(std::thread::hardware_concurrency(), 1u)};
+
+    for(std::size_t thread_count{1}; thread_count <= max_threads; thread_count *= 2)
+    {
+        cpt::parallel_recorder recorder{thread_count};
+
+        const auto time{run(world, target, [&world, &recorder](cpt::begin_render_options options)
+        {
+            cpt::systems::parallel_render(world, recorder, options);
+        })};
+
+        std::cout << thread_count << ";"
+                  << std::chrono::duration<double, std::micro>{time}.count() << ";"
+                  << std::chrono::duration<double>{reference} / std::chrono::duration<double>{time} << "\n";
+    }
+}
@@ -0,0 +1,328 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "asynchronous_resource.hpp"
+
+#include <mutex>
+#include <condition_variable>
+
+namespace cpt
+{
+
+namespace impl
+{
+
+//Active epochs live in a ring that covers every epoch from the oldest active one to the next one.
+//Each slot also holds the resources without owner whose last use is its epoch,
+//they are linked through themselves so burying a resource never allocates.
+//The ring only grows (in acquire) if more epochs than its size are alive at once.
+struct resource_graveyard
+{
+    struct slot
+    {
+        bool retired{};
+        asynchronous_resource* buried{};
+    };
+
+    static constexpr std::size_t initial_size{64};
+
+    std::mutex mutex{};
+    std::condition_variable handoff_condition{};
+    std::vector<slot> slots{std::vector<slot>(initial_size)};
+    std::uint64_t next{1};
+    std::atomic<std::uint64_t> oldest{1};
+
+    static resource_graveyard& instance() noexcept
+    {
+        static resource_graveyard output{};
+
+        return output;
+    }
+
+    slot& slot_of(std::uint64_t epoch) noexcept
+    {
+        return slots[epoch & (std::size(slots) - 1)];
+    }
+
+    std::uint64_t acquire()
+    {
+        std::lock_guard lock{mutex};
+
+        if(next - oldest.load(std::memory_order_relaxed) == std::size(slots))
+        {
+            std::vector<slot> new_slots(std::size(slots) * 2);
+
+            for(auto epoch{oldest.load(std::memory_order_relaxed)}; epoch < next; ++epoch)
+            {
+                new_slots[epoch & (std::size(new_slots) - 1)] = slot_of(epoch);
+            }
+
+            slots = std::move(new_slots);
+        }
+
+        slot_of(next) = slot{};
+
+        return next++;
+    }
+
+    void retire(std::uint64_t epoch) noexcept
+    {
+        asynchronous_resource* dead{};
+
+        {
+            std::lock_guard lock{mutex};
+
+            slot_of(epoch).retired = true;
+
+            const auto old_oldest{oldest.load(std::memory_order_relaxed)};
+
+            auto new_oldest{old_oldest};
+            while(new_oldest < next && slot_of(new_oldest).retired)
+            {
+                ++new_oldest;
+            }
+
+            oldest.store(new_oldest, std::memory_order_release);
+
+            //Only the buckets of the epochs that are no longer covered are visited.
+            //Their resources may have been stamped again by a more recent epoch, in that case they are moved to its bucket.
+            for(auto current{old_oldest}; current < new_oldest; ++current)
+            {
+                auto resource{std::exchange(slot_of(current).buried, nullptr)};
+
+                while(resource)
+                {
+                    const auto next_resource{resource->m_next};
+
+                    if(resource->last_use() < new_oldest)
+                    {
+                        resource->m_buried = 0;
+                        resource->m_previous = nullptr;
+                        resource->m_next = std::exchange(dead, resource);
+                    }
+                    else
+                    {
+                        bury(resource);
+                    }
+
+                    resource = next_resource;
+                }
+            }
+        }
+
+        //Resources are recycled without the lock, they may release other deferred resources.
+        recycle(dead);
+    }
+
+    void release(asynchronous_resource* resource) noexcept
+    {
+        {
+            std::lock_guard lock{mutex};
+
+            if(resource->m_handoff)
+            {
+                resource->m_handoff = false;
+                handoff_condition.notify_all();
+
+                return;
+            }
+
+            if(resource->last_use() >= oldest.load(std::memory_order_relaxed))
+            {
+                bury(resource);
+
+                return;
+            }
+        }
+
+        asynchronous_resource_deleter::recycle(resource);
+    }
+
+    asynchronous_resource_ptr pin(asynchronous_resource* resource)
+    {
+        //Locked as a whole, a new owner rebinds the weak reference of the resource
+        std::unique_lock lock{mutex};
+
+        if(auto output{resource->weak_from_this().lock()}; output)
+        {
+            return output;
+        }
+
+        //The resource has no owner anymore. It can not have been destroyed since it is stamped with an epoch that is still active,
+        //but its deleter may not have run yet, in that case we wait for it to hand the resource over.
+        if(resource->m_buried != 0)
+        {
+            unbury(resource);
+        }
+        else
+        {
+            resource->m_handoff = true;
+
+            handoff_condition.wait(lock, [resource]
+            {
+                return !resource->m_handoff;
+            });
+        }
+
+        return asynchronous_resource_ptr{resource, asynchronous_resource_deleter{}};
+    }
+
+    void flush() noexcept
+    {
+        asynchronous_resource* dead{};
+
+        {
+            std::lock_guard lock{mutex};
+
+            for(auto current{oldest.load(std::memory_order_relaxed)}; current < next; ++current)
+            {
+                auto resource{std::exchange(slot_of(current).buried, nullptr)};
+
+                while(resource)
+                {
+                    const auto next_resource{resource->m_next};
+
+                    resource->m_buried = 0;
+                    resource->m_previous = nullptr;
+                    resource->m_next = std::exchange(dead, resource);
+
+                    resource = next_resource;
+                }
+            }
+        }
+
+        recycle(dead);
+    }
+
+    //Must be called with the lock held, the resource last use must be an active epoch
+    void bury(asynchronous_resource* resource) noexcept
+    {
+        resource->m_buried = resource->last_use();
+
+        auto& head{slot_of(resource->m_buried).buried};
+
+        resource->m_previous = nullptr;
+        resource->m_next = head;
+
+        if(head)
+        {
+            head->m_previous = resource;
+        }
+
+        head = resource;
+    }
+
+    //Must be called with the lock held
+    void unbury(asynchronous_resource* resource) noexcept
+    {
+        if(resource->m_previous)
+        {
+            resource->m_previous->m_next = resource->m_next;
+        }
+        else
+        {
+            slot_of(resource->m_buried).buried = resource->m_next;
+        }
+
+        if(resource->m_next)
+        {
+            resource->m_next->m_previous = resource->m_previous;
+        }
+
+        resource->m_buried = 0;
+        resource->m_previous = nullptr;
+        resource->m_next = nullptr;
+    }
+
+    static void recycle(asynchronous_resource* dead) noexcept
+    {
+        while(dead)
+        {
+            const auto resource{dead};
+            dead = std::exchange(resource->m_next, nullptr);
+
+            asynchronous_resource_deleter::recycle(resource);
+        }
+    }
+};
+
+}
+
+std::uint64_t acquire_resource_epoch()
+{
+    return impl::resource_graveyard::instance().acquire();
+}
+
+void retire_resource_epoch(std::uint64_t epoch) noexcept
+{
+    impl::resource_graveyard::instance().retire(epoch);
+}
+
+std::uint64_t oldest_resource_epoch() noexcept
+{
+    return impl::resource_graveyard::instance().oldest.load(std::memory_order_acquire);
+}
+
+void flush_asynchronous_resources() noexcept
+{
+    impl::resource_graveyard::instance().flush();
+}
+
+void asynchronous_resource_deleter::recycle(asynchronous_resource* resource) noexcept
+{
+    resource->recycle();
+}
+
+void asynchronous_resource_deleter::operator()(asynchronous_resource* resource) const noexcept
+{
+    if(resource->last_use() < oldest_resource_epoch())
+    {
+        asynchronous_resource_deleter::recycle(resource);
+    }
+    else
+    {
+        impl::resource_graveyard::instance().release(resource);
+    }
+}
+
+void asynchronous_resource_keeper::pin()
+{
+    compact();
+
+    m_resources.reserve(std::size(m_resources) + std::size(m_deferred));
+    for(auto resource : m_deferred)
+    {
+        m_resources.emplace_back(impl::resource_graveyard::instance().pin(resource));
+    }
+
+    m_deferred.clear();
+
+    release_epoch();
+}
+
+void asynchronous_resource_keeper::compact() noexcept
+{
+    std::sort(std::begin(m_deferred), std::end(m_deferred));
+    m_deferred.erase(std::unique(std::begin(m_deferred), std::end(m_deferred)), std::end(m_deferred));
+}
+
+}
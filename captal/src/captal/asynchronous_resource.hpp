@@ -26,43 +26,214 @@
 #include "config.hpp"
 
 #include <memory>
+#include <cassert>
 #include <vector>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include <iterator>
 
 namespace cpt
 {
 
-class CAPTAL_API asynchronous_resource
+class asynchronous_resource;
+
+namespace impl
+{
+
+struct resource_graveyard;
+
+}
+
+//Resources created by make_asynchronous_resource are not destroyed when their last owner releases them,
+//but when every frame epoch that may still use them on the GPU has been retired.
+//Epochs are acquired by keepers on their first use and retired when they are cleared (after their fence has been waited).
+CAPTAL_API std::uint64_t acquire_resource_epoch();
+CAPTAL_API void retire_resource_epoch(std::uint64_t epoch) noexcept;
+CAPTAL_API std::uint64_t oldest_resource_epoch() noexcept;
+//Destroys every pending resource regardless of the active epochs, the device must be idle.
+CAPTAL_API void flush_asynchronous_resources() noexcept;
+
+struct CAPTAL_API asynchronous_resource_deleter
+{
+    void operator()(asynchronous_resource* resource) const noexcept;
+
+    static void recycle(asynchronous_resource* resource) noexcept;
+};
+
+class CAPTAL_API asynchronous_resource : public std::enable_shared_from_this<asynchronous_resource>
 {
+    template<typename T, typename... Args>
+    friend std::shared_ptr<T> make_asynchronous_resource(Args&&... args);
+    friend struct asynchronous_resource_deleter;
+    friend struct impl::resource_graveyard;
+
 public:
     asynchronous_resource() noexcept = default;
     virtual ~asynchronous_resource() = default;
 
+    void mark_used(std::uint64_t epoch) noexcept
+    {
+        auto current{m_last_use.load(std::memory_order_relaxed)};
+        while(current < epoch && !m_last_use.compare_exchange_weak(current, epoch, std::memory_order_relaxed));
+    }
+
+    std::uint64_t last_use() const noexcept
+    {
+        return m_last_use.load(std::memory_order_relaxed);
+    }
+
+    bool in_use() const noexcept
+    {
+        return last_use() >= oldest_resource_epoch();
+    }
+
+    bool deferred() const noexcept
+    {
+        return m_deferred;
+    }
+
 protected:
-    asynchronous_resource(const asynchronous_resource&) = default;
-    asynchronous_resource& operator=(const asynchronous_resource&) = default;
-    asynchronous_resource(asynchronous_resource&& other) noexcept = default;
-    asynchronous_resource& operator=(asynchronous_resource&& other) noexcept = default;
+    //Called once the resource has no owner and no active epoch may use it anymore.
+    //Resources that are pooled can override it to get back to their pool instead of being destroyed.
+    virtual void recycle() noexcept
+    {
+        delete this;
+    }
+
+    asynchronous_resource(const asynchronous_resource&) noexcept
+    :enable_shared_from_this{}
+    {
+
+    }
+
+    asynchronous_resource& operator=(const asynchronous_resource&) noexcept
+    {
+        return *this;
+    }
+
+    asynchronous_resource(asynchronous_resource&& other) noexcept
+    :enable_shared_from_this{}
+    ,m_last_use{other.last_use()}
+    {
+
+    }
+
+    asynchronous_resource& operator=(asynchronous_resource&& other) noexcept
+    {
+        mark_used(other.last_use());
+
+        return *this;
+    }
+
+private:
+    std::atomic<std::uint64_t> m_last_use{};
+    bool m_deferred{};
+
+    //Graveyard bookkeeping, only used once the resource has no owner, see asynchronous_resource.cpp
+    asynchronous_resource* m_previous{};
+    asynchronous_resource* m_next{};
+    std::uint64_t m_buried{};
+    bool m_handoff{};
 };
 
 using asynchronous_resource_ptr = std::shared_ptr<asynchronous_resource>;
 using asynchronous_resource_weak_ptr = std::weak_ptr<asynchronous_resource>;
 
+template<typename T, typename... Args>
+std::shared_ptr<T> make_asynchronous_resource(Args&&... args)
+{
+    static_assert(std::is_base_of_v<asynchronous_resource, T>, "cpt::make_asynchronous_resource called with a type that is not an asynchronous resource.");
+
+    auto resource{std::make_unique<T>(std::forward<Args>(args)...)};
+    static_cast<asynchronous_resource&>(*resource).m_deferred = true;
+
+    return std::shared_ptr<T>{resource.release(), asynchronous_resource_deleter{}};
+}
+
 class CAPTAL_API asynchronous_resource_keeper
 {
 public:
     asynchronous_resource_keeper() = default;
-    ~asynchronous_resource_keeper() = default;
+
+    ~asynchronous_resource_keeper()
+    {
+        clear();
+    }
+
     asynchronous_resource_keeper(const asynchronous_resource_keeper&) = delete;
     asynchronous_resource_keeper& operator=(const asynchronous_resource_keeper&) = delete;
-    asynchronous_resource_keeper(asynchronous_resource_keeper&&) noexcept = default;
-    asynchronous_resource_keeper& operator=(asynchronous_resource_keeper&&) noexcept = default;
+
+    asynchronous_resource_keeper(asynchronous_resource_keeper&& other) noexcept
+    :m_resources{std::move(other.m_resources)}
+    ,m_deferred{std::move(other.m_deferred)}
+    ,m_epoch{std::exchange(other.m_epoch, 0)}
+    ,m_borrowed{std::exchange(other.m_borrowed, false)}
+    {
+
+    }
+
+    asynchronous_resource_keeper& operator=(asynchronous_resource_keeper&& other) noexcept
+    {
+        clear();
+
+        m_resources = std::move(other.m_resources);
+        m_deferred = std::move(other.m_deferred);
+        m_epoch = std::exchange(other.m_epoch, 0);
+        m_borrowed = std::exchange(other.m_borrowed, false);
+
+        return *this;
+    }
+
+    //Stamps resources with the epoch of owner until the next clear, this keeper never retires it.
+    //Keepers that share an epoch deduplicate their resources together, so they must all be merged into owner before it is pinned.
+    void borrow_epoch(asynchronous_resource_keeper& owner)
+    {
+        assert(m_epoch == 0 && "cpt::asynchronous_resource_keeper::borrow_epoch called on a keeper that already has an epoch.");
+
+        m_epoch = owner.epoch();
+        m_borrowed = true;
+    }
 
     template<typename T>
     void keep(T&& resource)
     {
-        static_assert(!std::is_pointer_v<T>, "cpt::asynchronous_resource_keeper::keep called with raw pointer.");
+        static_assert(!std::is_pointer_v<std::decay_t<T>>, "cpt::asynchronous_resource_keeper::keep called with raw pointer.");
 
-        m_resources.emplace_back(std::forward<T>(resource));
+        if(!resource)
+        {
+            return;
+        }
+
+        //Deferred resources only get stamped with our epoch, no reference count is touched.
+        if(resource->deferred())
+        {
+            keep_deferred(*resource);
+        }
+        else
+        {
+            m_resources.emplace_back(std::forward<T>(resource));
+        }
+    }
+
+    //Keeps a deferred resource without any owning pointer to it, used by owners that hand out parts of their resources.
+    //A resource already stamped with our epoch is already in the list. Interleaved keepers stamp the same resource in turn,
+    //so the list is deduplicated before it grows, it never holds more than twice the number of distinct resources.
+    void keep_deferred(asynchronous_resource& resource)
+    {
+        const auto current{epoch()};
+
+        if(resource.last_use() != current)
+        {
+            resource.mark_used(current);
+
+            if(std::size(m_deferred) == m_deferred.capacity())
+            {
+                compact();
+            }
+
+            m_deferred.emplace_back(&resource);
+        }
     }
 
     template<std::input_iterator InputIt>
@@ -70,21 +241,77 @@ public:
     {
         static_assert(!std::is_pointer_v<typename std::iterator_traits<InputIt>::value_type>, "cpt::asynchronous_resource_keeper::keep called with raw pointer.");
 
-        m_resources.insert(std::end(m_resources), begin, end);
+        for(; begin != end; ++begin)
+        {
+            keep(*begin);
+        }
+    }
+
+    //Takes every resource kept by other, and retires its epoch. Used to gather keepers filled on several threads.
+    void merge(asynchronous_resource_keeper& other)
+    {
+        if(const auto current{epoch()}; other.m_epoch != current)
+        {
+            for(auto resource : other.m_deferred)
+            {
+                resource->mark_used(current);
+            }
+        }
+
+        m_deferred.insert(std::end(m_deferred), std::begin(other.m_deferred), std::end(other.m_deferred));
+        m_resources.insert(std::end(m_resources), std::make_move_iterator(std::begin(other.m_resources)), std::make_move_iterator(std::end(other.m_resources)));
+
+        other.clear();
     }
 
     void reserve(std::size_t size)
     {
-        m_resources.reserve(std::size(m_resources) + size);
+        m_deferred.reserve(std::size(m_deferred) + size);
     }
 
+    //Turns the epoch-based references into strong ones and retires the epoch.
+    //Must be called when the recorded work is going to be submitted again without being reset,
+    //otherwise the keeper's epoch stays active and holds back the destruction of every resource used after it.
+    void pin();
+
+    //Does not allocate. It may destroy or recycle the resources whose last epoch is retired.
     void clear() noexcept
     {
         m_resources.clear();
+        m_deferred.clear();
+
+        release_epoch();
+    }
+
+private:
+    void compact() noexcept;
+
+    void release_epoch() noexcept
+    {
+        if(m_epoch != 0 && !m_borrowed)
+        {
+            retire_resource_epoch(m_epoch);
+        }
+
+        m_epoch = 0;
+        m_borrowed = false;
+    }
+
+    std::uint64_t epoch()
+    {
+        if(m_epoch == 0)
+        {
+            m_epoch = acquire_resource_epoch();
+        }
+
+        return m_epoch;
     }
 
 private:
     std::vector<asynchronous_resource_ptr> m_resources{};
+    std::vector<asynchronous_resource*> m_deferred{};
+    std::uint64_t m_epoch{};
+    bool m_borrowed{};
 };
 
 }
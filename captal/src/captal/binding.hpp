@@ -108,6 +108,11 @@ inline tph::descriptor_write make_descriptor_write(tph::descriptor_set& set, std
 
         const tph::descriptor_buffer_info info{buffer.buffer, buffer.offset + part.buffer->part_offset(part.part), part.buffer->part_size(part.part)};
 
+        if(part.buffer->part_type(part.part) == buffer_part_type::storage)
+        {
+            return tph::descriptor_write{set, binding, 0, tph::descriptor_type::storage_buffer, info};
+        }
+
         return tph::descriptor_write{set, binding, 0, tph::descriptor_type::uniform_buffer, info};
     }
 }
@@ -151,6 +156,11 @@ public:
         return index < std::size(m_bindings) && get_binding_resource(m_bindings[index]) != nullptr;
     }
 
+    std::size_t size() const noexcept
+    {
+        return std::size(m_bindings);
+    }
+
 private:
     void assure(std::size_t index)
     {
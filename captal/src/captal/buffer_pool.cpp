@@ -22,6 +22,8 @@
 
 #include "buffer_pool.hpp"
 
+#include <bit>
+
 #include <captal_foundation/stack_allocator.hpp>
 
 #include "engine.hpp"
@@ -180,11 +182,6 @@ void buffer_heap::set_name(std::string_view name)
 
     tph::set_object_name(engine::instance().device(), m_local_data, m_name + " host buffer");
     tph::set_object_name(engine::instance().device(), m_device_data, m_name + " device buffer");
-
-    for(std::size_t i{}; i < std::size(m_stagings); ++i)
-    {
-        tph::set_object_name(engine::instance().device(), m_stagings[i].buffer, m_name + " staging buffer #" + std::to_string(i));
-    }
 }
 #endif
 
@@ -212,7 +209,7 @@ static ForwardIt coalesce(ForwardIt begin, ForwardIt end)
     return result;
 }
 
-bool buffer_heap::begin_upload(tph::command_buffer& command_buffer)
+bool buffer_heap::begin_upload(memory_transfer_info info)
 {
     std::unique_lock lock{m_upload_mutex};
 
@@ -234,97 +231,35 @@ bool buffer_heap::begin_upload(tph::command_buffer& command_buffer)
         return left + right.size;
     };
 
-    const std::uint64_t total_size {std::accumulate(std::begin(m_upload_ranges), std::end(m_upload_ranges), 0ull, accumulator)};
-    const std::uint64_t chunk_size {m_size / 4ull};
-    const std::uint64_t chunk_count{(total_size + chunk_size) / chunk_size};
-    const std::uint64_t chunk_mask {(1ull << chunk_count) - 1ull};
+    const std::uint64_t total_size{std::accumulate(std::begin(m_upload_ranges), std::end(m_upload_ranges), 0ull, accumulator)};
 
-    const auto find_staging = [this, chunk_mask]
-    {
-        for(std::size_t i{}; i < std::size(m_stagings); ++i)
-        {
-            for(std::uint64_t mask{chunk_mask}; mask < 0x10; mask <<= 1)
-            {
-                if((m_stagings[i].used & mask) == 0)
-                {
-                    return std::make_pair(i, mask);
-                }
-            }
-        }
+    m_staging = engine::instance().transfer_scheduler().allocate_staging(info, total_size);
 
-        return std::make_pair(std::numeric_limits<std::size_t>::max(), std::uint64_t{});
-    };
-
-    const auto [staging_index, mask] = find_staging();
-
-    if(staging_index != std::numeric_limits<std::size_t>::max())
-    {
-        m_current_staging = staging_index;
-        m_current_mask = mask;
-
-        for(std::size_t i{}; i < 4; ++i) //find base index of the staging
-        {
-            if(((m_current_mask >> i) & 0x01) != 0)
-            {
-                m_current_mask_index = i;
-                break;
-            }
-        }
-    }
-    else
-    {
-        constexpr auto usage{tph::buffer_usage::transfer_src | tph::buffer_usage::transfer_dest};
-
-        tph::buffer buf{engine::instance().device(), m_size, usage};
-        std::uint8_t* map{buf.map()};
-        m_stagings.emplace_back(staging_buffer{std::move(buf), map});
-
-        #ifdef CAPTAL_DEBUG
-        if(!std::empty(m_name))
-        {
-            tph::set_object_name(engine::instance().device(), m_stagings.back().buffer, m_name + " staging buffer #" + std::to_string(std::size(m_stagings) - 1));
-        }
-        #endif
-
-        m_current_staging = std::size(m_stagings) - 1;
-        m_current_mask = chunk_mask;
-        m_current_mask_index = 0;
-    }
-
-    std::uint64_t current_offset{chunk_size * m_current_mask_index};
+    std::uint64_t current_offset{m_staging.offset};
     for(auto& range : m_upload_ranges)
     {
         range.dest_offset = current_offset;
         current_offset += range.size;
     }
 
-    staging_buffer& staging{m_stagings[m_current_staging]};
-    staging.used |= m_current_mask;
-
     lock.release();
 
     return true;
 }
 
-void buffer_heap::end_upload(tph::command_buffer& command_buffer, transfer_ended_signal& signal)
+void buffer_heap::end_upload(memory_transfer_info info)
 {
     std::unique_lock lock{m_upload_mutex, std::adopt_lock};
 
-    staging_buffer& staging{m_stagings[m_current_staging]};
-
     for(auto& range : m_upload_ranges)
     {
-        std::memcpy(staging.map + range.dest_offset, m_local_map + range.src_offset, range.size);
+        std::memcpy(m_staging.map + (range.dest_offset - m_staging.offset), m_local_map + range.src_offset, range.size);
         std::swap(range.src_offset, range.dest_offset);
     }
 
-    tph::cmd::copy(command_buffer, staging.buffer, m_device_data, m_upload_ranges);
+    tph::cmd::copy(info.buffer, *m_staging.buffer, m_device_data, m_upload_ranges);
     m_upload_ranges.clear();
-
-    staging.connection[m_current_mask_index] = signal.connect([this, index = m_current_staging, mask = m_current_mask]()
-    {
-        m_stagings[index].used &= ~mask;
-    });
+    m_staging = staging_chunk{};
 }
 
 void buffer_heap::register_upload(std::uint64_t offset, std::uint64_t size) noexcept
@@ -354,6 +289,14 @@ void buffer_heap::unregister_chunk(const buffer_heap_chunk& chunk) noexcept
     m_ranges.erase(it);
 }
 
+transient_buffer_page::transient_buffer_page(std::uint64_t size, tph::buffer_usage usage)
+:m_buffer{engine::instance().device(), size, usage | tph::buffer_usage::staging}
+,m_size{size}
+,m_map{m_buffer.map()}
+{
+
+}
+
 buffer_pool::buffer_pool(tph::buffer_usage pool_usage, std::uint64_t pool_size)
 :m_pool_usage{pool_usage}
 ,m_pool_size{pool_size}
@@ -435,6 +378,71 @@ buffer_heap_chunk buffer_pool::allocate(std::uint64_t size, std::uint64_t alignm
     return chunk;
 }
 
+transient_buffer_chunk buffer_pool::allocate_transient(asynchronous_resource_keeper& keeper, std::uint64_t size, std::uint64_t alignment)
+{
+    auto page{m_transient_page.load(std::memory_order_acquire)};
+
+    while(true)
+    {
+        if(page)
+        {
+            //Stamped before the allocation, so the page can not be reused while our frame may read it
+            keeper.keep_deferred(*page);
+
+            const auto offset{page->m_head.fetch_add(size + alignment - 1, std::memory_order_acq_rel)};
+            const auto begin {align_up(offset, alignment)};
+
+            if(begin + size <= page->m_size)
+            {
+                return transient_buffer_chunk{page, begin, size};
+            }
+        }
+
+        page = &next_transient_page(page, size + alignment - 1);
+    }
+}
+
+transient_buffer_page& buffer_pool::next_transient_page(transient_buffer_page* full, std::uint64_t size)
+{
+    std::lock_guard lock{m_transient_mutex};
+
+    //Another thread may already have replaced the full page
+    if(const auto current{m_transient_page.load(std::memory_order_acquire)}; current != full)
+    {
+        return *current;
+    }
+
+    //Pages other than the current one are full, they can be reused once no frame that used them is pending.
+    //The exchange fails if a late allocation is still going on, it will fail anyway since the page is full.
+    for(auto& page : m_transient_pages)
+    {
+        if(page.get() != full && page->m_size >= size && !page->in_use())
+        {
+            auto head{page->m_head.load(std::memory_order_acquire)};
+
+            if(page->m_head.compare_exchange_strong(head, 0, std::memory_order_acq_rel))
+            {
+                m_transient_page.store(page.get(), std::memory_order_release);
+
+                return *page;
+            }
+        }
+    }
+
+    auto& page{m_transient_pages.emplace_back(make_asynchronous_resource<transient_buffer_page>(std::max(m_pool_size, std::bit_ceil(size)), m_pool_usage))};
+
+    #ifdef CAPTAL_DEBUG
+    if(!std::empty(m_name))
+    {
+        tph::set_object_name(engine::instance().device(), page->buffer(), m_name + " transient page #" + std::to_string(std::size(m_transient_pages) - 1));
+    }
+    #endif
+
+    m_transient_page.store(page.get(), std::memory_order_release);
+
+    return *page;
+}
+
 void buffer_pool::upload(memory_transfer_info info)
 {
     std::lock_guard lock{m_mutex};
@@ -445,7 +453,7 @@ void buffer_pool::upload(memory_transfer_info info)
 
     for(std::size_t i{}; i < std::size(m_heaps); ++i)
     {
-        m_to_end[i] = m_heaps[i]->begin_upload(info.buffer);
+        m_to_end[i] = m_heaps[i]->begin_upload(info);
     }
 
     tph::cmd::pipeline_barrier(info.buffer, tph::resource_access::transfer_write, tph::resource_access::transfer_read, tph::dependency_flags::none,
@@ -455,7 +463,7 @@ void buffer_pool::upload(memory_transfer_info info)
     {
         if(m_to_end[i])
         {
-            m_heaps[i]->end_upload(info.buffer, info.signal);
+            m_heaps[i]->end_upload(info);
         }
     }
 
@@ -492,6 +500,13 @@ void buffer_pool::set_name(std::string_view name)
     {
         m_heaps[i]->set_name(m_name + " heap #" + std::to_string(i));
     }
+
+    std::lock_guard transient_lock{m_transient_mutex};
+
+    for(std::size_t i{}; i < std::size(m_transient_pages); ++i)
+    {
+        tph::set_object_name(engine::instance().device(), m_transient_pages[i]->buffer(), m_name + " transient page #" + std::to_string(i));
+    }
 }
 #endif
 
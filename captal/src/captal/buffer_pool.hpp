@@ -27,6 +27,7 @@
 
 #include <tephra/buffer.hpp>
 
+#include "asynchronous_resource.hpp"
 #include "signal.hpp"
 #include "memory_transfer.hpp"
 
@@ -149,25 +150,15 @@ public:
 #endif
 
 private:
-    bool begin_upload(tph::command_buffer& command_buffer);
-    void end_upload(tph::command_buffer& command_buffer, transfer_ended_signal& signal);
+    bool begin_upload(memory_transfer_info info);
+    void end_upload(memory_transfer_info info);
 
     void register_upload(std::uint64_t offset, std::uint64_t size) noexcept;
     void unregister_chunk(const buffer_heap_chunk& chunk) noexcept;
 
-private:
-    struct staging_buffer
-    {
-        tph::buffer buffer{};
-        std::uint8_t* map{};
-        std::uint64_t used{}; //only 4 bits are used
-        std::array<cpt::scoped_connection, 4> connection{};
-    };
-
 private:
     tph::buffer m_local_data{};
     tph::buffer m_device_data{};
-    std::vector<staging_buffer> m_stagings{};
     std::uint64_t m_size{};
     std::uint8_t* m_local_map{};
     std::atomic<std::uint64_t> m_free_space{};
@@ -176,9 +167,7 @@ private:
     std::mutex m_mutex{};
 
     std::vector<tph::buffer_copy> m_upload_ranges{};
-    std::size_t m_current_staging{};
-    std::uint64_t m_current_mask{};
-    std::uint64_t m_current_mask_index{};
+    staging_chunk m_staging{};
     std::mutex m_upload_mutex{};
 
 #ifdef CAPTAL_DEBUG
@@ -186,6 +175,68 @@ private:
 #endif
 };
 
+//Persistently mapped, host-visible page of a buffer_pool's transient memory
+class CAPTAL_API transient_buffer_page final : public asynchronous_resource
+{
+    friend class buffer_pool;
+
+public:
+    explicit transient_buffer_page(std::uint64_t size, tph::buffer_usage usage);
+    ~transient_buffer_page() = default;
+    transient_buffer_page(const transient_buffer_page&) = delete;
+    transient_buffer_page& operator=(const transient_buffer_page&) = delete;
+    transient_buffer_page(transient_buffer_page&&) noexcept = delete;
+    transient_buffer_page& operator=(transient_buffer_page&&) noexcept = delete;
+
+    tph::buffer& buffer() noexcept
+    {
+        return m_buffer;
+    }
+
+    const tph::buffer& buffer() const noexcept
+    {
+        return m_buffer;
+    }
+
+    std::uint64_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    std::uint8_t* map() noexcept
+    {
+        return m_map;
+    }
+
+    const std::uint8_t* map() const noexcept
+    {
+        return m_map;
+    }
+
+private:
+    tph::buffer m_buffer{};
+    std::uint64_t m_size{};
+    std::uint8_t* m_map{};
+    std::atomic<std::uint64_t> m_head{};
+};
+
+struct transient_buffer_chunk
+{
+    transient_buffer_page* page{};
+    std::uint64_t offset{};
+    std::uint64_t size{};
+
+    tph::buffer& buffer() const noexcept
+    {
+        return page->buffer();
+    }
+
+    void* map() const noexcept
+    {
+        return page->map() + offset;
+    }
+};
+
 class CAPTAL_API buffer_pool
 {
 public:
@@ -197,6 +248,12 @@ public:
     buffer_pool& operator=(buffer_pool&&) noexcept = delete;
 
     buffer_heap_chunk allocate(std::uint64_t size, std::uint64_t alignment);
+
+    //Memory for data rebuilt every frame. Allocation is a single atomic add in host-visible memory that the device reads directly,
+    //so there is nothing to upload. The chunk stays valid until the work recorded with keeper, and with every keeper that
+    //keeps chunk.page afterward, has been executed; then its page is reused as a whole.
+    transient_buffer_chunk allocate_transient(asynchronous_resource_keeper& keeper, std::uint64_t size, std::uint64_t alignment);
+
     void upload(memory_transfer_info info);
     void upload();
     void clean();
@@ -210,6 +267,9 @@ public:
     }
 #endif
 
+private:
+    transient_buffer_page& next_transient_page(transient_buffer_page* full, std::uint64_t size);
+
 private:
     tph::buffer_usage m_pool_usage{};
     std::uint64_t m_pool_size{};
@@ -218,6 +278,10 @@ private:
     std::vector<std::unique_ptr<buffer_heap>> m_heaps{};
     mutable std::mutex m_mutex{};
 
+    std::vector<std::shared_ptr<transient_buffer_page>> m_transient_pages{};
+    std::atomic<transient_buffer_page*> m_transient_page{};
+    std::mutex m_transient_mutex{};
+
 #ifdef CAPTAL_DEBUG
     std::string m_name{};
 #endif
@@ -26,7 +26,11 @@
 #include "../config.hpp"
 
 #include <cmath>
+#include <algorithm>
 #include <numbers>
+#include <vector>
+#include <span>
+#include <utility>
 
 #include <captal_foundation/math.hpp>
 
@@ -36,6 +40,63 @@ namespace cpt
 namespace components
 {
 
+//List of the nodes updated since last clear, in update order, each node is recorded at most once.
+//Systems use it so their cost only depends on the number of updated nodes, see systems::node_tracker.
+//The list never allocates when a node is updated: once its reserved storage is full the tracker overflows,
+//and systems visit every node until the next clear.
+class CAPTAL_API node_tracker
+{
+public:
+    node_tracker() = default;
+    ~node_tracker() = default;
+    node_tracker(const node_tracker&) = delete;
+    node_tracker& operator=(const node_tracker&) = delete;
+    node_tracker(node_tracker&&) noexcept = default;
+    node_tracker& operator=(node_tracker&&) noexcept = default;
+
+    //Returns false if the tracker overflowed
+    bool push(std::uint32_t id) noexcept
+    {
+        if(std::size(m_updated) == m_updated.capacity())
+        {
+            m_overflow = true;
+            return false;
+        }
+
+        m_updated.emplace_back(id);
+
+        return true;
+    }
+
+    void reserve(std::size_t size)
+    {
+        if(m_updated.capacity() < size)
+        {
+            m_updated.reserve(std::max(size, m_updated.capacity() * 2));
+        }
+    }
+
+    void clear() noexcept
+    {
+        m_updated.clear();
+        m_overflow = false;
+    }
+
+    bool overflowed() const noexcept
+    {
+        return m_overflow;
+    }
+
+    std::span<const std::uint32_t> updated() const noexcept
+    {
+        return m_updated;
+    }
+
+private:
+    std::vector<std::uint32_t> m_updated{};
+    bool m_overflow{};
+};
+
 class CAPTAL_API node
 {
 public:
@@ -51,57 +112,78 @@ public:
     }
 
     ~node() = default;
-    node(const node&) = default;
-    node& operator=(const node&) = default;
+
+    //Copies only take the transformation, the tracking stays bound to the entity that owns the node
+    node(const node& other) noexcept
+    :m_position{other.m_position}
+    ,m_origin{other.m_origin}
+    ,m_scale{other.m_scale}
+    ,m_rotation{other.m_rotation}
+    {
+
+    }
+
+    node& operator=(const node& other) noexcept
+    {
+        m_position = other.m_position;
+        m_origin = other.m_origin;
+        m_scale = other.m_scale;
+        m_rotation = other.m_rotation;
+        mark();
+
+        return *this;
+    }
+
+    //Moves are relocations within the registry's storage, the tracking goes with the node
     node(node&&) noexcept = default;
     node& operator=(node&&) noexcept = default;
 
     void move_to(const vec3f& position) noexcept
     {
         m_position = position;
-        m_updated = true;
+        mark();
     }
 
     void move(const vec3f& relative) noexcept
     {
         m_position += relative;
-        m_updated = true;
+        mark();
     }
 
     void set_origin(const vec3f& origin) noexcept
     {
         m_origin = origin;
-        m_updated = true;
+        mark();
     }
 
     void move_origin(const vec3f& relative) noexcept
     {
         m_origin += relative;
-        m_updated = true;
+        mark();
     }
 
     void set_rotation(float angle) noexcept
     {
         m_rotation = std::fmod(angle, std::numbers::pi_v<float> * 2.0f);
-        m_updated = true;
+        mark();
     }
 
     void set_scale(const vec3f& scale) noexcept
     {
         m_scale = scale;
-        m_updated = true;
+        mark();
     }
 
     void scale(const vec3f& scale) noexcept
     {
         m_scale *= scale;
-        m_updated = true;
+        mark();
     }
 
     void rotate(float angle) noexcept
     {
         m_rotation = std::fmod(m_rotation + angle, std::numbers::pi_v<float> * 2.0f);
-        m_updated = true;
+        mark();
     }
 
     const vec3f& position() const noexcept
@@ -131,7 +213,7 @@ public:
 
     void update() noexcept
     {
-        m_updated = true;
+        mark();
     }
 
     bool is_updated() const noexcept
@@ -144,12 +226,54 @@ public:
         m_updated = false;
     }
 
+    //Every subsequent update of this node will be recorded in tracker with the given id (usually its entity)
+    //Tracking again with the same tracker and id does not record the node twice
+    void track(node_tracker* tracker, std::uint32_t id) noexcept
+    {
+        if(m_tracker != tracker || m_id != id)
+        {
+            m_tracker = tracker;
+            m_id = id;
+            m_recorded = false;
+        }
+
+        if(m_updated)
+        {
+            record();
+        }
+    }
+
+    //Clears the node and lets it be recorded again in its tracker, called once the tracker has been cleared
+    void clear_tracking() noexcept
+    {
+        m_updated = false;
+        m_recorded = false;
+    }
+
+private:
+    void mark() noexcept
+    {
+        m_updated = true;
+        record();
+    }
+
+    void record() noexcept
+    {
+        if(m_tracker && !m_recorded)
+        {
+            m_recorded = m_tracker->push(m_id);
+        }
+    }
+
 private:
     vec3f m_position{};
     vec3f m_origin{};
     vec3f m_scale{1.0f};
     float m_rotation{};
     bool m_updated{true};
+    bool m_recorded{};
+    node_tracker* m_tracker{};
+    std::uint32_t m_id{};
 };
 
 }
@@ -0,0 +1,34 @@
+#version 450
+
+layout(row_major, set = 0, binding = 0) uniform view_uniform
+{
+    mat4 view;
+    mat4 proj;
+} view;
+
+struct instance_data
+{
+    mat4 model;
+    vec4 color;
+    vec4 texture_rect;
+};
+
+layout(row_major, std430, set = 1, binding = 0) readonly buffer instance_buffer
+{
+    instance_data instances[];
+} instances;
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 color;
+layout(location = 2) in vec2 texture_coord;
+
+layout(location = 0) out vec4 frag_color;
+layout(location = 1) out vec2 frag_texture_coord;
+
+void main()
+{
+    gl_Position = view.proj * view.view * instances.instances[gl_InstanceIndex].model * vec4(position, 1.0);
+
+    frag_color = color * instances.instances[gl_InstanceIndex].color;
+    frag_texture_coord = instances.instances[gl_InstanceIndex].texture_rect.xy + texture_coord * instances.instances[gl_InstanceIndex].texture_rect.zw;
+}
@@ -37,14 +37,20 @@ static constexpr auto graphics_layers    {tph::device_layer::none};
 static constexpr auto graphics_extensions{tph::device_extension::swapchain};
 #endif
 
+//Compiled from the GLSL sources of data/ when glslangValidator is available, the checked-in SPIR-V is used otherwise (see CMakeLists.txt)
 static constexpr auto default_vertex_shader_spv = std::to_array<std::uint32_t>(
 {
-    #include "data/default.vert.spv.str"
+    #include <data/default.vert.spv.str>
+});
+
+static constexpr auto default_instanced_vertex_shader_spv = std::to_array<std::uint32_t>(
+{
+    #include <data/instanced.vert.spv.str>
 });
 
 static constexpr auto default_fragment_shader_spv = std::to_array<std::uint32_t>(
 {
-    #include "data/default.frag.spv.str"
+    #include <data/default.frag.spv.str>
 });
 
 static constexpr std::array<std::uint8_t, 4> default_texture_data{255, 255, 255, 255};
@@ -67,7 +73,8 @@ engine::engine(const std::string& application_name, cpt::version version)
 ,m_audio_stream{m_application.audio_application(), m_audio_device, make_stream_info(*m_listener, m_audio_world, m_audio_device), swl::listener_bridge{*m_listener}}
 ,m_graphics_device{m_application.graphics_application().default_physical_device()}
 ,m_device{m_application.graphics_application(), m_graphics_device, graphics_layers, graphics_extensions}
-,m_uniform_pool{tph::buffer_usage::uniform | tph::buffer_usage::vertex | tph::buffer_usage::index}
+,m_pipeline_cache{m_device, m_graphics_device}
+,m_uniform_pool{tph::buffer_usage::uniform | tph::buffer_usage::storage | tph::buffer_usage::vertex | tph::buffer_usage::index}
 ,m_transfer_scheduler{m_device}
 {
     init();
@@ -145,14 +152,15 @@ engine::engine(const std::string& application_name, cpt::version version, const
 engine::engine(cpt::application application, const system_parameters& system [[maybe_unused]], const audio_parameters& audio, const graphics_parameters& graphics)
 :m_application{std::move(application)}
 ,m_audio_device{default_audio_device(m_application.audio_application(), audio)}
-,m_audio_world{audio.frequency}
+,m_audio_world{audio.frequency, audio.worker_count}
 ,m_audio_pulser{m_audio_world}
 ,m_listener{m_audio_pulser.bind(swl::listener{audio.channel_count})}
 ,m_audio_stream{m_application.audio_application(), m_audio_device, make_stream_info(*m_listener, m_audio_world, m_audio_device), swl::listener_bridge{*m_listener}}
 ,m_graphics_device{default_graphics_device(m_application.graphics_application(), graphics)}
 ,m_device{m_application.graphics_application(), m_graphics_device, graphics_layers | graphics.layers, graphics_extensions | graphics.extensions, graphics.features, graphics.options}
-,m_uniform_pool{tph::buffer_usage::uniform | tph::buffer_usage::vertex | tph::buffer_usage::index}
-,m_transfer_scheduler{m_device}
+,m_pipeline_cache{m_device, m_graphics_device, graphics.pipeline_cache_path}
+,m_uniform_pool{tph::buffer_usage::uniform | tph::buffer_usage::storage | tph::buffer_usage::vertex | tph::buffer_usage::index}
+,m_transfer_scheduler{m_device, graphics.staging_size, graphics.upload_budget}
 {
     init();
 }
@@ -160,6 +168,8 @@ engine::engine(cpt::application application, const system_parameters& system [[m
 engine::~engine()
 {
     m_device.wait();
+    m_pipeline_cache.save();
+    flush_asynchronous_resources();
     m_audio_pulser.stop();
 
     m_update_signal.disconnect_all();
@@ -187,6 +197,15 @@ void engine::set_default_render_layout(render_layout_ptr new_default_render_layo
     #endif
 }
 
+void engine::set_default_instanced_render_layout(render_layout_ptr new_default_instanced_render_layout) noexcept
+{
+    m_default_instanced_layout = std::move(new_default_instanced_render_layout);
+
+    #ifdef CAPTAL_DEBUG
+    m_default_instanced_layout->set_name("cpt::engine's default instanced render layout");
+    #endif
+}
+
 void engine::set_default_vertex_shader(tph::shader new_default_vertex_shader) noexcept
 {
     m_default_vertex_shader = std::move(new_default_vertex_shader);
@@ -196,6 +215,15 @@ void engine::set_default_vertex_shader(tph::shader new_default_vertex_shader) no
     #endif
 }
 
+void engine::set_default_instanced_vertex_shader(tph::shader new_default_instanced_vertex_shader) noexcept
+{
+    m_default_instanced_vertex_shader = std::move(new_default_instanced_vertex_shader);
+
+    #ifdef CAPTAL_DEBUG
+    tph::set_object_name(m_device, m_default_instanced_vertex_shader, "cpt::engine's default instanced vertex shader");
+    #endif
+}
+
 void engine::set_default_fragment_shader(tph::shader new_default_fragment_shader) noexcept
 {
     m_default_fragment_shader = std::move(new_default_fragment_shader);
@@ -258,6 +286,7 @@ void engine::init()
     m_audio_stream.start();
 
     set_default_vertex_shader(tph::shader{m_device, tph::shader_stage::vertex, default_vertex_shader_spv});
+    set_default_instanced_vertex_shader(tph::shader{m_device, tph::shader_stage::vertex, default_instanced_vertex_shader_spv});
     set_default_fragment_shader(tph::shader{m_device, tph::shader_stage::fragment, default_fragment_shader_spv});
 
     render_layout_info view_info{};
@@ -273,6 +302,14 @@ void engine::init()
 
     set_default_render_layout(make_render_layout(view_info, renderable_info));
 
+    render_layout_info instanced_info{};
+    instanced_info.bindings.reserve(2);
+    instanced_info.bindings.emplace_back(tph::shader_stage::vertex, 0, tph::descriptor_type::storage_buffer);
+    instanced_info.bindings.emplace_back(tph::shader_stage::fragment, 1, tph::descriptor_type::image_sampler);
+    instanced_info.default_bindings.emplace(1, renderable_info.default_bindings.at(1));
+
+    set_default_instanced_render_layout(make_render_layout(view_info, instanced_info));
+
     if constexpr(debug_enabled)
     {
         m_uniform_pool.set_name("cpt::engine's uniform pool");
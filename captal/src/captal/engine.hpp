@@ -27,6 +27,7 @@
 
 #include <optional>
 #include <memory>
+#include <filesystem>
 
 #include <swell/stream.hpp>
 #include <swell/audio_pulser.hpp>
@@ -41,6 +42,7 @@
 #include "memory_transfer.hpp"
 #include "buffer_pool.hpp"
 #include "render_technique.hpp"
+#include "pipeline_cache.hpp"
 #include "translation.hpp"
 #include "font.hpp"
 
@@ -58,6 +60,7 @@ struct audio_parameters
     std::uint32_t frequency{};
     swl::seconds minimum_latency{0.010};
     swl::seconds resync_threshold{0.050};
+    std::size_t worker_count{};
     optional_ref<const swl::physical_device> physical_device{};
 };
 
@@ -68,6 +71,9 @@ struct graphics_parameters
     tph::device_extension extensions{};
     tph::physical_device_features features{};
     optional_ref<const tph::physical_device> physical_device{};
+    std::filesystem::path pipeline_cache_path{};
+    std::uint64_t staging_size{memory_transfer_scheduler::default_staging_size};
+    std::uint64_t upload_budget{}; //Bytes of scheduled uploads per frame, 0 means no limit
 };
 
 using update_signal = cpt::signal<float>;
@@ -94,7 +100,9 @@ public:
     void set_framerate_limit(std::uint32_t frame_per_second) noexcept;
     void set_translator(cpt::translator new_translator);
     void set_default_render_layout(render_layout_ptr new_default_render_layout) noexcept;
+    void set_default_instanced_render_layout(render_layout_ptr new_default_instanced_render_layout) noexcept;
     void set_default_vertex_shader(tph::shader new_default_vertex_shader) noexcept;
+    void set_default_instanced_vertex_shader(tph::shader new_default_instanced_vertex_shader) noexcept;
     void set_default_fragment_shader(tph::shader new_default_fragment_shader) noexcept;
 
     memory_transfer_info begin_transfer();
@@ -175,6 +183,16 @@ public:
         return m_device;
     }
 
+    cpt::pipeline_cache& pipeline_cache() noexcept
+    {
+        return m_pipeline_cache;
+    }
+
+    const cpt::pipeline_cache& pipeline_cache() const noexcept
+    {
+        return m_pipeline_cache;
+    }
+
     memory_transfer_scheduler& transfer_scheduler() noexcept
     {
         return m_transfer_scheduler;
@@ -210,6 +228,11 @@ public:
         return m_default_vertex_shader;
     }
 
+    tph::shader& default_instanced_vertex_shader() noexcept
+    {
+        return m_default_instanced_vertex_shader;
+    }
+
     tph::shader& default_fragment_shader() noexcept
     {
         return m_default_fragment_shader;
@@ -220,6 +243,11 @@ public:
         return m_default_layout;
     }
 
+    const render_layout_ptr& default_instanced_render_layout() noexcept
+    {
+        return m_default_instanced_layout;
+    }
+
     const cpt::translator& translator() const noexcept
     {
         return m_translator;
@@ -270,14 +298,17 @@ private:
 
     const tph::physical_device& m_graphics_device;
     tph::device m_device;
+    cpt::pipeline_cache m_pipeline_cache;
 
     buffer_pool m_uniform_pool;
     memory_transfer_scheduler m_transfer_scheduler;
 
     std::mutex m_queue_mutex{};
     tph::shader m_default_vertex_shader{};
+    tph::shader m_default_instanced_vertex_shader{};
     tph::shader m_default_fragment_shader{};
     render_layout_ptr m_default_layout{};
+    render_layout_ptr m_default_instanced_layout{};
 
     cpt::translator m_translator{};
     cpt::font_engine m_font_engine{};
@@ -0,0 +1,372 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "instanced_renderable.hpp"
+
+#include <cassert>
+
+#include <tephra/commands.hpp>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+static std::array<buffer_part, 3> compute_buffer_parts(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t instance_count)
+{
+    return std::array<buffer_part, 3>
+    {
+        buffer_part{buffer_part_type::vertex, vertex_count * sizeof(vertex)},
+        buffer_part{buffer_part_type::index, index_count * sizeof(std::uint32_t)},
+        buffer_part{buffer_part_type::storage, instance_count * sizeof(basic_instanced_renderable::instance_data)},
+    };
+}
+
+basic_instanced_renderable::basic_instanced_renderable(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t instance_count, std::uint32_t storage_index)
+:m_instances{instance_count}
+,m_vertex_count{vertex_count}
+,m_index_count{index_count}
+,m_instance_count{instance_count}
+,m_storage_index{storage_index}
+{
+    assert(instance_count > 0 && "cpt::basic_instanced_renderable created with no instance.");
+
+    auto buffer{make_uniform_buffer(compute_buffer_parts(vertex_count, index_count, instance_count))};
+    m_buffer = buffer.get();
+
+    m_bindings.set(m_storage_index, uniform_buffer_part{std::move(buffer), 2});
+}
+
+void basic_instanced_renderable::set_vertices(std::span<const vertex> vertices) noexcept
+{
+    assert(std::size(vertices) == m_vertex_count && "cpt::basic_instanced_renderable::set_vertices called with a wrong number of vertices.");
+
+    std::memcpy(&m_buffer->get<vertex>(0), std::data(vertices), std::size(vertices) * sizeof(vertex));
+
+    m_upload_vertices = true;
+}
+
+void basic_instanced_renderable::set_indices(std::span<const std::uint32_t> indices) noexcept
+{
+    assert(std::size(indices) == m_index_count && "cpt::basic_instanced_renderable::set_indices called with a wrong number of indices.");
+
+    std::memcpy(&m_buffer->get<std::uint32_t>(1), std::data(indices), std::size(indices) * sizeof(std::uint32_t));
+
+    m_upload_indices = true;
+}
+
+void basic_instanced_renderable::bind(frame_render_info info, cpt::view& view)
+{
+    const auto& layout{view.render_technique()->layout()};
+
+    const auto write_set = [this, &layout](descriptor_set_data& data)
+    {
+        #ifdef CAPTAL_DEBUG
+        if(!std::empty(m_name))
+        {
+            const std::string layout_name{std::empty(layout->m_name) ? std::string{"unknown"} : layout->m_name};
+
+            tph::set_object_name(engine::instance().device(), data.set->set(), m_name + " descriptor set for render layout " + layout_name);
+        }
+        #endif
+
+        const auto to_bind{layout->bindings(render_layout::renderable_index)};
+
+        std::vector<tph::descriptor_write> writes{};
+        writes.reserve(std::size(to_bind));
+
+        for(auto&& binding : to_bind)
+        {
+            const auto local{m_bindings.try_get(binding.binding)};
+
+            if(local)
+            {
+                writes.emplace_back(make_descriptor_write(data.set->set(), binding.binding, *local));
+                data.to_keep.emplace_back(get_binding_resource(*local));
+            }
+            else
+            {
+                const auto fallback{layout->default_binding(render_layout::renderable_index, binding.binding)};
+                assert(fallback && "cpt::basic_instanced_renderable::bind can not find any suitable binding, neither the renderable nor the render layout have a binding for specified index.");
+
+                writes.emplace_back(make_descriptor_write(data.set->set(), binding.binding, *fallback));
+                data.to_keep.emplace_back(get_binding_resource(*fallback));
+            }
+        }
+
+        tph::write_descriptors(engine::instance().device(), writes);
+    };
+
+    auto it{m_sets.find(layout)};
+
+    if(it == std::end(m_sets))
+    {
+        it = m_sets.emplace(layout, descriptor_set_data{layout->make_set(render_layout::renderable_index), std::vector<asynchronous_resource_ptr>{}, m_descriptors_epoch}).first;
+
+        write_set(it->second);
+    }
+    else if(it->second.epoch < m_descriptors_epoch)
+    {
+        it->second.set.reset();
+        it->second.set = layout->make_set(render_layout::renderable_index);
+        it->second.to_keep.clear();
+        it->second.epoch = m_descriptors_epoch;
+
+        write_set(it->second);
+    }
+
+    auto buffer{m_buffer->get_buffer()};
+
+    tph::cmd::bind_index_buffer  (info.buffer, buffer.buffer, buffer.offset + m_buffer->part_offset(1), tph::index_type::uint32);
+    tph::cmd::bind_vertex_buffer (info.buffer, buffer.buffer, buffer.offset + m_buffer->part_offset(0));
+    tph::cmd::bind_descriptor_set(info.buffer, 1, it->second.set->set(), layout->pipeline_layout());
+
+    m_push_constants.push(info.buffer, layout, render_layout::renderable_index);
+
+    info.keeper.keep(std::begin(it->second.to_keep), std::end(it->second.to_keep));
+    info.keeper.keep(it->second.set);
+}
+
+void basic_instanced_renderable::draw(frame_render_info info)
+{
+    if(m_instance_count > 0)
+    {
+        tph::cmd::draw_indexed(info.buffer, m_index_count, m_instance_count, 0, 0, 0);
+    }
+}
+
+void basic_instanced_renderable::draw(frame_render_info info, cpt::view& view)
+{
+    bind(info, view);
+    draw(info);
+}
+
+void basic_instanced_renderable::upload(memory_transfer_info info)
+{
+    bool keep{};
+
+    //A new global transform changes every instance
+    if(std::exchange(m_upload_model, false))
+    {
+        m_dirty_ranges.clear();
+        m_dirty_ranges.emplace_back(0, static_cast<std::uint32_t>(std::size(m_instances)));
+    }
+
+    if(!std::empty(m_dirty_ranges))
+    {
+        const auto model{cpt::model(m_position, m_rotation, vec3f{0.0f, 0.0f, 1.0f}, m_scale, m_origin)};
+        const auto gpu_instances{&m_buffer->get<instance_data>(2)};
+
+        for(auto&& range : m_dirty_ranges)
+        {
+            for(std::uint32_t i{range.begin}; i < range.end; ++i)
+            {
+                gpu_instances[i].model = model * m_instances[i].model;
+                gpu_instances[i].color = m_instances[i].color;
+                gpu_instances[i].texture_rect = m_instances[i].texture_rect;
+            }
+
+            m_buffer->upload(2, range.begin * sizeof(instance_data), (range.end - range.begin) * sizeof(instance_data));
+        }
+
+        m_dirty_ranges.clear();
+
+        keep = true;
+    }
+
+    if(std::exchange(m_upload_vertices, false))
+    {
+        m_buffer->upload(0);
+
+        keep = true;
+    }
+
+    if(std::exchange(m_upload_indices, false))
+    {
+        m_buffer->upload(1);
+
+        keep = true;
+    }
+
+    if(keep)
+    {
+        info.keeper.keep(std::get<uniform_buffer_part>(m_bindings.get(m_storage_index)).buffer);
+    }
+}
+
+void basic_instanced_renderable::set_binding(std::uint32_t index, cpt::binding binding)
+{
+    assert(index != m_storage_index && "cpt::basic_instanced_renderable::set_binding must never be called with index == storage_index.");
+
+    m_bindings.set(index, std::move(binding));
+    ++m_descriptors_epoch;
+}
+
+void basic_instanced_renderable::set_instance(std::uint32_t index, const vec3f& position, float rotation, const vec3f& scale, const vec3f& origin) noexcept
+{
+    set_instance_model(index, cpt::model(position, rotation, vec3f{0.0f, 0.0f, 1.0f}, scale, origin));
+}
+
+void basic_instanced_renderable::set_instance_model(std::uint32_t index, const mat4f& model) noexcept
+{
+    assert(index < std::size(m_instances) && "cpt::basic_instanced_renderable::set_instance_model index out of range.");
+
+    m_instances[index].model = model;
+    mark_dirty(index);
+}
+
+void basic_instanced_renderable::set_instance_color(std::uint32_t index, const color& color) noexcept
+{
+    assert(index < std::size(m_instances) && "cpt::basic_instanced_renderable::set_instance_color index out of range.");
+
+    m_instances[index].color = static_cast<vec4f>(color);
+    mark_dirty(index);
+}
+
+void basic_instanced_renderable::set_instance_relative_texture_rect(std::uint32_t index, float x, float y, float width, float height) noexcept
+{
+    assert(index < std::size(m_instances) && "cpt::basic_instanced_renderable::set_instance_relative_texture_rect index out of range.");
+
+    m_instances[index].texture_rect = vec4f{x, y, width, height};
+    mark_dirty(index);
+}
+
+void basic_instanced_renderable::set_instance_count(std::uint32_t count) noexcept
+{
+    assert(count <= std::size(m_instances) && "cpt::basic_instanced_renderable::set_instance_count can not draw more instances than its capacity.");
+
+    m_instance_count = count;
+}
+
+void basic_instanced_renderable::mark_dirty(std::uint32_t index) noexcept
+{
+    //Consecutive updates are merged, buffer_heap coalesces the remaining ranges on upload
+    if(!std::empty(m_dirty_ranges))
+    {
+        auto& last{m_dirty_ranges.back()};
+
+        if(index >= last.begin && index <= last.end)
+        {
+            last.end = std::max(last.end, index + 1);
+
+            return;
+        }
+    }
+
+    m_dirty_ranges.emplace_back(index, index + 1);
+}
+
+#ifdef CAPTAL_DEBUG
+void basic_instanced_renderable::set_name(std::string_view name)
+{
+    m_name = name;
+
+    for(auto&& [layout_weak, set] : m_sets)
+    {
+        if(const auto layout{layout_weak.lock()}; layout)
+        {
+            const std::string layout_name{std::empty(layout->m_name) ? std::string{"unknown"} : layout->m_name};
+
+            tph::set_object_name(engine::instance().device(), set.set->set(), m_name + " descriptor set for render layout " + layout_name);
+        }
+    }
+}
+#endif
+
+instanced_sprite::instanced_sprite(std::uint32_t width, std::uint32_t height, std::uint32_t instance_count, const color& color)
+:basic_instanced_renderable{4, 6, instance_count, 0}
+,m_width{width}
+,m_height{height}
+{
+    init(color);
+}
+
+instanced_sprite::instanced_sprite(texture_ptr texture, std::uint32_t instance_count, const color& color)
+:basic_instanced_renderable{4, 6, instance_count, 0}
+,m_width{texture->width()}
+,m_height{texture->height()}
+{
+    init(color);
+    set_texture(std::move(texture));
+}
+
+instanced_sprite::instanced_sprite(std::uint32_t width, std::uint32_t height, texture_ptr texture, std::uint32_t instance_count, const color& color)
+:basic_instanced_renderable{4, 6, instance_count, 0}
+,m_width{width}
+,m_height{height}
+{
+    init(color);
+    set_texture(std::move(texture));
+}
+
+void instanced_sprite::set_texture(texture_ptr texture)
+{
+    set_binding(1, std::move(texture));
+}
+
+void instanced_sprite::set_color(const color& color) noexcept
+{
+    const auto vertices{basic_instanced_renderable::vertices()};
+
+    vertices[0].color = static_cast<vec4f>(color);
+    vertices[1].color = static_cast<vec4f>(color);
+    vertices[2].color = static_cast<vec4f>(color);
+    vertices[3].color = static_cast<vec4f>(color);
+}
+
+void instanced_sprite::set_instance_texture_rect(std::uint32_t index, std::int32_t x, std::int32_t y, std::uint32_t width, std::uint32_t height) noexcept
+{
+    const auto texture_width {static_cast<float>(texture()->width())};
+    const auto texture_height{static_cast<float>(texture()->height())};
+
+    set_instance_relative_texture_rect(index,
+                                       static_cast<float>(x) / texture_width,
+                                       static_cast<float>(y) / texture_height,
+                                       static_cast<float>(width) / texture_width,
+                                       static_cast<float>(height) / texture_height);
+}
+
+void instanced_sprite::set_instance_spritesheet_coords(std::uint32_t index, std::uint32_t x, std::uint32_t y) noexcept
+{
+    set_instance_texture_rect(index, x * m_width, y * m_height, m_width, m_height);
+}
+
+void instanced_sprite::init(const color& color)
+{
+    set_indices(std::array<std::uint32_t, 6>{0, 1, 2, 2, 3, 0});
+
+    const auto vertices{basic_instanced_renderable::vertices()};
+
+    vertices[0].position = vec3f{0.0f, 0.0f, 0.0f};
+    vertices[1].position = vec3f{static_cast<float>(m_width), 0.0f, 0.0f};
+    vertices[2].position = vec3f{static_cast<float>(m_width), static_cast<float>(m_height), 0.0f};
+    vertices[3].position = vec3f{0.0f, static_cast<float>(m_height), 0.0f};
+
+    vertices[0].texture_coord = vec2f{0.0f, 0.0f};
+    vertices[1].texture_coord = vec2f{1.0f, 0.0f};
+    vertices[2].texture_coord = vec2f{1.0f, 1.0f};
+    vertices[3].texture_coord = vec2f{0.0f, 1.0f};
+
+    set_color(color);
+}
+
+}
@@ -0,0 +1,367 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_INSTANCED_RENDERABLE_HPP_INCLUDED
+#define CAPTAL_INSTANCED_RENDERABLE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <map>
+#include <span>
+#include <numbers>
+#include <cassert>
+
+#include "asynchronous_resource.hpp"
+#include "uniform_buffer.hpp"
+#include "binding.hpp"
+#include "color.hpp"
+#include "view.hpp"
+#include "vertex.hpp"
+#include "texture.hpp"
+
+namespace cpt
+{
+
+//Shares one vertex and index buffer between all instances, per-instance data lives in a storage buffer part.
+//It must be drawn with a view whose render technique uses render_technique_options::instanced (or an equivalent layout and shader).
+class CAPTAL_API basic_instanced_renderable
+{
+public:
+    struct instance_data
+    {
+        mat4f model{identity};
+        vec4f color{1.0f};
+        vec4f texture_rect{0.0f, 0.0f, 1.0f, 1.0f}; //xy: offset, zw: size, in relative texture coordinates
+    };
+
+    static_assert(sizeof(instance_data) == 96, "cpt::basic_instanced_renderable::instance_data must match the std430 layout of the instanced vertex shader.");
+
+protected:
+    basic_instanced_renderable() = default;
+    explicit basic_instanced_renderable(std::uint32_t vertex_count, std::uint32_t index_count, std::uint32_t instance_count, std::uint32_t storage_index);
+
+    ~basic_instanced_renderable() = default;
+    basic_instanced_renderable(const basic_instanced_renderable&) = delete;
+    basic_instanced_renderable& operator=(const basic_instanced_renderable&) = delete;
+    basic_instanced_renderable(basic_instanced_renderable&&) noexcept = default;
+    basic_instanced_renderable& operator=(basic_instanced_renderable&&) noexcept = default;
+
+    void set_vertices(std::span<const vertex> vertices) noexcept;
+    void set_indices(std::span<const std::uint32_t> indices) noexcept;
+
+public:
+    void bind(frame_render_info info, cpt::view& view);
+    void draw(frame_render_info info);
+    void draw(frame_render_info info, cpt::view& view);
+    void upload(memory_transfer_info info);
+
+    void set_binding(std::uint32_t index, cpt::binding binding);
+
+    template<typename T>
+    void set_push_constant(tph::shader_stage stages, std::uint32_t offset, T&& value)
+    {
+        return m_push_constants.set(stages, offset, std::forward<T>(value));
+    }
+
+    void set_instance(std::uint32_t index, const vec3f& position, float rotation = 0.0f, const vec3f& scale = vec3f{1.0f}, const vec3f& origin = vec3f{}) noexcept;
+    void set_instance_model(std::uint32_t index, const mat4f& model) noexcept;
+    void set_instance_color(std::uint32_t index, const color& color) noexcept;
+    void set_instance_relative_texture_rect(std::uint32_t index, float x, float y, float width, float height) noexcept;
+    void set_instance_count(std::uint32_t count) noexcept;
+
+    //The transform is applied on top of every instance's model
+    void move(const vec3f& relative) noexcept
+    {
+        m_position += relative;
+        m_upload_model = true;
+    }
+
+    void move_to(const vec3f& position) noexcept
+    {
+        m_position = position;
+        m_upload_model = true;
+    }
+
+    void set_origin(const vec3f& origin) noexcept
+    {
+        m_origin = origin;
+        m_upload_model = true;
+    }
+
+    void move_origin(const vec3f& relative) noexcept
+    {
+        m_origin += relative;
+        m_upload_model = true;
+    }
+
+    void rotate(float angle) noexcept
+    {
+        m_rotation = std::fmod(m_rotation + angle, std::numbers::pi_v<float> * 2.0f);
+        m_upload_model = true;
+    }
+
+    void set_rotation(float angle) noexcept
+    {
+        m_rotation = std::fmod(angle, std::numbers::pi_v<float> * 2.0f);
+        m_upload_model = true;
+    }
+
+    void scale(const vec3f& scale) noexcept
+    {
+        m_scale *= scale;
+        m_upload_model = true;
+    }
+
+    void set_scale(const vec3f& scale) noexcept
+    {
+        m_scale = scale;
+        m_upload_model = true;
+    }
+
+    void hide() noexcept
+    {
+        m_hidden = true;
+    }
+
+    void show() noexcept
+    {
+        m_hidden = false;
+    }
+
+    const cpt::binding& get_binding(std::uint32_t index) const
+    {
+        return m_bindings.get(index);
+    }
+
+    optional_ref<const cpt::binding> try_get_binding(std::uint32_t index) const
+    {
+        return m_bindings.try_get(index);
+    }
+
+    bool has_binding(std::uint32_t index) const
+    {
+        return m_bindings.has(index);
+    }
+
+    template<typename T>
+    const T& get_push_constant(tph::shader_stage stages, std::uint32_t offset) const
+    {
+        return m_push_constants.get<T>(stages, offset);
+    }
+
+    template<typename T>
+    optional_ref<const T> try_get_push_constant(tph::shader_stage stages, std::uint32_t offset) const
+    {
+        return m_push_constants.try_get<T>(stages, offset);
+    }
+
+    bool has_push_constant(tph::shader_stage stages, std::uint32_t offset) const
+    {
+        return m_push_constants.has(stages, offset);
+    }
+
+    const vec3f& position() const noexcept
+    {
+        return m_position;
+    }
+
+    const vec3f& origin() const noexcept
+    {
+        return m_origin;
+    }
+
+    const vec3f& scale() const noexcept
+    {
+        return m_scale;
+    }
+
+    float rotation() const noexcept
+    {
+        return m_rotation;
+    }
+
+    bool hidden() const noexcept
+    {
+        return m_hidden;
+    }
+
+    const instance_data& instance(std::uint32_t index) const noexcept
+    {
+        assert(index < std::size(m_instances) && "cpt::basic_instanced_renderable::instance index out of range.");
+
+        return m_instances[index];
+    }
+
+    std::uint32_t instance_count() const noexcept
+    {
+        return m_instance_count;
+    }
+
+    std::uint32_t instance_capacity() const noexcept
+    {
+        return static_cast<std::uint32_t>(std::size(m_instances));
+    }
+
+    std::span<vertex> vertices() noexcept
+    {
+        m_upload_vertices = true;
+
+        return std::span{&m_buffer->get<vertex>(0), static_cast<std::size_t>(m_vertex_count)};
+    }
+
+    std::span<const vertex> vertices() const noexcept
+    {
+        return cvertices();
+    }
+
+    std::span<const vertex> cvertices() const noexcept
+    {
+        return std::span{&m_buffer->get<const vertex>(0), static_cast<std::size_t>(m_vertex_count)};
+    }
+
+    std::span<std::uint32_t> indices() noexcept
+    {
+        m_upload_indices = true;
+
+        return std::span{&m_buffer->get<std::uint32_t>(1), static_cast<std::size_t>(m_index_count)};
+    }
+
+    std::span<const std::uint32_t> indices() const noexcept
+    {
+        return cindices();
+    }
+
+    std::span<const std::uint32_t> cindices() const noexcept
+    {
+        return std::span{&m_buffer->get<const std::uint32_t>(1), static_cast<std::size_t>(m_index_count)};
+    }
+
+#ifdef CAPTAL_DEBUG
+    void set_name(std::string_view name);
+#else
+    void set_name(std::string_view name [[maybe_unused]]) const noexcept
+    {
+
+    }
+#endif
+
+private:
+    struct descriptor_set_data
+    {
+        descriptor_set_ptr set{};
+        std::vector<asynchronous_resource_ptr> to_keep{};
+        std::uint32_t epoch{};
+    };
+
+    struct dirty_range
+    {
+        std::uint32_t begin{};
+        std::uint32_t end{};
+    };
+
+private:
+    using descriptor_set_map = std::map<render_layout_weak_ptr, descriptor_set_data, std::owner_less<render_layout_weak_ptr>>;
+
+private:
+    void mark_dirty(std::uint32_t index) noexcept;
+
+private:
+    binding_buffer m_bindings{};
+    push_constants_buffer m_push_constants{};
+    descriptor_set_map m_sets{};
+    uniform_buffer* m_buffer{};
+    std::vector<instance_data> m_instances{};
+    std::vector<dirty_range> m_dirty_ranges{};
+
+    std::uint32_t m_vertex_count{};
+    std::uint32_t m_index_count{};
+    std::uint32_t m_instance_count{};
+    std::uint32_t m_storage_index{};
+    std::uint32_t m_descriptors_epoch{};
+
+    vec3f m_position{};
+    vec3f m_origin{};
+    vec3f m_scale{1.0f};
+    float m_rotation{};
+    bool  m_hidden{};
+
+    bool m_upload_model{true};
+    bool m_upload_indices{true};
+    bool m_upload_vertices{true};
+
+#ifdef CAPTAL_DEBUG
+    std::string m_name{};
+#endif
+};
+
+class CAPTAL_API instanced_sprite final : public basic_instanced_renderable
+{
+public:
+    instanced_sprite() = default;
+    explicit instanced_sprite(std::uint32_t width, std::uint32_t height, std::uint32_t instance_count, const color& color = colors::white);
+    explicit instanced_sprite(texture_ptr texture, std::uint32_t instance_count, const color& color = colors::white);
+    explicit instanced_sprite(std::uint32_t width, std::uint32_t height, texture_ptr texture, std::uint32_t instance_count, const color& color = colors::white);
+
+    ~instanced_sprite() = default;
+    instanced_sprite(const instanced_sprite&) = delete;
+    instanced_sprite& operator=(const instanced_sprite&) = delete;
+    instanced_sprite(instanced_sprite&&) noexcept = default;
+    instanced_sprite& operator=(instanced_sprite&&) noexcept = default;
+
+    void set_texture(texture_ptr texture);
+    void set_color(const color& color) noexcept;
+
+    void set_instance_texture_rect(std::uint32_t index, std::int32_t x, std::int32_t y, std::uint32_t width, std::uint32_t height) noexcept;
+    void set_instance_spritesheet_coords(std::uint32_t index, std::uint32_t x, std::uint32_t y) noexcept;
+
+    texture_ptr texture() const
+    {
+        auto output{try_get_binding(1)};
+        if(output)
+        {
+            return std::get<texture_ptr>(*output);
+        }
+
+        return nullptr;
+    }
+
+    std::uint32_t width() const noexcept
+    {
+        return m_width;
+    }
+
+    std::uint32_t height() const noexcept
+    {
+        return m_height;
+    }
+
+private:
+    void init(const color& color);
+
+private:
+    std::uint32_t m_width{};
+    std::uint32_t m_height{};
+};
+
+}
+
+#endif
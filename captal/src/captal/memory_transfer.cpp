@@ -25,6 +25,7 @@
 #include "engine.hpp"
 
 #include <sstream>
+#include <algorithm>
 
 namespace cpt
 {
@@ -37,9 +38,12 @@ static std::string thread_name(std::thread::id thread)
     return ss.str();
 }
 
-memory_transfer_scheduler::memory_transfer_scheduler(tph::device& device) noexcept
+memory_transfer_scheduler::memory_transfer_scheduler(tph::device& device, std::uint64_t staging_size, std::uint64_t upload_budget) noexcept
 :m_device{&device}
 ,m_pool{device, tph::command_pool_options::reset | tph::command_pool_options::transient}
+,m_staging_size{staging_size}
+,m_upload_budget{upload_budget}
+,m_last_submit{std::chrono::steady_clock::now()}
 {
     if(debug_enabled)
     {
@@ -90,8 +94,12 @@ memory_transfer_info memory_transfer_scheduler::begin_transfer(std::thread::id t
 
 void memory_transfer_scheduler::submit_transfers()
 {
+    run_scheduled_uploads();
+
     std::unique_lock lock{m_mutex};
 
+    update_statistics();
+
     if(!m_begin)
     {
         return;
@@ -115,6 +123,104 @@ void memory_transfer_scheduler::submit_transfers()
     std::unique_lock queue_lock{engine::instance().submit_mutex()};
     tph::submit(*m_device, info, buffer.fence);
     queue_lock.unlock();
+
+    //Everything allocated in the staging ring until now is read by this submission
+    m_staging_batches.emplace_back(staging_batch{index, m_staging_head});
+}
+
+staging_chunk memory_transfer_scheduler::allocate_staging(memory_transfer_info info, std::uint64_t size, std::uint64_t alignment)
+{
+    std::unique_lock lock{m_mutex};
+
+    m_frame_bytes += size;
+
+    if(m_staging_size > 0 && size <= m_staging_size)
+    {
+        if(!m_staging_map)
+        {
+            m_staging = tph::buffer{*m_device, m_staging_size, tph::buffer_usage::transfer_src | tph::buffer_usage::staging};
+            m_staging_map = m_staging.map();
+
+            if constexpr(debug_enabled)
+            {
+                tph::set_object_name(*m_device, m_staging, "cpt::engine's staging ring");
+            }
+        }
+
+        auto offset{try_allocate_staging(size, alignment)};
+
+        if(!offset)
+        {
+            release_staging();
+            offset = try_allocate_staging(size, alignment);
+        }
+
+        if(offset)
+        {
+            return staging_chunk{&m_staging, *offset, size, m_staging_map + *offset};
+        }
+    }
+
+    ++m_statistics.dedicated_stagings;
+
+    lock.unlock();
+
+    //Too big for the ring, or the ring is full of transfers not executed yet
+    auto buffer{std::make_shared<tph::buffer>(*m_device, size, tph::buffer_usage::transfer_src | tph::buffer_usage::staging)};
+
+    if constexpr(debug_enabled)
+    {
+        tph::set_object_name(*m_device, *buffer, "cpt::engine's dedicated staging buffer");
+    }
+
+    const staging_chunk output{buffer.get(), 0, size, buffer->map()};
+
+    info.signal.connect([buffer = std::move(buffer)](){});
+
+    return output;
+}
+
+void memory_transfer_scheduler::schedule_upload(std::uint64_t size, upload_function function)
+{
+    std::unique_lock lock{m_scheduled_mutex};
+
+    m_scheduled.emplace_back(scheduled_upload{size, std::move(function)});
+}
+
+void memory_transfer_scheduler::set_upload_budget(std::uint64_t budget) noexcept
+{
+    std::unique_lock lock{m_scheduled_mutex};
+
+    m_upload_budget = budget;
+}
+
+std::uint64_t memory_transfer_scheduler::upload_budget() const noexcept
+{
+    std::unique_lock lock{m_scheduled_mutex};
+
+    return m_upload_budget;
+}
+
+memory_transfer_statistics memory_transfer_scheduler::statistics() const
+{
+    std::unique_lock lock{m_mutex};
+
+    auto output{m_statistics};
+    output.staging_size = m_staging_size;
+    output.staging_used = m_staging_head - m_staging_tail;
+
+    lock.unlock();
+
+    std::unique_lock scheduled_lock{m_scheduled_mutex};
+
+    for(auto&& upload : m_scheduled)
+    {
+        output.backlog_bytes += upload.size;
+    }
+
+    output.backlog_count = std::size(m_scheduled);
+
+    return output;
 }
 
 memory_transfer_scheduler::transfer_buffer& memory_transfer_scheduler::next_buffer()
@@ -123,6 +229,7 @@ memory_transfer_scheduler::transfer_buffer& memory_transfer_scheduler::next_buff
     {
         if(buffer.fence.try_wait())
         {
+            release_staging(buffer_index(buffer));
             reset_buffer(buffer);
 
             return buffer;
@@ -301,4 +408,102 @@ memory_transfer_scheduler::thread_transfer_buffer& memory_transfer_scheduler::ad
     return pool.buffers.emplace_back(std::move(data));
 }
 
+std::optional<std::uint64_t> memory_transfer_scheduler::try_allocate_staging(std::uint64_t size, std::uint64_t alignment)
+{
+    const auto position{m_staging_head % m_staging_size};
+    const auto aligned {align_up(position, alignment)};
+
+    auto begin{m_staging_head - position + aligned};
+
+    //Not enough space until the end of the ring, restart at its beginning
+    if(aligned + size > m_staging_size)
+    {
+        begin = m_staging_head - position + m_staging_size;
+    }
+
+    //Would overwrite memory of transfers not executed yet
+    if(begin + size - m_staging_tail > m_staging_size)
+    {
+        return std::nullopt;
+    }
+
+    m_staging_head = begin + size;
+
+    return begin % m_staging_size;
+}
+
+void memory_transfer_scheduler::release_staging(std::size_t buffer) noexcept
+{
+    //Fences are signaled in submission order, so all batches submitted before this one have been executed too
+    const auto it{std::find_if(std::begin(m_staging_batches), std::end(m_staging_batches), [buffer](const staging_batch& batch)
+    {
+        return batch.buffer == buffer;
+    })};
+
+    if(it != std::end(m_staging_batches))
+    {
+        m_staging_tail = it->end;
+        m_staging_batches.erase(std::begin(m_staging_batches), std::next(it));
+    }
+}
+
+void memory_transfer_scheduler::release_staging()
+{
+    while(!std::empty(m_staging_batches) && m_buffers[m_staging_batches.front().buffer].fence.try_wait())
+    {
+        m_staging_tail = m_staging_batches.front().end;
+        m_staging_batches.pop_front();
+    }
+}
+
+void memory_transfer_scheduler::run_scheduled_uploads()
+{
+    std::unique_lock lock{m_scheduled_mutex};
+
+    bool first{true};
+
+    while(!std::empty(m_scheduled))
+    {
+        //The first one is always executed so big uploads can not stay in the backlog forever
+        if(m_upload_budget != 0 && !first)
+        {
+            std::unique_lock transfer_lock{m_mutex};
+
+            if(m_frame_bytes + m_scheduled.front().size > m_upload_budget)
+            {
+                break;
+            }
+        }
+
+        auto function{std::move(m_scheduled.front().function)};
+        m_scheduled.pop_front();
+
+        //function may schedule other uploads
+        lock.unlock();
+        function(begin_transfer());
+        lock.lock();
+
+        first = false;
+    }
+}
+
+void memory_transfer_scheduler::update_statistics() noexcept
+{
+    const auto now{std::chrono::steady_clock::now()};
+    const std::chrono::duration<double> elapsed{now - m_last_submit};
+
+    m_statistics.total_bytes += m_frame_bytes;
+    m_statistics.frame_bytes = m_frame_bytes;
+
+    if(elapsed.count() > 0.0)
+    {
+        const auto throughput{static_cast<double>(m_frame_bytes) / elapsed.count()};
+
+        m_statistics.throughput = m_statistics.throughput * 0.9 + throughput * 0.1;
+    }
+
+    m_frame_bytes = 0;
+    m_last_submit = now;
+}
+
 }
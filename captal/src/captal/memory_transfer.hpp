@@ -27,8 +27,13 @@
 
 #include <unordered_map>
 #include <future>
+#include <deque>
+#include <optional>
+#include <chrono>
+#include <functional>
 
 #include <tephra/device.hpp>
+#include <tephra/buffer.hpp>
 #include <tephra/commands.hpp>
 #include <tephra/synchronization.hpp>
 
@@ -47,12 +52,40 @@ struct memory_transfer_info
     asynchronous_resource_keeper& keeper;
 };
 
+//Host visible memory to copy from, valid until the transfer it has been allocated for has been executed
+struct staging_chunk
+{
+    tph::buffer* buffer{};
+    std::uint64_t offset{};
+    std::uint64_t size{};
+    std::uint8_t* map{};
+};
+
+struct memory_transfer_statistics
+{
+    std::uint64_t total_bytes{};      //Bytes copied through staging memory since the scheduler creation
+    std::uint64_t frame_bytes{};      //Bytes copied through staging memory by the last submission
+    double throughput{};              //Bytes per second, smoothed over the last submissions
+    std::uint64_t backlog_bytes{};    //Bytes of the scheduled uploads still waiting for some budget
+    std::size_t backlog_count{};      //Number of scheduled uploads still waiting for some budget
+    std::uint64_t staging_size{};     //Size of the staging ring
+    std::uint64_t staging_used{};     //Bytes of the staging ring not released yet
+    std::size_t dedicated_stagings{}; //Number of allocations that did not fit in the staging ring
+};
+
+using upload_function = std::function<void(memory_transfer_info)>;
+
 class CAPTAL_API memory_transfer_scheduler
 {
     static constexpr std::size_t no_parent{std::numeric_limits<std::size_t>::max()};
 
 public:
-    explicit memory_transfer_scheduler(tph::device& device) noexcept;
+    static constexpr std::uint64_t default_staging_size{64 * 1024 * 1024};
+    static constexpr std::uint64_t default_staging_alignment{16};
+
+public:
+    //upload_budget is the amount of bytes scheduled uploads may use each frame, 0 means no limit.
+    explicit memory_transfer_scheduler(tph::device& device, std::uint64_t staging_size = default_staging_size, std::uint64_t upload_budget = 0) noexcept;
     ~memory_transfer_scheduler();
     memory_transfer_scheduler(const memory_transfer_scheduler&) = delete;
     memory_transfer_scheduler& operator=(const memory_transfer_scheduler&) = delete;
@@ -64,6 +97,19 @@ public:
     void submit_transfers();
     std::size_t clean_threads();
 
+    //Returns memory in the staging ring, or in a dedicated buffer if it is too small or full.
+    //The memory is released once the transfer has been executed.
+    staging_chunk allocate_staging(memory_transfer_info info, std::uint64_t size, std::uint64_t alignment = default_staging_alignment);
+
+    //Delays function until the next submission with enough budget left.
+    //size is the amount of staging memory function will allocate, at least one scheduled upload is executed each frame.
+    void schedule_upload(std::uint64_t size, upload_function function);
+
+    void set_upload_budget(std::uint64_t budget) noexcept;
+    std::uint64_t upload_budget() const noexcept;
+
+    memory_transfer_statistics statistics() const;
+
 private:
     struct thread_transfer_buffer
     {
@@ -88,6 +134,18 @@ private:
         tph::fence fence{};
     };
 
+    struct staging_batch
+    {
+        std::size_t buffer{};
+        std::uint64_t end{};
+    };
+
+    struct scheduled_upload
+    {
+        std::uint64_t size{};
+        upload_function function{};
+    };
+
 private:
     transfer_buffer& next_buffer();
     transfer_buffer& add_buffer();
@@ -100,13 +158,34 @@ private:
     thread_transfer_buffer& next_thread_buffer(thread_transfer_pool& pool, std::thread::id thread);
     thread_transfer_buffer& add_thread_buffer(thread_transfer_pool& pool, std::thread::id thread);
 
+    std::optional<std::uint64_t> try_allocate_staging(std::uint64_t size, std::uint64_t alignment);
+    void release_staging(std::size_t buffer) noexcept;
+    void release_staging();
+    void run_scheduled_uploads();
+    void update_statistics() noexcept;
+
 private:
     tph::device* m_device{};
     std::unordered_map<std::thread::id, thread_transfer_pool> m_thread_pools{};
     tph::command_pool m_pool{};
     std::vector<transfer_buffer> m_buffers{};
-    std::mutex m_mutex{};
+    mutable std::mutex m_mutex{};
     bool m_begin{};
+
+    tph::buffer m_staging{};
+    std::uint8_t* m_staging_map{};
+    std::uint64_t m_staging_size{};
+    std::uint64_t m_staging_head{}; //Never wraps, the offset in the ring is m_staging_head % m_staging_size
+    std::uint64_t m_staging_tail{};
+    std::deque<staging_batch> m_staging_batches{};
+
+    std::deque<scheduled_upload> m_scheduled{};
+    std::uint64_t m_upload_budget{};
+    mutable std::mutex m_scheduled_mutex{};
+
+    memory_transfer_statistics m_statistics{};
+    std::uint64_t m_frame_bytes{};
+    std::chrono::steady_clock::time_point m_last_submit{};
 };
 
 }
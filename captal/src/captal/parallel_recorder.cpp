@@ -0,0 +1,317 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+#include "parallel_recorder.hpp"
+
+#include <algorithm>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+struct parallel_recorder::thread_data
+{
+    tph::command_pool pool{};
+    std::mutex mutex{};
+    std::vector<asynchronous_resource*> free_buffers{};
+    bool closed{};
+};
+
+namespace
+{
+
+//Secondary buffers stay alive until the frames that execute them are done, then get back to the pool of the thread that recorded them.
+class secondary_command_buffer final : public asynchronous_resource
+{
+public:
+    explicit secondary_command_buffer(std::shared_ptr<parallel_recorder::thread_data> owner, tph::command_buffer buffer) noexcept
+    :m_owner{std::move(owner)}
+    ,m_buffer{std::move(buffer)}
+    {
+
+    }
+
+    ~secondary_command_buffer() = default;
+    secondary_command_buffer(const secondary_command_buffer&) = delete;
+    secondary_command_buffer& operator=(const secondary_command_buffer&) = delete;
+    secondary_command_buffer(secondary_command_buffer&&) noexcept = delete;
+    secondary_command_buffer& operator=(secondary_command_buffer&&) noexcept = delete;
+
+    tph::command_buffer& buffer() noexcept
+    {
+        return m_buffer;
+    }
+
+protected:
+    void recycle() noexcept override
+    {
+        std::unique_lock lock{m_owner->mutex};
+
+        if(!m_owner->closed)
+        {
+            m_owner->free_buffers.emplace_back(this);
+
+            return;
+        }
+
+        lock.unlock();
+
+        delete this;
+    }
+
+private:
+    std::shared_ptr<parallel_recorder::thread_data> m_owner{}; //Declared first, the command pool must outlive the buffer
+    tph::command_buffer m_buffer{};
+};
+
+std::shared_ptr<secondary_command_buffer> acquire_buffer(const std::shared_ptr<parallel_recorder::thread_data>& data, tph::render_pass& render_pass)
+{
+    std::unique_lock lock{data->mutex};
+
+    if(!std::empty(data->free_buffers))
+    {
+        const auto buffer{static_cast<secondary_command_buffer*>(data->free_buffers.back())};
+        data->free_buffers.pop_back();
+
+        lock.unlock();
+
+        std::shared_ptr<secondary_command_buffer> output{buffer, asynchronous_resource_deleter{}};
+        tph::cmd::begin(output->buffer(), render_pass, nullref);
+
+        return output;
+    }
+
+    lock.unlock();
+
+    return make_asynchronous_resource<secondary_command_buffer>(data, tph::cmd::begin(data->pool, render_pass, nullref));
+}
+
+}
+
+parallel_recorder::parallel_recorder(std::size_t thread_count)
+{
+    thread_count = std::max(thread_count, std::size_t{1});
+
+    m_threads_data.reserve(thread_count);
+    for(std::size_t i{}; i < thread_count; ++i)
+    {
+        auto& data{m_threads_data.emplace_back(std::make_shared<thread_data>())};
+        data->pool = tph::command_pool{engine::instance().device(), tph::command_pool_options::reset};
+
+        if constexpr(debug_enabled)
+        {
+            tph::set_object_name(engine::instance().device(), data->pool, "cpt::parallel_recorder's command pool #" + std::to_string(i));
+        }
+    }
+
+    //The thread that calls record is the worker #0
+    m_threads.reserve(thread_count - 1);
+    for(std::size_t i{1}; i < thread_count; ++i)
+    {
+        m_threads.emplace_back(&parallel_recorder::worker, this, i);
+    }
+}
+
+parallel_recorder::~parallel_recorder()
+{
+    std::unique_lock lock{m_mutex};
+    m_exit = true;
+    lock.unlock();
+
+    m_start.notify_all();
+
+    for(auto& thread : m_threads)
+    {
+        thread.join();
+    }
+
+    //Buffers that are still in use will destroy themselves once they are not anymore
+    for(auto& data : m_threads_data)
+    {
+        std::unique_lock data_lock{data->mutex};
+        data->closed = true;
+
+        auto buffers{std::move(data->free_buffers)};
+        data_lock.unlock();
+
+        for(auto buffer : buffers)
+        {
+            delete buffer;
+        }
+    }
+}
+
+void parallel_recorder::record(frame_render_info info, tph::render_pass& render_pass, std::size_t task_count, const parallel_record_function& function)
+{
+    if(task_count == 0)
+    {
+        return;
+    }
+
+    m_render_pass = &render_pass;
+    m_function = &function;
+    m_task_count = task_count;
+    m_next_task.store(0, std::memory_order_relaxed);
+    m_exception = nullptr;
+    m_signal = &info.signal;
+    m_buffers.assign(task_count, nullptr);
+
+    if(std::size(m_keepers) < task_count)
+    {
+        m_keepers.resize(task_count);
+    }
+
+    //Tasks stamp their resources with the frame's epoch, so no epoch is acquired nor retired per task
+    for(std::size_t i{}; i < task_count; ++i)
+    {
+        m_keepers[i].borrow_epoch(info.keeper);
+    }
+
+    std::unique_lock lock{m_mutex};
+    m_running = std::size(m_threads);
+    ++m_generation;
+    lock.unlock();
+
+    m_start.notify_all();
+
+    run(0);
+
+    lock.lock();
+    m_end.wait(lock, [this]()
+    {
+        return m_running == 0;
+    });
+    lock.unlock();
+
+    //Keep the buffers alive even if something failed, they will be recycled with the frame
+    for(std::size_t i{}; i < task_count; ++i)
+    {
+        info.keeper.merge(m_keepers[i]);
+    }
+
+    //Buffers of the tasks that succeeded are executed even if another one failed,
+    //the render pass of the frame is then still valid and the frame can be presented as usual
+    std::vector<std::reference_wrapper<tph::command_buffer>> buffers{};
+    buffers.reserve(task_count);
+
+    for(auto buffer : m_buffers)
+    {
+        if(buffer)
+        {
+            buffers.emplace_back(*buffer);
+        }
+    }
+
+    if(!std::empty(buffers))
+    {
+        tph::cmd::execute(info.buffer, buffers);
+    }
+
+    if(m_exception)
+    {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void parallel_recorder::worker(std::size_t index)
+{
+    std::uint64_t generation{};
+
+    while(true)
+    {
+        std::unique_lock lock{m_mutex};
+        m_start.wait(lock, [this, generation]()
+        {
+            return m_exit || m_generation != generation;
+        });
+
+        if(m_exit)
+        {
+            return;
+        }
+
+        generation = m_generation;
+        lock.unlock();
+
+        run(index);
+
+        lock.lock();
+
+        if(--m_running == 0)
+        {
+            m_end.notify_one();
+        }
+    }
+}
+
+void parallel_recorder::run(std::size_t thread_index)
+{
+    for(auto task{m_next_task.fetch_add(1, std::memory_order_relaxed)}; task < m_task_count; task = m_next_task.fetch_add(1, std::memory_order_relaxed))
+    {
+        try
+        {
+            run_task(thread_index, task);
+        }
+        catch(...)
+        {
+            std::lock_guard lock{m_mutex};
+
+            if(!m_exception)
+            {
+                m_exception = std::current_exception();
+            }
+        }
+    }
+}
+
+void parallel_recorder::run_task(std::size_t thread_index, std::size_t task)
+{
+    auto buffer{acquire_buffer(m_threads_data[thread_index], *m_render_pass)};
+    auto& keeper{m_keepers[task]};
+
+    //Kept first, so it is released with the frame even if the function throws
+    keeper.keep(buffer);
+
+    try
+    {
+        (*m_function)(task, frame_render_info{buffer->buffer(), *m_signal, keeper}, engine::instance().begin_transfer());
+    }
+    catch(...)
+    {
+        //A buffer can not be begun again while it is recording, it gets back to its pool ended, even if invalid
+        try
+        {
+            tph::cmd::end(buffer->buffer());
+        }
+        catch(...)
+        {
+
+        }
+
+        throw;
+    }
+
+    tph::cmd::end(buffer->buffer());
+    m_buffers[task] = &buffer->buffer();
+}
+
+}
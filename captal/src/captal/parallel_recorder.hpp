@@ -0,0 +1,101 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+#ifndef CAPTAL_PARALLEL_RECORDER_HPP_INCLUDED
+#define CAPTAL_PARALLEL_RECORDER_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <atomic>
+
+#include <tephra/commands.hpp>
+
+#include "render_target.hpp"
+#include "memory_transfer.hpp"
+
+namespace cpt
+{
+
+using parallel_record_function = std::function<void(std::size_t task, frame_render_info render, memory_transfer_info transfer)>;
+
+//Records the content of a render pass on several threads.
+//Each task is recorded in its own secondary command buffer, then they are executed in task order in the frame's buffer,
+//so the frame must have been begun with begin_render_options::parallel.
+//Tasks get their own keeper, stamping with the epoch of the frame's keeper, but share the frame's signals: connect to them from the thread that calls record only.
+class CAPTAL_API parallel_recorder
+{
+public:
+    struct thread_data;
+
+public:
+    explicit parallel_recorder(std::size_t thread_count = std::thread::hardware_concurrency());
+    ~parallel_recorder();
+    parallel_recorder(const parallel_recorder&) = delete;
+    parallel_recorder& operator=(const parallel_recorder&) = delete;
+    parallel_recorder(parallel_recorder&&) noexcept = delete;
+    parallel_recorder& operator=(parallel_recorder&&) noexcept = delete;
+
+    //Must not be called concurrently, the calling thread takes part in the recording
+    //If a task throws, the buffers of the other tasks are still executed, so the frame can be presented without the failed tasks,
+    //then the first exception is rethrown.
+    void record(frame_render_info info, tph::render_pass& render_pass, std::size_t task_count, const parallel_record_function& function);
+
+    std::size_t thread_count() const noexcept
+    {
+        return std::size(m_threads_data);
+    }
+
+private:
+    void worker(std::size_t index);
+    void run(std::size_t thread_index);
+    void run_task(std::size_t thread_index, std::size_t task);
+
+private:
+    std::vector<std::shared_ptr<thread_data>> m_threads_data{};
+    std::vector<std::thread> m_threads{};
+
+    std::mutex m_mutex{};
+    std::condition_variable m_start{};
+    std::condition_variable m_end{};
+    std::uint64_t m_generation{};
+    std::size_t m_running{};
+    bool m_exit{};
+
+    //Current job
+    tph::render_pass* m_render_pass{};
+    const parallel_record_function* m_function{};
+    std::size_t m_task_count{};
+    std::atomic<std::size_t> m_next_task{};
+    std::exception_ptr m_exception{};
+    std::vector<tph::command_buffer*> m_buffers{};
+    std::vector<asynchronous_resource_keeper> m_keepers{};
+    frame_presented_signal* m_signal{};
+};
+
+}
+
+#endif
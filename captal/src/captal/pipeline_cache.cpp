@@ -0,0 +1,228 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+#include "pipeline_cache.hpp"
+
+#include <fstream>
+#include <array>
+#include <cstring>
+
+namespace cpt
+{
+
+namespace
+{
+
+//Header written before the driver's own data, so we never feed a driver with data written for another device, driver, or truncated.
+struct cache_file_header
+{
+    std::array<char, 8> magic{};
+    std::uint32_t version{};
+    std::uint32_t vendor_id{};
+    std::uint32_t device_id{};
+    std::uint32_t driver_version{};
+    std::array<std::uint8_t, 16> uuid{};
+    std::uint64_t size{};
+    std::uint64_t checksum{};
+};
+
+constexpr std::array<char, 8> cache_file_magic{'C', 'P', 'T', 'P', 'S', 'O', 'C', 'H'};
+constexpr std::uint32_t cache_file_version{1};
+
+//FNV-1a, good enough to detect corrupted files
+std::uint64_t checksum(const std::uint8_t* data, std::size_t size) noexcept
+{
+    std::uint64_t output{14695981039346656037ull};
+
+    for(std::size_t i{}; i < size; ++i)
+    {
+        output ^= data[i];
+        output *= 1099511628211ull;
+    }
+
+    return output;
+}
+
+cache_file_header make_header(const tph::physical_device& physical_device) noexcept
+{
+    const auto& properties{physical_device.properties()};
+
+    cache_file_header output{};
+    output.magic = cache_file_magic;
+    output.version = cache_file_version;
+    output.vendor_id = properties.vendor_id;
+    output.device_id = properties.device_id;
+    output.driver_version = properties.driver_version;
+    output.uuid = properties.uuid;
+
+    return output;
+}
+
+}
+
+pipeline_cache::pipeline_cache(tph::device& device, const tph::physical_device& physical_device, std::filesystem::path path)
+:m_device{&device}
+,m_physical_device{&physical_device}
+,m_path{std::move(path)}
+{
+    std::error_code error{};
+    if(std::empty(m_path) || !std::filesystem::exists(m_path, error))
+    {
+        m_cache = tph::pipeline_cache{device};
+
+        return;
+    }
+
+    std::ifstream ifs{m_path, std::ios_base::binary};
+
+    cache_file_header header{};
+    if(!ifs.read(reinterpret_cast<char*>(&header), sizeof(cache_file_header)) || header.magic != cache_file_magic || header.version != cache_file_version)
+    {
+        m_status = pipeline_cache_status::invalid;
+        m_cache = tph::pipeline_cache{device};
+
+        return;
+    }
+
+    const auto expected{make_header(physical_device)};
+    if(header.vendor_id != expected.vendor_id || header.device_id != expected.device_id || header.driver_version != expected.driver_version || header.uuid != expected.uuid)
+    {
+        m_status = pipeline_cache_status::incompatible_device;
+        m_cache = tph::pipeline_cache{device};
+
+        return;
+    }
+
+    //Never trust the size read from the file, it must match what actually follows the header
+    const auto file_size{std::filesystem::file_size(m_path, error)};
+    if(error || file_size < sizeof(cache_file_header) || header.size != file_size - sizeof(cache_file_header))
+    {
+        m_status = pipeline_cache_status::invalid;
+        m_cache = tph::pipeline_cache{device};
+
+        return;
+    }
+
+    std::vector<std::uint8_t> data{};
+    data.resize(static_cast<std::size_t>(header.size));
+
+    const auto size{static_cast<std::streamsize>(header.size)};
+    if(ifs.read(reinterpret_cast<char*>(std::data(data)), size).gcount() != size || checksum(std::data(data), std::size(data)) != header.checksum)
+    {
+        m_status = pipeline_cache_status::invalid;
+        m_cache = tph::pipeline_cache{device};
+
+        return;
+    }
+
+    m_status = pipeline_cache_status::loaded;
+    m_cache = tph::pipeline_cache{device, std::span<const std::uint8_t>{data}};
+}
+
+tph::pipeline pipeline_cache::make_pipeline(tph::render_pass& render_pass, const tph::graphics_pipeline_info& info, const tph::pipeline_layout& layout)
+{
+    const auto begin{std::chrono::steady_clock::now()};
+    tph::pipeline output{*m_device, render_pass, info, layout, m_cache};
+    record(std::chrono::steady_clock::now() - begin);
+
+    return output;
+}
+
+tph::pipeline pipeline_cache::make_pipeline(const tph::compute_pipeline_info& info, const tph::pipeline_layout& layout)
+{
+    const auto begin{std::chrono::steady_clock::now()};
+    tph::pipeline output{*m_device, info, layout, m_cache};
+    record(std::chrono::steady_clock::now() - begin);
+
+    return output;
+}
+
+bool pipeline_cache::save() const noexcept
+{
+    if(std::empty(m_path))
+    {
+        return false;
+    }
+
+    //Write to a temporary file first, so a crash while saving never leaves a truncated cache behind
+    auto temporary{m_path};
+    temporary += ".tmp";
+
+    std::error_code error{};
+
+    try
+    {
+        const std::string data{m_cache.data()};
+
+        auto header{make_header(*m_physical_device)};
+        header.size = std::size(data);
+        header.checksum = checksum(reinterpret_cast<const std::uint8_t*>(std::data(data)), std::size(data));
+
+        std::ofstream ofs{temporary, std::ios_base::binary | std::ios_base::trunc};
+        if(ofs.write(reinterpret_cast<const char*>(&header), sizeof(cache_file_header)) && ofs.write(std::data(data), static_cast<std::streamsize>(std::size(data))))
+        {
+            ofs.close();
+
+            if(ofs)
+            {
+                std::filesystem::rename(temporary, m_path, error);
+
+                if(!error)
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    catch(...)
+    {
+
+    }
+
+    std::filesystem::remove(temporary, error);
+
+    return false;
+}
+
+void pipeline_cache::reset_statistics() noexcept
+{
+    std::lock_guard lock{m_mutex};
+
+    m_statistics = pipeline_cache_statistics{};
+}
+
+pipeline_cache_statistics pipeline_cache::statistics() const noexcept
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_statistics;
+}
+
+void pipeline_cache::record(std::chrono::nanoseconds time) noexcept
+{
+    std::lock_guard lock{m_mutex};
+
+    m_statistics.pipeline_count += 1;
+    m_statistics.creation_time += time;
+    m_statistics.max_creation_time = std::max(m_statistics.max_creation_time, time);
+}
+
+}
@@ -0,0 +1,110 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+#ifndef CAPTAL_PIPELINE_CACHE_HPP_INCLUDED
+#define CAPTAL_PIPELINE_CACHE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <filesystem>
+#include <chrono>
+#include <mutex>
+
+#include <tephra/hardware.hpp>
+#include <tephra/device.hpp>
+#include <tephra/pipeline.hpp>
+
+namespace cpt
+{
+
+enum class pipeline_cache_status : std::uint32_t
+{
+    empty = 0,                  //No file was given, or it does not exist yet
+    loaded = 1,                 //The file has been loaded
+    invalid = 2,                //The file is truncated, corrupted, or has not been written by captal
+    incompatible_device = 3,    //The file has been written for another device or driver version
+};
+
+struct pipeline_cache_statistics
+{
+    std::uint64_t pipeline_count{};
+    std::chrono::nanoseconds creation_time{};
+    std::chrono::nanoseconds max_creation_time{};
+};
+
+class CAPTAL_API pipeline_cache
+{
+public:
+    pipeline_cache() = default;
+    explicit pipeline_cache(tph::device& device, const tph::physical_device& physical_device, std::filesystem::path path = std::filesystem::path{});
+
+    ~pipeline_cache() = default;
+    pipeline_cache(const pipeline_cache&) = delete;
+    pipeline_cache& operator=(const pipeline_cache&) = delete;
+    pipeline_cache(pipeline_cache&&) noexcept = delete;
+    pipeline_cache& operator=(pipeline_cache&&) noexcept = delete;
+
+    tph::pipeline make_pipeline(tph::render_pass& render_pass, const tph::graphics_pipeline_info& info, const tph::pipeline_layout& layout);
+    tph::pipeline make_pipeline(const tph::compute_pipeline_info& info, const tph::pipeline_layout& layout);
+
+    //Writes the cache to its path, if any. Returns false if the file could not be written, nothing is left behind in that case.
+    bool save() const noexcept;
+
+    void reset_statistics() noexcept;
+    pipeline_cache_statistics statistics() const noexcept;
+
+    pipeline_cache_status status() const noexcept
+    {
+        return m_status;
+    }
+
+    const std::filesystem::path& path() const noexcept
+    {
+        return m_path;
+    }
+
+    tph::pipeline_cache& get() noexcept
+    {
+        return m_cache;
+    }
+
+    const tph::pipeline_cache& get() const noexcept
+    {
+        return m_cache;
+    }
+
+private:
+    void record(std::chrono::nanoseconds time) noexcept;
+
+private:
+    tph::device* m_device{};
+    const tph::physical_device* m_physical_device{};
+    std::filesystem::path m_path{};
+    tph::pipeline_cache m_cache{};
+    pipeline_cache_status m_status{};
+
+    mutable std::mutex m_mutex{};
+    pipeline_cache_statistics m_statistics{};
+};
+
+}
+
+#endif
@@ -94,6 +94,11 @@ public:
         return m_offsets.find(make_key(stages, offset)) != std::end(m_offsets);
     }
 
+    bool operator==(const push_constants_buffer& other) const
+    {
+        return m_data == other.m_data && m_offsets == other.m_offsets;
+    }
+
     void push(tph::command_buffer& buffer, tph::pipeline_layout& layout, std::span<const tph::push_constant_range> ranges) const
     {
         for(auto&& range : ranges)
@@ -0,0 +1,366 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "render_batch.hpp"
+
+#include <cassert>
+
+#include <tephra/commands.hpp>
+
+#include "engine.hpp"
+
+namespace cpt
+{
+
+//Number of frames a cached descriptor set survives without being used
+static constexpr std::uint64_t set_lifetime{8};
+
+static bool same_binding(const binding& left, const binding& right) noexcept
+{
+    if(left.index() != right.index() || get_binding_resource(left) != get_binding_resource(right))
+    {
+        return false;
+    }
+
+    if(get_binding_type(left) == binding_type::uniform_buffer_part)
+    {
+        return std::get<uniform_buffer_part>(left).part == std::get<uniform_buffer_part>(right).part;
+    }
+
+    return true;
+}
+
+static std::uint32_t binding_part(const binding& binding) noexcept
+{
+    if(get_binding_type(binding) == binding_type::uniform_buffer_part)
+    {
+        return std::get<uniform_buffer_part>(binding).part;
+    }
+
+    return 0;
+}
+
+render_batch::render_batch()
+:m_model{make_uniform_buffer(buffer_part{buffer_part_type::uniform, sizeof(basic_renderable::uniform_data)})}
+{
+    m_model->get<basic_renderable::uniform_data>(0).model = mat4f{identity};
+    m_model->upload();
+}
+
+void render_batch::add(const basic_renderable& renderable)
+{
+    if(!renderable.hidden())
+    {
+        m_pending.emplace_back(&renderable);
+    }
+}
+
+void render_batch::upload(memory_transfer_info info)
+{
+    if(std::empty(m_pending))
+    {
+        return;
+    }
+
+    const auto begin{std::chrono::steady_clock::now()};
+
+    m_vertices.clear();
+    m_indices.clear();
+    m_batches.clear();
+
+    for(const auto renderable : m_pending)
+    {
+        const auto model{cpt::model(renderable->m_position, renderable->m_rotation, vec3f{0.0f, 0.0f, 1.0f}, renderable->m_scale, renderable->m_origin)};
+
+        const auto base_vertex{static_cast<std::uint32_t>(std::size(m_vertices))};
+        const auto first_index{static_cast<std::uint32_t>(std::size(m_indices))};
+
+        const auto vertices{renderable->cvertices()};
+        for(auto&& vertex : vertices)
+        {
+            const auto& position{vertex.position};
+
+            auto& output{m_vertices.emplace_back(vertex)};
+            output.position.x() = model[0][0] * position.x() + model[0][1] * position.y() + model[0][2] * position.z() + model[0][3];
+            output.position.y() = model[1][0] * position.x() + model[1][1] * position.y() + model[1][2] * position.z() + model[1][3];
+            output.position.z() = model[2][0] * position.x() + model[2][1] * position.y() + model[2][2] * position.z() + model[2][3];
+        }
+
+        if(renderable->m_index_count > 0)
+        {
+            for(const auto index : renderable->cindices())
+            {
+                m_indices.emplace_back(base_vertex + index);
+            }
+        }
+        else
+        {
+            for(std::uint32_t i{}; i < renderable->m_vertex_count; ++i)
+            {
+                m_indices.emplace_back(base_vertex + i);
+            }
+        }
+
+        const auto index_count{static_cast<std::uint32_t>(std::size(m_indices)) - first_index};
+
+        if(!std::empty(m_batches) && compatible(*m_batches.back().first, *renderable))
+        {
+            m_batches.back().index_count += index_count;
+        }
+        else
+        {
+            m_batches.emplace_back(batch{renderable, first_index, index_count});
+        }
+    }
+
+    //Rebuilt every frame, so it is written where the device reads it instead of going through the staging buffers
+    auto& pool{engine::instance().uniform_pool()};
+
+    m_vertex_stream = pool.allocate_transient(info.keeper, std::size(m_vertices) * sizeof(vertex), alignof(vertex));
+    m_index_stream = pool.allocate_transient(info.keeper, std::size(m_indices) * sizeof(std::uint32_t), alignof(std::uint32_t));
+
+    std::memcpy(m_vertex_stream.map(), std::data(m_vertices), std::size(m_vertices) * sizeof(vertex));
+    std::memcpy(m_index_stream.map(), std::data(m_indices), std::size(m_indices) * sizeof(std::uint32_t));
+
+    m_statistics.renderable_count += std::size(m_pending);
+    m_statistics.vertex_count += std::size(m_vertices);
+    m_statistics.index_count += std::size(m_indices);
+    m_statistics.cpu_time += std::chrono::steady_clock::now() - begin;
+
+    m_pending.clear();
+}
+
+void render_batch::draw(frame_render_info info, cpt::view& view)
+{
+    assert(std::empty(m_pending) && "cpt::render_batch::draw called with pending renderables, call cpt::render_batch::upload first.");
+
+    if(std::empty(m_batches))
+    {
+        return;
+    }
+
+    const auto begin{std::chrono::steady_clock::now()};
+
+    const auto& layout{view.render_technique()->layout()};
+
+    tph::cmd::bind_vertex_buffer(info.buffer, m_vertex_stream.buffer(), m_vertex_stream.offset);
+    tph::cmd::bind_index_buffer(info.buffer, m_index_stream.buffer(), m_index_stream.offset, tph::index_type::uint32);
+
+    //Adjacent batches often only differ by their push constants, they reuse the bound set without looking it up
+    const descriptor_set_data* bound{};
+    const basic_renderable* bound_renderable{};
+    for(auto&& batch : m_batches)
+    {
+        if(!bound_renderable || !same_set(*layout, *bound_renderable, *batch.first))
+        {
+            auto& data{get_set(layout, *batch.first)};
+
+            if(&data != bound)
+            {
+                tph::cmd::bind_descriptor_set(info.buffer, 1, data.set->set(), layout->pipeline_layout());
+
+                info.keeper.keep(std::begin(data.to_keep), std::end(data.to_keep));
+                info.keeper.keep(data.set);
+
+                bound = &data;
+            }
+
+            bound_renderable = batch.first;
+        }
+
+        batch.first->m_push_constants.push(info.buffer, layout, render_layout::renderable_index);
+
+        tph::cmd::draw_indexed(info.buffer, batch.index_count, 1, batch.first_index, 0, 0);
+    }
+
+    info.keeper.keep_deferred(*m_vertex_stream.page);
+    info.keeper.keep_deferred(*m_index_stream.page);
+    info.keeper.keep(m_model);
+
+    m_statistics.draw_count += std::size(m_batches);
+    m_statistics.cpu_time += std::chrono::steady_clock::now() - begin;
+
+    m_batches.clear();
+    m_vertex_stream = transient_buffer_chunk{};
+    m_index_stream = transient_buffer_chunk{};
+
+    clean_sets();
+}
+
+void render_batch::clear() noexcept
+{
+    m_pending.clear();
+    m_batches.clear();
+    m_vertex_stream = transient_buffer_chunk{};
+    m_index_stream = transient_buffer_chunk{};
+}
+
+bool render_batch::compatible(const basic_renderable& left, const basic_renderable& right)
+{
+    if(left.m_uniform_index != right.m_uniform_index || !(left.m_push_constants == right.m_push_constants))
+    {
+        return false;
+    }
+
+    const auto count{std::max(left.m_bindings.size(), right.m_bindings.size())};
+
+    for(std::uint32_t i{}; i < count; ++i)
+    {
+        if(i == left.m_uniform_index)
+        {
+            continue;
+        }
+
+        const auto left_binding {left.m_bindings.try_get(i)};
+        const auto right_binding{right.m_bindings.try_get(i)};
+
+        if(left_binding.has_value() != right_binding.has_value())
+        {
+            return false;
+        }
+
+        if(left_binding && !same_binding(*left_binding, *right_binding))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const cpt::binding* render_batch::renderable_binding(const render_layout& layout, const basic_renderable& renderable, std::uint32_t index) noexcept
+{
+    if(index == renderable.m_uniform_index)
+    {
+        return nullptr;
+    }
+
+    if(const auto local{renderable.m_bindings.try_get(index)}; local)
+    {
+        return &(*local);
+    }
+
+    const auto fallback{layout.default_binding(render_layout::renderable_index, index)};
+    assert(fallback && "cpt::render_batch::draw can not find any suitable binding, neither the renderable nor the render layout have a binding for specified index.");
+
+    return &(*fallback);
+}
+
+bool render_batch::same_set(const render_layout& layout, const basic_renderable& left, const basic_renderable& right) noexcept
+{
+    for(auto&& binding : layout.bindings(render_layout::renderable_index))
+    {
+        const auto left_binding {renderable_binding(layout, left, binding.binding)};
+        const auto right_binding{renderable_binding(layout, right, binding.binding)};
+
+        if((left_binding == nullptr) != (right_binding == nullptr))
+        {
+            return false;
+        }
+
+        if(left_binding && !same_binding(*left_binding, *right_binding))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+render_batch::descriptor_set_data& render_batch::get_set(const render_layout_ptr& layout, const basic_renderable& renderable)
+{
+    const auto to_bind{layout->bindings(render_layout::renderable_index)};
+
+    //The key is reused, so looking up an existing set does not allocate
+    m_key.layout = layout.get();
+    m_key.resources.clear();
+
+    for(auto&& binding : to_bind)
+    {
+        if(const auto resolved{renderable_binding(*layout, renderable, binding.binding)}; resolved)
+        {
+            m_key.resources.emplace_back(get_binding_resource(*resolved).get(), binding_part(*resolved));
+        }
+        else
+        {
+            m_key.resources.emplace_back(m_model.get(), 0);
+        }
+    }
+
+    auto it{m_sets.find(m_key)};
+
+    if(it == std::end(m_sets))
+    {
+        descriptor_set_data data{layout, layout->make_set(render_layout::renderable_index)};
+
+        #ifdef CAPTAL_DEBUG
+        if(!std::empty(m_name))
+        {
+            tph::set_object_name(engine::instance().device(), data.set->set(), m_name + " descriptor set");
+        }
+        #endif
+
+        std::vector<tph::descriptor_write> writes{};
+        writes.reserve(std::size(to_bind));
+
+        for(auto&& to_write : to_bind)
+        {
+            const auto resolved{renderable_binding(*layout, renderable, to_write.binding)};
+            const cpt::binding binding{resolved ? *resolved : cpt::binding{m_model}};
+
+            writes.emplace_back(make_descriptor_write(data.set->set(), to_write.binding, binding));
+            data.to_keep.emplace_back(get_binding_resource(binding));
+        }
+
+        tph::write_descriptors(engine::instance().device(), writes);
+
+        it = m_sets.emplace(m_key, std::move(data)).first;
+    }
+
+    it->second.last_use = engine::instance().frame();
+
+    return it->second;
+}
+
+void render_batch::clean_sets()
+{
+    const auto frame{engine::instance().frame()};
+
+    std::erase_if(m_sets, [frame](auto&& item)
+    {
+        return item.second.last_use + set_lifetime < frame;
+    });
+}
+
+#ifdef CAPTAL_DEBUG
+void render_batch::set_name(std::string_view name)
+{
+    m_name = name;
+
+    for(auto&& [key, data] : m_sets)
+    {
+        tph::set_object_name(engine::instance().device(), data.set->set(), m_name + " descriptor set");
+    }
+}
+#endif
+
+}
@@ -0,0 +1,151 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef CAPTAL_RENDER_BATCH_HPP_INCLUDED
+#define CAPTAL_RENDER_BATCH_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <map>
+#include <chrono>
+
+#include "asynchronous_resource.hpp"
+#include "uniform_buffer.hpp"
+#include "buffer_pool.hpp"
+#include "render_technique.hpp"
+#include "renderable.hpp"
+#include "view.hpp"
+
+namespace cpt
+{
+
+struct render_batch_statistics
+{
+    std::uint64_t renderable_count{};
+    std::uint64_t draw_count{};
+    std::uint64_t vertex_count{};
+    std::uint64_t index_count{};
+    std::chrono::nanoseconds cpu_time{};
+};
+
+//Collects renderables, pre-transforms their vertices on the CPU and draws consecutive renderables
+//that share the same bindings and push constants with a single indexed draw.
+//Draw order is preserved: only adjacent renderables are merged.
+//Added renderables are referenced, not copied, they must outlive the next call to upload.
+class CAPTAL_API render_batch
+{
+public:
+    render_batch();
+    ~render_batch() = default;
+    render_batch(const render_batch&) = delete;
+    render_batch& operator=(const render_batch&) = delete;
+    render_batch(render_batch&&) noexcept = default;
+    render_batch& operator=(render_batch&&) noexcept = default;
+
+    void add(const basic_renderable& renderable);
+    void upload(memory_transfer_info info);
+    void draw(frame_render_info info, cpt::view& view);
+    void clear() noexcept;
+
+    void reset_statistics() noexcept
+    {
+        m_statistics = render_batch_statistics{};
+    }
+
+    const render_batch_statistics& statistics() const noexcept
+    {
+        return m_statistics;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return std::size(m_pending);
+    }
+
+    bool empty() const noexcept
+    {
+        return std::empty(m_pending);
+    }
+
+#ifdef CAPTAL_DEBUG
+    void set_name(std::string_view name);
+#else
+    void set_name(std::string_view name [[maybe_unused]]) const noexcept
+    {
+
+    }
+#endif
+
+private:
+    struct batch
+    {
+        const basic_renderable* first{};
+        std::uint32_t first_index{};
+        std::uint32_t index_count{};
+    };
+
+    struct set_key
+    {
+        const render_layout* layout{};
+        std::vector<std::pair<const asynchronous_resource*, std::uint32_t>> resources{};
+
+        auto operator<=>(const set_key&) const = default;
+    };
+
+    struct descriptor_set_data
+    {
+        render_layout_ptr layout{};
+        descriptor_set_ptr set{};
+        std::vector<asynchronous_resource_ptr> to_keep{};
+        std::uint64_t last_use{};
+    };
+
+private:
+    static bool compatible(const basic_renderable& left, const basic_renderable& right);
+    //Returns nullptr for the batch's model buffer
+    static const cpt::binding* renderable_binding(const render_layout& layout, const basic_renderable& renderable, std::uint32_t index) noexcept;
+    static bool same_set(const render_layout& layout, const basic_renderable& left, const basic_renderable& right) noexcept;
+
+    descriptor_set_data& get_set(const render_layout_ptr& layout, const basic_renderable& renderable);
+    void clean_sets();
+
+private:
+    uniform_buffer_ptr m_model{};
+    transient_buffer_chunk m_vertex_stream{};
+    transient_buffer_chunk m_index_stream{};
+    std::vector<const basic_renderable*> m_pending{};
+    std::vector<vertex> m_vertices{};
+    std::vector<std::uint32_t> m_indices{};
+    std::vector<batch> m_batches{};
+    std::map<set_key, descriptor_set_data> m_sets{};
+    set_key m_key{};
+    render_batch_statistics m_statistics{};
+
+#ifdef CAPTAL_DEBUG
+    std::string m_name{};
+#endif
+};
+
+}
+
+#endif
@@ -52,9 +52,17 @@ enum class begin_render_options : std::uint32_t
 {
     none = 0x00,
     timed = 0x01,
-    reset = 0x02
+    reset = 0x02,
+    parallel = 0x04 //The render pass content is recorded in secondary command buffers (see cpt::parallel_recorder)
 };
 
+inline tph::render_pass_content render_pass_content(begin_render_options options) noexcept
+{
+    const bool parallel{(static_cast<std::uint32_t>(options) & static_cast<std::uint32_t>(begin_render_options::parallel)) != 0};
+
+    return parallel ? tph::render_pass_content::recorded : tph::render_pass_content::inlined;
+}
+
 class CAPTAL_API render_target
 {
 public:
@@ -22,65 +22,70 @@
 
 #include "render_technique.hpp"
 
+#include <cassert>
+#include <algorithm>
+
 #include "engine.hpp"
 #include "vertex.hpp"
 
 namespace cpt
 {
 
-descriptor_set::descriptor_set(descriptor_pool& parent, tph::descriptor_set set) noexcept
+descriptor_set_free_list::~descriptor_set_free_list()
+{
+    for(auto set : sets)
+    {
+        delete set;
+    }
+}
+
+descriptor_set::descriptor_set(descriptor_pool& parent, tph::descriptor_set set, std::weak_ptr<descriptor_set_free_list> free_list) noexcept
 :m_parent{&parent}
 ,m_set{std::move(set)}
+,m_free_list{std::move(free_list)}
 {
 
 }
 
-
-descriptor_pool::descriptor_pool(render_layout& parent, tph::descriptor_set_layout& layout, tph::descriptor_pool pool)
-:m_parent{&parent}
-,m_pool{std::move(pool)}
+void descriptor_set::recycle() noexcept
 {
-    for(auto&& set : m_sets)
+    if(const auto free_list{m_free_list.lock()}; free_list)
+    {
+        std::lock_guard lock{free_list->mutex};
+        free_list->sets.emplace_back(this);
+    }
+    else
     {
-        set = std::make_shared<descriptor_set>(*this, tph::descriptor_set{engine::instance().device(), m_pool, layout});
+        delete this;
     }
 }
 
-descriptor_set_ptr descriptor_pool::allocate() noexcept
+descriptor_pool::descriptor_pool(render_layout& parent, tph::descriptor_pool pool, std::uint32_t capacity) noexcept
+:m_parent{&parent}
+,m_pool{std::move(pool)}
+,m_capacity{capacity}
 {
-    for(auto&& set : m_sets)
-    {
-        if(set.use_count() == 1)
-        {
-            return set;
-        }
-    }
 
-    return nullptr;
 }
 
-bool descriptor_pool::unused() const noexcept
+tph::descriptor_set descriptor_pool::allocate(tph::descriptor_set_layout& layout)
 {
-    return std::all_of(std::begin(m_sets), std::end(m_sets), [](const descriptor_set_ptr& set)
-    {
-        return set.use_count() == 1;
-    });
+    assert(!full() && "cpt::descriptor_pool::allocate called on a full pool.");
+
+    tph::descriptor_set output{engine::instance().device(), m_pool, layout};
+    ++m_allocated;
+
+    return output;
 }
 
 #ifdef CAPTAL_DEBUG
 void descriptor_pool::set_name(std::string_view name)
 {
-    const std::string name_str{name};
-
-    tph::set_object_name(engine::instance().device(), m_pool, name_str);
-
-    for(std::size_t i{}; i < std::size(m_sets); ++i)
-    {
-        tph::set_object_name(engine::instance().device(), m_pool, name_str + " descriptor set #" + std::to_string(i));
-    }
+    tph::set_object_name(engine::instance().device(), m_pool, std::string{name});
 }
 #endif
 
+//Sizes of a single set, add_pool multiplies them by the capacity of each pool
 static std::vector<tph::descriptor_pool_size> make_pool_sizes(std::span<const tph::descriptor_set_layout_binding> bindings)
 {
     std::vector<tph::descriptor_pool_size> output{};
@@ -88,7 +93,7 @@ static std::vector<tph::descriptor_pool_size> make_pool_sizes(std::span<const tp
 
     for(auto&& binding : bindings)
     {
-        output.emplace_back(binding.type, binding.count * descriptor_pool::pool_size);
+        output.emplace_back(binding.type, binding.count);
     }
 
     return output;
@@ -99,6 +104,7 @@ render_layout::layout_data render_layout::make_layout_data(const render_layout_i
     layout_data output{};
     output.layout = tph::descriptor_set_layout{engine::instance().device(), info.bindings};
     output.sizes = make_pool_sizes(info.bindings);
+    output.free_sets = std::make_shared<descriptor_set_free_list>();
 
     output.bindings = info.bindings;
     output.push_constants = info.push_constants;
@@ -162,20 +168,50 @@ render_layout::render_layout(const render_layout_info& view_info, const render_l
 
 descriptor_set_ptr render_layout::make_set(std::uint32_t layout_index)
 {
-    std::lock_guard lock{m_mutex};
-
     auto& data{m_layout_data[layout_index]};
 
-    for(auto&& pool : data.pools)
+    //Sets only get back to the free list once no frame can use them anymore, so any of them can be reused
     {
-        if(auto set{pool->allocate()}; set)
+        std::unique_lock lock{data.free_sets->mutex};
+
+        if(!std::empty(data.free_sets->sets))
         {
-            return set;
+            const auto set{data.free_sets->sets.back()};
+            data.free_sets->sets.pop_back();
+
+            lock.unlock();
+
+            return descriptor_set_ptr{set, asynchronous_resource_deleter{}};
         }
     }
 
-    tph::descriptor_pool pool{engine::instance().device(), data.sizes, static_cast<std::uint32_t>(descriptor_pool::pool_size)};
-    data.pools.emplace_back(std::make_unique<descriptor_pool>(*this, data.layout, std::move(pool)));
+    std::lock_guard lock{m_mutex};
+
+    if(std::empty(data.pools) || data.pools.back()->full())
+    {
+        add_pool(layout_index);
+    }
+
+    auto& pool{*data.pools.back()};
+
+    return make_asynchronous_resource<descriptor_set>(pool, pool.allocate(data.layout), data.free_sets);
+}
+
+descriptor_pool& render_layout::add_pool(std::uint32_t layout_index)
+{
+    auto& data{m_layout_data[layout_index]};
+
+    //Pools grow geometrically, so the number of pools stays logarithmic in the number of sets
+    const std::uint32_t capacity{std::empty(data.pools) ? descriptor_pool::initial_size : std::min(data.pools.back()->capacity() * 2, descriptor_pool::max_size)};
+
+    std::vector<tph::descriptor_pool_size> sizes{data.sizes};
+    for(auto& size : sizes)
+    {
+        size.count *= capacity;
+    }
+
+    tph::descriptor_pool pool{engine::instance().device(), sizes, capacity};
+    data.pools.emplace_back(std::make_unique<descriptor_pool>(*this, std::move(pool), capacity));
 
 #ifdef CAPTAL_DEBUG
     if(!std::empty(m_name))
@@ -195,7 +231,7 @@ descriptor_set_ptr render_layout::make_set(std::uint32_t layout_index)
     }
 #endif
 
-    return data.pools.back()->allocate();
+    return *data.pools.back();
 }
 
 #ifdef CAPTAL_DEBUG
@@ -232,6 +268,16 @@ void render_layout::set_name(std::string_view name)
 }
 #endif
 
+static render_layout_ptr default_layout(render_technique_options options)
+{
+    if(static_cast<bool>(options & render_technique_options::instanced))
+    {
+        return engine::instance().default_instanced_render_layout();
+    }
+
+    return engine::instance().default_render_layout();
+}
+
 static tph::graphics_pipeline_info make_info(const render_technique_info& info, render_technique_options options)
 {
     tph::graphics_pipeline_info output{};
@@ -258,7 +304,14 @@ static tph::graphics_pipeline_info make_info(const render_technique_info& info,
 
     if(!has_vertex)
     {
-        output.stages.emplace_back(engine::instance().default_vertex_shader());
+        if(static_cast<bool>(options & render_technique_options::instanced))
+        {
+            output.stages.emplace_back(engine::instance().default_instanced_vertex_shader());
+        }
+        else
+        {
+            output.stages.emplace_back(engine::instance().default_vertex_shader());
+        }
     }
 
     if(!has_fragment)
@@ -282,8 +335,8 @@ static tph::graphics_pipeline_info make_info(const render_technique_info& info,
 }
 
 render_technique::render_technique(const render_target_ptr& target, const render_technique_info& info, render_layout_ptr layout, render_technique_options options)
-:m_layout{layout ? std::move(layout) : engine::instance().default_render_layout()}
-,m_pipeline{engine::instance().device(), target->get_render_pass(), make_info(info, options), m_layout->pipeline_layout()}
+:m_layout{layout ? std::move(layout) : default_layout(options)}
+,m_pipeline{engine::instance().pipeline_cache().make_pipeline(target->get_render_pass(), make_info(info, options), m_layout->pipeline_layout())}
 {
 
 }
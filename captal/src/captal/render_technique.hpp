@@ -41,14 +41,30 @@ namespace cpt
 {
 
 class render_target;
+class descriptor_set;
 class descriptor_pool;
 class render_layout;
 
+//Sets that are not used anymore, shared between a render_layout and its sets so a set can get back to it
+//(or be destroyed if the layout does not exist anymore) once its last frame has been executed.
+struct CAPTAL_API descriptor_set_free_list
+{
+    descriptor_set_free_list() = default;
+    ~descriptor_set_free_list();
+    descriptor_set_free_list(const descriptor_set_free_list&) = delete;
+    descriptor_set_free_list& operator=(const descriptor_set_free_list&) = delete;
+    descriptor_set_free_list(descriptor_set_free_list&&) noexcept = delete;
+    descriptor_set_free_list& operator=(descriptor_set_free_list&&) noexcept = delete;
+
+    std::mutex mutex{};
+    std::vector<descriptor_set*> sets{};
+};
+
 class CAPTAL_API descriptor_set : public asynchronous_resource
 {
 public:
     descriptor_set() = default;
-    explicit descriptor_set(descriptor_pool& parent, tph::descriptor_set set) noexcept;
+    explicit descriptor_set(descriptor_pool& parent, tph::descriptor_set set, std::weak_ptr<descriptor_set_free_list> free_list = {}) noexcept;
 
     ~descriptor_set() = default;
     descriptor_set(const descriptor_set&) = delete;
@@ -71,9 +87,13 @@ public:
         return m_set;
     }
 
+protected:
+    void recycle() noexcept override;
+
 private:
     descriptor_pool* m_parent{};
     tph::descriptor_set m_set{};
+    std::weak_ptr<descriptor_set_free_list> m_free_list{};
 };
 
 using descriptor_set_ptr = std::shared_ptr<descriptor_set>;
@@ -82,18 +102,33 @@ using descriptor_set_weak_ptr = std::weak_ptr<descriptor_set>;
 class CAPTAL_API descriptor_pool
 {
 public:
-    static constexpr std::uint32_t pool_size{32};
+    static constexpr std::uint32_t initial_size{32};
+    static constexpr std::uint32_t max_size{4096};
 
 public:
-    explicit descriptor_pool(render_layout& parent, tph::descriptor_set_layout& layout, tph::descriptor_pool pool);
+    explicit descriptor_pool(render_layout& parent, tph::descriptor_pool pool, std::uint32_t capacity) noexcept;
     ~descriptor_pool() = default;
     descriptor_pool(const descriptor_pool&) = delete;
     descriptor_pool& operator=(const descriptor_pool&) = delete;
     descriptor_pool(descriptor_pool&&) noexcept = delete;
     descriptor_pool& operator=(descriptor_pool&&) noexcept = delete;
 
-    descriptor_set_ptr allocate() noexcept;
-    bool unused() const noexcept;
+    tph::descriptor_set allocate(tph::descriptor_set_layout& layout);
+
+    bool full() const noexcept
+    {
+        return m_allocated == m_capacity;
+    }
+
+    std::uint32_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    std::uint32_t allocated() const noexcept
+    {
+        return m_allocated;
+    }
 
     render_layout& layout() noexcept
     {
@@ -127,7 +162,8 @@ public:
 private:
     render_layout* m_parent{};
     tph::descriptor_pool m_pool{};
-    std::array<descriptor_set_ptr, pool_size> m_sets{};
+    std::uint32_t m_capacity{};
+    std::uint32_t m_allocated{};
 };
 
 struct render_layout_info
@@ -196,6 +232,7 @@ public:
 
 #ifdef CAPTAL_DEBUG
     friend class basic_renderable;
+    friend class basic_instanced_renderable;
 
     void set_name(std::string_view name);
 #else
@@ -214,9 +251,11 @@ private:
         std::vector<tph::push_constant_range> push_constants{};
         std::vector<tph::descriptor_pool_size> sizes{};
         std::vector<std::unique_ptr<descriptor_pool>> pools{};
+        std::shared_ptr<descriptor_set_free_list> free_sets{};
     };
 
     static layout_data make_layout_data(const render_layout_info& info);
+    descriptor_pool& add_pool(std::uint32_t layout_index);
     static std::vector<tph::push_constant_range> make_push_constant_ranges(std::span<const layout_data> layouts);
     static std::vector<std::reference_wrapper<tph::descriptor_set_layout>> make_layout_refs(std::span<layout_data> layouts);
 
@@ -236,13 +275,14 @@ using render_layout_weak_ptr = std::weak_ptr<render_layout>;
 template<typename... Args>
 render_layout_ptr make_render_layout(Args&&... args)
 {
-    return std::make_shared<render_layout>(std::forward<Args>(args)...);
+    return make_asynchronous_resource<render_layout>(std::forward<Args>(args)...);
 }
 
 enum class render_technique_options : std::uint32_t
 {
     none = 0x00,
     no_default_color_blend_attachment = 0x01,
+    instanced = 0x02, //Use the engine's default instanced vertex shader and render layout when none are specified
 
     no_defaults = no_default_color_blend_attachment
 };
@@ -302,7 +342,7 @@ using render_technique_weak_ptr = std::weak_ptr<render_technique>;
 template<typename... Args>
 render_technique_ptr make_render_technique(Args&&... args)
 {
-    return std::make_shared<render_technique>(std::forward<Args>(args)...);
+    return make_asynchronous_resource<render_technique>(std::forward<Args>(args)...);
 }
 
 }
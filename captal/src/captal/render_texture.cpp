@@ -219,13 +219,13 @@ std::optional<frame_render_info> render_texture::begin_render(begin_render_optio
         tph::cmd::reset_query_pool(m_data->buffer, m_data->query_pool, 0, 2);
         tph::cmd::write_timestamp(m_data->buffer, m_data->query_pool, 0, tph::pipeline_stage::top_of_pipe);
 
-        tph::cmd::begin_render_pass(m_data->buffer, get_render_pass(), m_framebuffer);
+        tph::cmd::begin_render_pass(m_data->buffer, get_render_pass(), m_framebuffer, render_pass_content(options));
 
         return frame_render_info{m_data->buffer, m_data->signal, m_data->keeper, m_data->time_signal};
     }
     else
     {
-        tph::cmd::begin_render_pass(m_data->buffer, get_render_pass(), m_framebuffer);
+        tph::cmd::begin_render_pass(m_data->buffer, get_render_pass(), m_framebuffer, render_pass_content(options));
 
         return frame_render_info{m_data->buffer, m_data->signal, m_data->keeper};
     }
@@ -337,6 +337,9 @@ void render_texture::flush_frame_data(frame_data& data)
     }
 
     data.signal();
+
+    //The command buffer will be submitted again, its resources must not be bound to an epoch anymore
+    data.keeper.pin();
 }
 
 void render_texture::reset_frame_data(frame_data& data)
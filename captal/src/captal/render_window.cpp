@@ -321,13 +321,13 @@ std::optional<frame_render_info> render_window::begin_render(begin_render_option
         tph::cmd::reset_query_pool(data.buffer, data.query_pool, 0, 2);
         tph::cmd::write_timestamp(data.buffer, data.query_pool, 0, tph::pipeline_stage::top_of_pipe);
 
-        tph::cmd::begin_render_pass(data.buffer, get_render_pass(), framebuffer);
+        tph::cmd::begin_render_pass(data.buffer, get_render_pass(), framebuffer, render_pass_content(options));
 
         return frame_render_info{data.buffer, data.signal, data.keeper, data.time_signal};
     }
     else
     {
-        tph::cmd::begin_render_pass(data.buffer, get_render_pass(), framebuffer);
+        tph::cmd::begin_render_pass(data.buffer, get_render_pass(), framebuffer, render_pass_content(options));
 
         return frame_render_info{data.buffer, data.signal, data.keeper};
     }
@@ -542,6 +542,9 @@ void render_window::flush_frame_data(frame_data& data)
     }
 
     data.signal();
+
+    //The command buffer will be submitted again, its resources must not be bound to an epoch anymore
+    data.keeper.pin();
 }
 
 void render_window::reset_frame_data(frame_data& data)
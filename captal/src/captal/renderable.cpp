@@ -235,7 +235,7 @@ void basic_renderable::upload(memory_transfer_info info)
 
     if(keep)
     {
-        info.keeper.keep(get_binding_resource(m_bindings.get(m_uniform_index)));
+        info.keeper.keep(std::get<uniform_buffer_part>(m_bindings.get(m_uniform_index)).buffer);
     }
 }
 
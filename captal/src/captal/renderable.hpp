@@ -93,6 +93,8 @@ concept renderable = requires(T r, const T cr,
 
 class CAPTAL_API basic_renderable
 {
+    friend class render_batch;
+
 public:
     struct uniform_data
     {
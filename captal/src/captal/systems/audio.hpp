@@ -25,6 +25,8 @@
 
 #include "../config.hpp"
 
+#include <tuple>
+
 #include <entt/entity/registry.hpp>
 
 #include "../engine.hpp"
@@ -33,6 +35,8 @@
 #include "../components/listener.hpp"
 #include "../components/audio_emitter.hpp"
 
+#include "frame.hpp"
+
 namespace cpt::systems
 {
 
@@ -54,8 +58,21 @@ inline void audio(entt::registry& world)
         }
     };
 
-    world.view<components::listener, const components::node>().each(update_listener);
-    world.view<components::audio_emitter, const components::node>().each(update_emitters);
+    const auto listeners{world.view<components::listener, const components::node>()};
+    const auto emitters {world.view<components::audio_emitter, const components::node>()};
+
+    each_updated_node(world, [&](entt::entity entity)
+    {
+        if(listeners.contains(entity))
+        {
+            update_listener(listeners.get<const components::node>(entity));
+        }
+
+        if(emitters.contains(entity))
+        {
+            std::apply(update_emitters, emitters.get(entity));
+        }
+    });
 }
 
 }
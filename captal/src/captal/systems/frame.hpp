@@ -25,6 +25,9 @@
 
 #include "../config.hpp"
 
+#include <memory>
+#include <type_traits>
+
 #include <entt/entity/registry.hpp>
 
 #include "../components/node.hpp"
@@ -32,12 +35,100 @@
 namespace cpt::systems
 {
 
+namespace impl
+{
+
+struct node_tracking
+{
+    components::node_tracker tracker{};
+
+    void track(entt::registry& world, entt::entity entity)
+    {
+        //Reserve a slot for every node, so updating a node never needs to allocate
+        tracker.reserve(std::size(world.storage<components::node>()));
+        world.get<components::node>(entity).track(&tracker, entt::to_integral(entity));
+    }
+};
+
+}
+
+static_assert(std::is_same_v<std::underlying_type_t<entt::entity>, std::uint32_t>, "cpt::components::node_tracker stores entities as std::uint32_t.");
+
+//Returns the list of the nodes updated since the last end_frame call.
+//Tracking is enabled on the first call, for each node already in the registry and each node added (or replaced) later.
+inline components::node_tracker& node_tracker(entt::registry& world)
+{
+    if(const auto tracking{world.ctx().find<std::unique_ptr<impl::node_tracking>>()}; tracking)
+    {
+        return (*tracking)->tracker;
+    }
+
+    auto& tracking{*world.ctx().emplace<std::unique_ptr<impl::node_tracking>>(std::make_unique<impl::node_tracking>())};
+
+    world.on_construct<components::node>().connect<&impl::node_tracking::track>(tracking);
+    world.on_update<components::node>().connect<&impl::node_tracking::track>(tracking);
+
+    tracking.tracker.reserve(std::size(world.storage<components::node>()));
+
+    for(auto&& [entity, node] : world.view<components::node>().each())
+    {
+        node.track(&tracking.tracker, entt::to_integral(entity));
+    }
+
+    return tracking.tracker;
+}
+
+//Calls function with each entity whose node has been updated since the last end_frame call.
+//If the tracker overflowed, every node is checked instead.
+template<typename Function>
+void each_updated_node(entt::registry& world, Function&& function)
+{
+    auto& tracker{node_tracker(world)};
+
+    if(tracker.overflowed())
+    {
+        for(auto&& [entity, node] : world.view<const components::node>().each())
+        {
+            if(node.is_updated())
+            {
+                function(entity);
+            }
+        }
+    }
+    else
+    {
+        for(const auto id : tracker.updated())
+        {
+            function(static_cast<entt::entity>(id));
+        }
+    }
+}
+
 inline void end_frame(entt::registry& world)
 {
-    world.view<components::node>().each([](components::node& node)
+    auto& tracker{node_tracker(world)};
+    const auto nodes{world.view<components::node>()};
+
+    if(tracker.overflowed())
+    {
+        for(auto&& [entity, node] : nodes.each())
+        {
+            node.clear_tracking();
+        }
+    }
+    else
     {
-        node.clear();
-    });
+        for(const auto id : tracker.updated())
+        {
+            if(const auto entity{static_cast<entt::entity>(id)}; nodes.contains(entity))
+            {
+                nodes.get<components::node>(entity).clear_tracking();
+            }
+        }
+    }
+
+    tracker.clear();
+    tracker.reserve(std::size(nodes));
 }
 
 }
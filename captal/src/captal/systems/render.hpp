@@ -25,6 +25,9 @@
 
 #include "../config.hpp"
 
+#include <tuple>
+#include <vector>
+
 #include <entt/entity/registry.hpp>
 
 #include <tephra/commands.hpp>
@@ -37,6 +40,10 @@
 #include "../view.hpp"
 #include "../render_window.hpp"
 #include "../renderable.hpp"
+#include "../render_batch.hpp"
+#include "../parallel_recorder.hpp"
+
+#include "frame.hpp"
 
 namespace cpt::systems
 {
@@ -69,8 +76,22 @@ void prepare_render(entt::registry& world)
         }
     };
 
-    world.view<const components::node, Drawable>().each(drawable_update);
-    world.view<const components::node, components::camera>().each(camera_update);
+    //Only the nodes updated during this frame are visited
+    const auto drawables{world.view<const components::node, Drawable>()};
+    const auto cameras  {world.view<const components::node, components::camera>()};
+
+    each_updated_node(world, [&](entt::entity entity)
+    {
+        if(drawables.contains(entity))
+        {
+            std::apply(drawable_update, drawables.get(entity));
+        }
+
+        if(cameras.contains(entity))
+        {
+            std::apply(camera_update, cameras.get(entity));
+        }
+    });
 }
 
 template<components::drawable_specialization Drawable = components::drawable>
@@ -132,6 +153,153 @@ void render(entt::registry& world, cpt::begin_render_options options = cpt::begi
     });
 }
 
+namespace impl
+{
+
+//Stored in the registry's context, so parallel_render does not allocate a new list every frame
+struct parallel_render_entities
+{
+    std::vector<entt::entity> entities{};
+};
+
+}
+
+//Same as render, but drawables are split in contiguous ranges recorded by recorder's threads, then executed in order.
+//begin_render_options::parallel is always added to options.
+template<components::drawable_specialization Drawable = components::drawable>
+void parallel_render(entt::registry& world, parallel_recorder& recorder, cpt::begin_render_options options = cpt::begin_render_options::none)
+{
+    prepare_render<Drawable>(world);
+
+    auto* buffer{world.ctx().find<impl::parallel_render_entities>()};
+    if(!buffer)
+    {
+        buffer = &world.ctx().emplace<impl::parallel_render_entities>();
+    }
+
+    const auto drawables{world.view<Drawable>()};
+    const auto& entities{buffer->entities};
+    buffer->entities.assign(std::begin(drawables), std::end(drawables));
+
+    //A few tasks per thread to balance the load
+    const std::size_t task_count{std::min(std::size(entities), recorder.thread_count() * 4)};
+
+    world.view<components::camera>().each([&drawables, &entities, &recorder, task_count, options](components::camera& camera)
+    {
+        if(camera)
+        {
+            auto render  {camera->target().begin_render(options | begin_render_options::parallel)};
+            auto transfer{engine::instance().begin_transfer()};
+
+            camera->upload(transfer);
+
+            if(render)
+            {
+                camera->update();
+
+                recorder.record(*render, camera->target().get_render_pass(), std::max(task_count, std::size_t{1}), [&drawables, &entities, &camera, task_count](std::size_t task, frame_render_info task_render, memory_transfer_info task_transfer)
+                {
+                    camera->bind(task_render);
+
+                    const auto begin{task_count == 0 ? 0 : std::size(entities) * task / task_count};
+                    const auto end  {task_count == 0 ? 0 : std::size(entities) * (task + 1) / task_count};
+
+                    for(auto i{begin}; i < end; ++i)
+                    {
+                        auto& drawable{drawables.template get<Drawable>(entities[i])};
+
+                        if(drawable)
+                        {
+                            drawable.apply([&camera, &task_transfer, &task_render](auto& renderable)
+                            {
+                                if(!renderable.hidden())
+                                {
+                                    renderable.upload(task_transfer);
+                                    renderable.draw(task_render, *camera);
+                                }
+                            });
+                        }
+                    }
+                });
+            }
+            else
+            {
+                for(const auto entity : entities)
+                {
+                    auto& drawable{drawables.template get<Drawable>(entity)};
+
+                    if(drawable)
+                    {
+                        drawable.apply([&transfer](auto& renderable)
+                        {
+                            if(!renderable.hidden())
+                            {
+                                renderable.upload(transfer);
+                            }
+                        });
+                    }
+                }
+            }
+        }
+    });
+}
+
+template<components::drawable_specialization Drawable = components::drawable>
+void batched_render(entt::registry& world, render_batch& batch, cpt::begin_render_options options = cpt::begin_render_options::none)
+{
+    prepare_render<Drawable>(world);
+
+    world.view<components::camera>().each([&world, &batch, options](components::camera& camera)
+    {
+        if(camera)
+        {
+            auto render  {camera->target().begin_render(options)};
+            auto transfer{engine::instance().begin_transfer()};
+
+            camera->upload(transfer);
+
+            if(render)
+            {
+                camera->bind(*render);
+
+                const auto flush = [&camera, &transfer, &render, &batch]()
+                {
+                    batch.upload(transfer);
+                    batch.draw(*render, *camera);
+                };
+
+                world.view<Drawable>().each([&camera, &transfer, &render, &batch, &flush](Drawable& drawable)
+                {
+                    if(drawable)
+                    {
+                        drawable.apply([&camera, &transfer, &render, &batch, &flush](auto& renderable)
+                        {
+                            using renderable_type = std::decay_t<decltype(renderable)>;
+
+                            if(!renderable.hidden())
+                            {
+                                if constexpr(std::is_base_of_v<basic_renderable, renderable_type>)
+                                {
+                                    batch.add(renderable);
+                                }
+                                else //Not batchable, keep draw order
+                                {
+                                    flush();
+
+                                    renderable.upload(transfer);
+                                    renderable.draw(*render, *camera);
+                                }
+                            }
+                        });
+                    }
+                });
+
+                flush();
+            }
+        }
+    });
+}
+
 }
 
 #endif
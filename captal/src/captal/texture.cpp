@@ -22,6 +22,12 @@
 
 #include "texture.hpp"
 
+#include <cstring>
+#include <iterator>
+#include <array>
+#include <mutex>
+#include <condition_variable>
+
 #include "engine.hpp"
 
 namespace cpt
@@ -48,26 +54,12 @@ static tph::texture_format format_from_color_space(color_space space) noexcept
     }
 }
 
-template<typename... Args>
-static tph::image make_image(Args&&... args)
+//Records the layout transitions around copy, that writes all levels of the texture
+template<typename Copy>
+static void record_texture_upload(tph::command_buffer& buffer, texture& texture, Copy&& copy)
 {
-    tph::image output{engine::instance().device(), std::forward<Args>(args)..., tph::image_usage::transfer_src};
-
-#ifdef CAPTAL_DEBUG
-    tph::set_object_name(engine::instance().device(), output, "transfer image");
-#endif
-
-    return output;
-}
-
-static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::texture_format format, tph::image image)
-{
-    const tph::texture_info info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_dest};
-    texture_ptr texture{make_texture(sampling, static_cast<std::uint32_t>(image.width()), static_cast<std::uint32_t>(image.height()), info)};
-
-    auto&& [buffer, signal, keeper] = cpt::engine::instance().begin_transfer();
-
-    tph::texture_memory_barrier barrier{texture->get_texture()};
+    tph::texture_memory_barrier barrier{texture.get_texture()};
+    barrier.subresource.mip_level_count = texture.get_texture().mip_levels();
     barrier.src_access  = tph::resource_access::none;
     barrier.dest_access = tph::resource_access::transfer_write;
     barrier.old_layout  = tph::texture_layout::undefined;
@@ -75,11 +67,7 @@ static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::tex
 
     tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::top_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
 
-    tph::image_texture_copy region{};
-    region.texture_size.width  = static_cast<std::uint32_t>(image.width());
-    region.texture_size.height = static_cast<std::uint32_t>(image.height());
-
-    tph::cmd::copy(buffer, image, texture->get_texture(), region);
+    copy();
 
     barrier.src_access  = tph::resource_access::transfer_write;
     barrier.dest_access = tph::resource_access::shader_read;
@@ -87,6 +75,185 @@ static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::tex
     barrier.new_layout  = tph::texture_layout::shader_read_only_optimal;
 
     tph::cmd::pipeline_barrier(buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+}
+
+struct texture_level
+{
+    std::uint32_t width{};
+    std::uint32_t height{};
+    const std::uint8_t* data{};
+    std::uint64_t size{};
+};
+
+//Copies the levels, in order, through the engine's staging ring, instead of a buffer created for each texture
+//Levels are not streamed (smallest first, then making finer levels visible as they arrive) yet, because:
+//- make_descriptor_write (binding.hpp) writes the texture's sampler and view in descriptor sets when a renderable binds it,
+//  and nothing tracks these sets, so a new sampler (with a lower min_lod) or view (with a wider level range) can not reach them.
+//- tph::sampler and tph::texture_view are immutable, so the level range can not be changed in place either.
+//- The view covers every level, so levels not uploaded yet would have to be transitioned to shader_read_only_optimal first.
+//Streaming needs a registry of the descriptor sets that use a texture (rewritten at frame boundaries), or update-after-bind descriptors.
+static void upload_texture_levels(memory_transfer_info transfer, texture& texture, std::span<const texture_level> levels)
+{
+    constexpr auto alignment{memory_transfer_scheduler::default_staging_alignment};
+
+    std::uint64_t total_size{};
+    for(auto&& level : levels)
+    {
+        total_size = align_up(total_size, alignment) + level.size;
+    }
+
+    const auto staging{engine::instance().transfer_scheduler().allocate_staging(transfer, total_size)};
+
+    std::vector<tph::buffer_texture_copy> regions{};
+    regions.reserve(std::size(levels));
+
+    std::uint64_t offset{};
+    for(std::size_t i{}; i < std::size(levels); ++i)
+    {
+        offset = align_up(offset, alignment);
+        std::memcpy(staging.map + offset, levels[i].data, levels[i].size);
+
+        auto& region{regions.emplace_back()};
+        region.buffer_offset = staging.offset + offset;
+        region.texture_subresource.mip_level = static_cast<std::uint32_t>(i);
+        region.texture_size.width  = levels[i].width;
+        region.texture_size.height = levels[i].height;
+
+        offset += levels[i].size;
+    }
+
+    record_texture_upload(transfer.buffer, texture, [&]()
+    {
+        tph::cmd::copy(transfer.buffer, *staging.buffer, texture.get_texture(), regions);
+    });
+}
+
+static tph::sampler_info mipmapped_sampling(tph::sampler_info sampling, std::uint32_t levels) noexcept
+{
+    //A max_lod of 0 restricts sampling to the first level
+    if(levels > 1 && sampling.max_lod == 0.0f)
+    {
+        sampling.max_lod = static_cast<float>(levels);
+    }
+
+    return sampling;
+}
+
+static texture_ptr make_texture_impl(memory_transfer_info transfer, const tph::sampler_info& sampling, tph::texture_format format, std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, texture_mipmaps mipmaps)
+{
+    constexpr auto blit_features{tph::format_feature::blit_src | tph::format_feature::blit_dest | tph::format_feature::sampled_image_filter_linear};
+
+    const std::uint32_t levels{mipmaps == texture_mipmaps::none ? 1 : tph::mip_level_count(width, height)};
+    const bool blit{levels > 1 && mipmaps == texture_mipmaps::automatic && engine::instance().graphics_device().support_texture_format(format, blit_features)};
+
+    auto usage{tph::texture_usage::sampled | tph::texture_usage::transfer_dest};
+    if(blit)
+    {
+        usage |= tph::texture_usage::transfer_src;
+    }
+
+    texture_ptr texture{make_texture(mipmapped_sampling(sampling, levels), width, height, tph::texture_info{format, usage, levels})};
+
+    //Kept first, so the texture outlives the transfer even if recording fails
+    transfer.keeper.keep(texture);
+
+    const std::uint64_t size{static_cast<std::uint64_t>(width) * height * 4};
+
+    if(levels == 1)
+    {
+        const texture_level level{width, height, rgba, size};
+
+        upload_texture_levels(transfer, *texture, std::span{&level, 1});
+    }
+    else if(blit)
+    {
+        const auto staging{engine::instance().transfer_scheduler().allocate_staging(transfer, size)};
+        std::memcpy(staging.map, rgba, size);
+
+        tph::texture_memory_barrier barrier{texture->get_texture()};
+        barrier.src_access  = tph::resource_access::none;
+        barrier.dest_access = tph::resource_access::transfer_write;
+        barrier.old_layout  = tph::texture_layout::undefined;
+        barrier.new_layout  = tph::texture_layout::transfer_dest_optimal;
+
+        tph::cmd::pipeline_barrier(transfer.buffer, tph::pipeline_stage::top_of_pipe, tph::pipeline_stage::transfer, tph::dependency_flags::none, {}, {}, std::span{&barrier, 1});
+
+        tph::buffer_texture_copy region{};
+        region.buffer_offset = staging.offset;
+        region.texture_size.width  = width;
+        region.texture_size.height = height;
+
+        tph::cmd::copy(transfer.buffer, *staging.buffer, texture->get_texture(), region);
+
+        //Each level is blitted from the previous one, then all of them end in shader_read_only_optimal
+        tph::mipmap_generation_info info{texture->get_texture()};
+        info.src_access  = tph::resource_access::transfer_write;
+        info.dest_access = tph::resource_access::shader_read;
+        info.old_layout  = tph::texture_layout::transfer_dest_optimal;
+        info.new_layout  = tph::texture_layout::shader_read_only_optimal;
+
+        tph::cmd::generate_mipmaps(transfer.buffer, tph::pipeline_stage::transfer, tph::pipeline_stage::fragment_shader, tph::dependency_flags::none, std::span{&info, 1});
+    }
+    else
+    {
+        const auto chain{tph::generate_mipmaps(width, height, std::span{rgba, static_cast<std::size_t>(size)})};
+
+        std::vector<texture_level> uploads{};
+        uploads.reserve(levels);
+        uploads.emplace_back(texture_level{width, height, rgba, size});
+
+        for(auto&& level : chain)
+        {
+            uploads.emplace_back(texture_level{level.width, level.height, std::data(level.pixels), std::size(level.pixels)});
+        }
+
+        upload_texture_levels(transfer, *texture, uploads);
+    }
+
+    return texture;
+}
+
+static texture_ptr make_texture_impl(memory_transfer_info transfer, const tph::sampler_info& sampling, const tph::texture_file_data& file)
+{
+    if(!engine::instance().graphics_device().support_texture_format(file.format, tph::format_feature::sampled_image | tph::format_feature::transfer_dest))
+    {
+        throw std::runtime_error{"Texture format is not supported by the device."};
+    }
+
+    const auto levels{static_cast<std::uint32_t>(std::size(file.levels))};
+    const tph::texture_info info{file.format, tph::texture_usage::sampled | tph::texture_usage::transfer_dest, levels};
+
+    texture_ptr texture{make_texture(mipmapped_sampling(sampling, levels), file.width, file.height, info)};
+    transfer.keeper.keep(texture);
+
+    std::vector<texture_level> uploads{};
+    uploads.reserve(levels);
+
+    for(auto&& level : file.levels)
+    {
+        uploads.emplace_back(texture_level{level.width, level.height, std::data(file.data) + level.offset, level.size});
+    }
+
+    upload_texture_levels(transfer, *texture, uploads);
+
+    return texture;
+}
+
+static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::texture_format format, tph::image image)
+{
+    const tph::texture_info info{format, tph::texture_usage::sampled | tph::texture_usage::transfer_dest};
+    texture_ptr texture{make_texture(sampling, static_cast<std::uint32_t>(image.width()), static_cast<std::uint32_t>(image.height()), info)};
+
+    auto&& [buffer, signal, keeper] = cpt::engine::instance().begin_transfer();
+
+    record_texture_upload(buffer, *texture, [&]()
+    {
+        tph::image_texture_copy region{};
+        region.texture_size.width  = static_cast<std::uint32_t>(image.width());
+        region.texture_size.height = static_cast<std::uint32_t>(image.height());
+
+        tph::cmd::copy(buffer, image, texture->get_texture(), region);
+    });
 
     signal.connect([image = std::move(image)](){});
     keeper.keep(texture);
@@ -94,24 +261,41 @@ static texture_ptr make_texture_impl(const tph::sampler_info& sampling, tph::tex
     return texture;
 }
 
-texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
+{
+    return make_texture(read_file<std::vector<std::uint8_t>>(file), sampling, space, mipmaps);
+}
+
+texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(file));
+    if(tph::is_texture_file(data))
+    {
+        return make_texture(tph::decode_texture_file(data), sampling);
+    }
+
+    return make_texture(tph::decode_image(data), sampling, space, mipmaps);
 }
 
-texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(data));
+    const std::vector<std::uint8_t> data{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+
+    return make_texture(data, sampling, space, mipmaps);
 }
 
-texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(stream));
+    return make_texture_impl(engine::instance().begin_transfer(), sampling, format_from_color_space(space), width, height, rgba, mipmaps);
 }
 
-texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling, color_space space)
+texture_ptr make_texture(const tph::image_data& image, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
 {
-    return make_texture_impl(sampling, format_from_color_space(space), make_image(width, height, rgba));
+    return make_texture_impl(engine::instance().begin_transfer(), sampling, format_from_color_space(space), image.width, image.height, std::data(image.pixels), mipmaps);
+}
+
+texture_ptr make_texture(const tph::texture_file_data& file, const tph::sampler_info& sampling)
+{
+    return make_texture_impl(engine::instance().begin_transfer(), sampling, file);
 }
 
 texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling, color_space space)
@@ -124,6 +308,458 @@ tph::device& texture::get_device() noexcept
     return engine::instance().device();
 }
 
+struct texture_load_state
+{
+    std::filesystem::path path{};
+    tph::sampler_info sampling{};
+    color_space space{};
+    texture_mipmaps mipmaps{};
+    std::uint64_t sequence{};
+    std::atomic<std::int32_t> priority{};
+    std::atomic<texture_load_status> status{texture_load_status::pending};
+
+    std::mutex mutex{};
+    texture_ptr texture{};
+    bool completed{};
+    std::vector<std::weak_ptr<texture_load_request>> requests{};
+    std::size_t active_requests{}; //Requests that have not been cancelled
+    bool abandoned{}; //Every request has been cancelled, the load is being cancelled and does not take new requests
+};
+
+struct texture_load_request
+{
+    std::shared_ptr<texture_load_state> state{};
+    std::atomic<bool> cancelled{};
+
+    //Guarded by the mutex of the state
+    texture_ptr texture{};
+    std::vector<texture_load_callback> callbacks{};
+    bool completed{};
+    std::promise<texture_ptr> promise{};
+    std::shared_future<texture_ptr> future{promise.get_future().share()};
+};
+
+//Returns nullptr if the load has been completed or abandoned, the caller must then begin a new one
+static std::shared_ptr<texture_load_request> add_request(const std::shared_ptr<texture_load_state>& state)
+{
+    auto output{std::make_shared<texture_load_request>()};
+    output->state = state;
+
+    std::lock_guard lock{state->mutex};
+
+    if(state->completed || state->abandoned)
+    {
+        return nullptr;
+    }
+
+    state->requests.emplace_back(output);
+    ++state->active_requests;
+
+    return output;
+}
+
+static void complete_request(texture_load_request& request, texture_ptr texture, std::exception_ptr exception)
+{
+    std::unique_lock lock{request.state->mutex};
+
+    if(request.completed)
+    {
+        return; //cancelled
+    }
+
+    request.texture = texture;
+    request.completed = true;
+    auto callbacks{std::move(request.callbacks)};
+    request.callbacks.clear();
+    lock.unlock();
+
+    if(exception)
+    {
+        request.promise.set_exception(exception);
+    }
+    else
+    {
+        request.promise.set_value(texture);
+    }
+
+    for(auto& callback : callbacks)
+    {
+        callback(texture);
+    }
+}
+
+//Only the thread that made the transition to a final status calls this, so the requests are completed only once
+static void complete_load(texture_load_state& state, texture_ptr texture, std::exception_ptr exception = nullptr)
+{
+    std::unique_lock lock{state.mutex};
+    state.texture = texture;
+    state.completed = true;
+    auto requests{std::move(state.requests)};
+    state.requests.clear();
+    lock.unlock();
+
+    for(auto& weak_request : requests)
+    {
+        if(const auto request{weak_request.lock()}; request)
+        {
+            complete_request(*request, texture, exception);
+        }
+    }
+}
+
+static bool is_final(texture_load_status status) noexcept
+{
+    return status == texture_load_status::ready || status == texture_load_status::cancelled || status == texture_load_status::failed;
+}
+
+static bool cancel_load(texture_load_state& state)
+{
+    auto status{state.status.load(std::memory_order_acquire)};
+
+    while(!is_final(status))
+    {
+        if(state.status.compare_exchange_weak(status, texture_load_status::cancelled, std::memory_order_acq_rel))
+        {
+            complete_load(state, nullptr);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void cancel_request(texture_load_request& request)
+{
+    auto& state{*request.state};
+
+    std::unique_lock lock{state.mutex};
+
+    if(request.completed)
+    {
+        return;
+    }
+
+    request.completed = true;
+    request.cancelled.store(true, std::memory_order_release);
+    auto callbacks{std::move(request.callbacks)};
+    request.callbacks.clear();
+
+    const bool last{--state.active_requests == 0 && !state.completed};
+    if(last)
+    {
+        state.abandoned = true;
+    }
+
+    lock.unlock();
+
+    if(last)
+    {
+        cancel_load(state);
+    }
+
+    request.promise.set_value(nullptr);
+
+    for(auto& callback : callbacks)
+    {
+        callback(nullptr);
+    }
+}
+
+static bool same_sampling(const tph::sampler_info& left, const tph::sampler_info& right) noexcept
+{
+    return left.mag_filter == right.mag_filter
+        && left.min_filter == right.min_filter
+        && left.mipmap_mode == right.mipmap_mode
+        && left.address_mode == right.address_mode
+        && left.border_color == right.border_color
+        && left.mip_lod_bias == right.mip_lod_bias
+        && left.anisotropy_level == right.anisotropy_level
+        && left.compare == right.compare
+        && left.compare_op == right.compare_op
+        && left.min_lod == right.min_lod
+        && left.max_lod == right.max_lod
+        && left.unnormalized_coordinates == right.unnormalized_coordinates;
+}
+
+class texture_loader
+{
+public:
+    explicit texture_loader(std::size_t worker_count)
+    {
+        m_threads.reserve(worker_count);
+        for(std::size_t i{}; i < worker_count; ++i)
+        {
+            m_threads.emplace_back(&texture_loader::worker, this);
+        }
+    }
+
+    ~texture_loader()
+    {
+        std::unique_lock lock{m_mutex};
+        m_exit = true;
+        auto queue{std::move(m_queue)};
+        lock.unlock();
+
+        m_condition.notify_all();
+
+        for(auto& thread : m_threads)
+        {
+            thread.join();
+        }
+
+        for(auto& state : queue)
+        {
+            cancel_load(*state);
+        }
+    }
+
+    texture_loader(const texture_loader&) = delete;
+    texture_loader& operator=(const texture_loader&) = delete;
+    texture_loader(texture_loader&&) noexcept = delete;
+    texture_loader& operator=(texture_loader&&) noexcept = delete;
+
+    void push(std::shared_ptr<texture_load_state> state)
+    {
+        std::unique_lock lock{m_mutex};
+        state->sequence = m_sequence++;
+        m_queue.emplace_back(std::move(state));
+        lock.unlock();
+
+        m_condition.notify_one();
+    }
+
+private:
+    std::shared_ptr<texture_load_state> next()
+    {
+        std::unique_lock lock{m_mutex};
+        m_condition.wait(lock, [this]()
+        {
+            return m_exit || !std::empty(m_queue);
+        });
+
+        if(m_exit)
+        {
+            return nullptr;
+        }
+
+        //Priorities may change while in the queue, so it is not kept sorted
+        const auto compare = [](const std::shared_ptr<texture_load_state>& left, const std::shared_ptr<texture_load_state>& right)
+        {
+            const auto left_priority {left->priority.load(std::memory_order_relaxed)};
+            const auto right_priority{right->priority.load(std::memory_order_relaxed)};
+
+            return left_priority < right_priority || (left_priority == right_priority && left->sequence > right->sequence);
+        };
+
+        const auto it{std::max_element(std::begin(m_queue), std::end(m_queue), compare)};
+        auto output{std::move(*it)};
+        m_queue.erase(it);
+
+        return output;
+    }
+
+    void worker()
+    {
+        while(auto state{next()})
+        {
+            auto expected{texture_load_status::pending};
+            if(!state->status.compare_exchange_strong(expected, texture_load_status::decoding, std::memory_order_acq_rel))
+            {
+                continue; //cancelled
+            }
+
+            try
+            {
+                auto data{read_file<std::vector<std::uint8_t>>(state->path)};
+
+                //KTX2 and DDS files are uploaded as they are, with their own levels
+                if(tph::is_texture_file(data))
+                {
+                    auto file{std::make_shared<tph::texture_file_data>(tph::decode_texture_file(std::move(data)))};
+                    const auto size{static_cast<std::uint64_t>(std::size(file->data))};
+
+                    upload(state, size, [state, file = std::move(file)](memory_transfer_info transfer)
+                    {
+                        return make_texture_impl(transfer, state->sampling, *file);
+                    });
+                }
+                else
+                {
+                    auto image{std::make_shared<tph::image_data>(tph::decode_image(data))};
+                    const auto size{static_cast<std::uint64_t>(std::size(image->pixels))};
+
+                    upload(state, size, [state, image = std::move(image)](memory_transfer_info transfer)
+                    {
+                        return make_texture_impl(transfer, state->sampling, format_from_color_space(state->space), image->width, image->height, std::data(image->pixels), state->mipmaps);
+                    });
+                }
+            }
+            catch(...)
+            {
+                auto status{state->status.load(std::memory_order_acquire)};
+
+                while(!is_final(status))
+                {
+                    if(state->status.compare_exchange_weak(status, texture_load_status::failed, std::memory_order_acq_rel))
+                    {
+                        complete_load(*state, nullptr, std::current_exception());
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename Make>
+    static void upload(const std::shared_ptr<texture_load_state>& state, std::uint64_t size, Make&& make)
+    {
+        auto expected{texture_load_status::decoding};
+        if(!state->status.compare_exchange_strong(expected, texture_load_status::uploading, std::memory_order_acq_rel))
+        {
+            return;
+        }
+
+        engine::instance().transfer_scheduler().schedule_upload(size, [state, make = std::forward<Make>(make)](memory_transfer_info transfer)
+        {
+            if(state->status.load(std::memory_order_acquire) != texture_load_status::uploading)
+            {
+                return;
+            }
+
+            texture_ptr texture{};
+
+            try
+            {
+                texture = make(transfer);
+
+#ifdef CAPTAL_DEBUG
+                texture->set_name(convert_to<narrow>(state->path.u8string()));
+#endif
+            }
+            catch(...)
+            {
+                auto expected{texture_load_status::uploading};
+                if(state->status.compare_exchange_strong(expected, texture_load_status::failed, std::memory_order_acq_rel))
+                {
+                    complete_load(*state, nullptr, std::current_exception());
+                }
+
+                return;
+            }
+
+            auto expected{texture_load_status::uploading};
+            if(state->status.compare_exchange_strong(expected, texture_load_status::ready, std::memory_order_acq_rel))
+            {
+                complete_load(*state, std::move(texture));
+            }
+        });
+    }
+
+private:
+    std::vector<std::thread> m_threads{};
+    std::vector<std::shared_ptr<texture_load_state>> m_queue{};
+    std::uint64_t m_sequence{};
+    std::mutex m_mutex{};
+    std::condition_variable m_condition{};
+    bool m_exit{};
+};
+
+texture_handle::texture_handle(std::shared_ptr<texture_load_request> request, texture_ptr placeholder) noexcept
+:m_request{std::move(request)}
+,m_placeholder{std::move(placeholder)}
+{
+
+}
+
+texture_ptr texture_handle::get() const
+{
+    if(m_request)
+    {
+        std::unique_lock lock{m_request->state->mutex};
+
+        if(m_request->texture)
+        {
+            return m_request->texture;
+        }
+    }
+
+    return m_placeholder;
+}
+
+texture_load_status texture_handle::status() const noexcept
+{
+    if(!m_request || m_request->cancelled.load(std::memory_order_acquire))
+    {
+        return texture_load_status::cancelled;
+    }
+
+    return m_request->state->status.load(std::memory_order_acquire);
+}
+
+bool texture_handle::ready() const noexcept
+{
+    return status() == texture_load_status::ready;
+}
+
+void texture_handle::set_priority(std::int32_t priority) noexcept
+{
+    if(m_request)
+    {
+        m_request->state->priority.store(priority, std::memory_order_relaxed);
+    }
+}
+
+std::int32_t texture_handle::priority() const noexcept
+{
+    return m_request ? m_request->state->priority.load(std::memory_order_relaxed) : 0;
+}
+
+void texture_handle::cancel()
+{
+    if(m_request)
+    {
+        cancel_request(*m_request);
+    }
+}
+
+void texture_handle::on_completion(texture_load_callback callback)
+{
+    if(!m_request)
+    {
+        callback(nullptr);
+
+        return;
+    }
+
+    std::unique_lock lock{m_request->state->mutex};
+
+    if(!m_request->completed)
+    {
+        m_request->callbacks.emplace_back(std::move(callback));
+    }
+    else
+    {
+        auto texture{m_request->texture};
+        lock.unlock();
+
+        callback(texture);
+    }
+}
+
+std::shared_future<texture_ptr> texture_handle::future() const
+{
+    if(!m_request)
+    {
+        std::promise<texture_ptr> cancelled{};
+        cancelled.set_value(nullptr);
+
+        return cancelled.get_future().share();
+    }
+
+    return m_request->future;
+}
+
 
 cpt::texture_ptr texture_pool::default_load_callback(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space)
 {
@@ -138,12 +774,14 @@ cpt::texture_ptr texture_pool::default_load_callback(const std::filesystem::path
 
 texture_pool::texture_pool()
 :m_load_callback{default_load_callback}
+,m_worker_count{default_worker_count()}
 {
 
 }
 
-texture_pool::texture_pool(load_callback_t load_callback)
+texture_pool::texture_pool(load_callback_t load_callback, std::size_t worker_count)
 :m_load_callback{std::move(load_callback)}
+,m_worker_count{worker_count}
 {
 
 }
@@ -155,6 +793,8 @@ cpt::texture_ptr texture_pool::load(const std::filesystem::path& path, const tph
 
 cpt::texture_ptr texture_pool::load(const std::filesystem::path& path, const load_callback_t& load_callback, const tph::sampler_info& sampling, color_space space)
 {
+    collect();
+
     const auto it{m_pool.find(path)};
     if(it != std::end(m_pool))
     {
@@ -175,6 +815,106 @@ cpt::texture_weak_ptr texture_pool::weak_load(const std::filesystem::path& path)
     return cpt::texture_weak_ptr{};
 }
 
+texture_handle texture_pool::load_async(const std::filesystem::path& path, std::int32_t priority, const tph::sampler_info& sampling, color_space space, texture_mipmaps mipmaps)
+{
+    collect();
+
+    if(!m_placeholder)
+    {
+        constexpr std::array<std::uint8_t, 4> white{255, 255, 255, 255};
+
+        m_placeholder = make_texture(1, 1, std::data(white), tph::sampler_info{}, color_space::linear);
+
+#ifdef CAPTAL_DEBUG
+        m_placeholder->set_name("cpt::texture_pool's placeholder");
+#endif
+    }
+
+    //Already loaded, the handle is ready
+    if(const auto it{m_pool.find(path)}; it != std::end(m_pool))
+    {
+        auto state{std::make_shared<texture_load_state>()};
+        state->path = path;
+        state->status.store(texture_load_status::ready, std::memory_order_relaxed);
+
+        auto request{add_request(state)};
+        complete_load(*state, it->second);
+
+        return texture_handle{std::move(request), m_placeholder};
+    }
+
+    //Already loading with the same parameters, the most important request wins
+    const auto [first, last]{m_loading.equal_range(path)};
+    for(auto it{first}; it != last; ++it)
+    {
+        const auto& state{it->second};
+
+        if(!same_sampling(state->sampling, sampling) || state->space != space || state->mipmaps != mipmaps)
+        {
+            continue;
+        }
+
+        if(auto request{add_request(state)}; request)
+        {
+            auto& current{state->priority};
+
+            for(auto value{current.load(std::memory_order_relaxed)}; value < priority;)
+            {
+                if(current.compare_exchange_weak(value, priority, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+
+            return texture_handle{std::move(request), m_placeholder};
+        }
+    }
+
+    if(!m_loader)
+    {
+        m_loader = std::make_shared<texture_loader>(m_worker_count);
+    }
+
+    auto state{std::make_shared<texture_load_state>()};
+    state->path = path;
+    state->sampling = sampling;
+    state->space = space;
+    state->mipmaps = mipmaps;
+    state->priority.store(priority, std::memory_order_relaxed);
+
+    auto request{add_request(state)};
+
+    m_loading.emplace(path, state);
+    m_loader->push(std::move(state));
+
+    return texture_handle{std::move(request), m_placeholder};
+}
+
+void texture_pool::collect()
+{
+    auto it{std::begin(m_loading)};
+    while(it != std::end(m_loading))
+    {
+        std::unique_lock lock{it->second->mutex};
+
+        if(it->second->completed)
+        {
+            //Cancelled and failed requests do not have a texture
+            if(it->second->texture)
+            {
+                m_pool.emplace(it->first, it->second->texture);
+            }
+
+            lock.unlock();
+            it = m_loading.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
 std::pair<cpt::texture_ptr, bool> texture_pool::emplace(std::filesystem::path path, texture_ptr texture)
 {
     auto [it, success] = m_pool.emplace(std::make_pair(std::move(path), std::move(texture)));
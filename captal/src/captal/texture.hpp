@@ -31,9 +31,14 @@
 #include <istream>
 #include <memory>
 #include <functional>
+#include <future>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 
 #include <tephra/image.hpp>
 #include <tephra/texture.hpp>
+#include <tephra/texture_file.hpp>
 
 #include <captal_foundation/math.hpp>
 
@@ -48,6 +53,13 @@ enum class color_space : std::uint32_t
     linear = 1
 };
 
+enum class texture_mipmaps : std::uint32_t
+{
+    none = 0,
+    automatic = 1, //Blits on the GPU if the format supports it, uses the CPU box filter otherwise
+    cpu = 2,       //Always uses the CPU box filter, see tph::generate_mipmaps
+};
+
 class CAPTAL_API texture : public asynchronous_resource
 {
 public:
@@ -202,15 +214,87 @@ using texture_weak_ptr = std::weak_ptr<texture>;
 template<typename... Args> requires std::constructible_from<texture, Args...>
 texture_ptr make_texture(Args&&... args)
 {
-    return std::make_shared<texture>(std::forward<Args>(args)...);
+    return make_asynchronous_resource<texture>(std::forward<Args>(args)...);
 }
 
-CAPTAL_API texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
-CAPTAL_API texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
+//Texture files (KTX2 or DDS, see tph::decode_texture_file) are recognised by their content, they keep their own format and mip levels.
+//Mip levels are sampled only if sampling.max_lod is not 0, a max_lod of 0 is raised to the number of levels when mipmaps are generated.
+CAPTAL_API texture_ptr make_texture(const std::filesystem::path& file, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+CAPTAL_API texture_ptr make_texture(std::span<const std::uint8_t> data, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+CAPTAL_API texture_ptr make_texture(std::istream& stream, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+CAPTAL_API texture_ptr make_texture(std::uint32_t width, std::uint32_t height, const std::uint8_t* rgba, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+CAPTAL_API texture_ptr make_texture(const tph::image_data& image, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+CAPTAL_API texture_ptr make_texture(const tph::texture_file_data& file, const tph::sampler_info& sampling = tph::sampler_info{});
 CAPTAL_API texture_ptr make_texture(tph::image&& image, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb);
 
+enum class texture_load_status : std::uint32_t
+{
+    pending = 0,   //Waiting for a worker
+    decoding = 1,
+    uploading = 2, //Decoded, waiting for the transfer scheduler's upload budget
+    ready = 3,
+    cancelled = 4,
+    failed = 5,
+};
+
+//Called with the loaded texture, or nullptr if the load has been cancelled or has failed.
+using texture_load_callback = std::function<void(const texture_ptr& texture)>;
+
+struct texture_load_state;
+struct texture_load_request;
+class texture_loader;
+
+//Handle on a texture loaded by texture_pool::load_async.
+//Copies of a handle share the same request. Requests of the same path with the same parameters share the same load.
+//An empty handle (default constructed or moved from) behaves as a cancelled request.
+class CAPTAL_API texture_handle
+{
+public:
+    texture_handle() = default;
+    explicit texture_handle(std::shared_ptr<texture_load_request> request, texture_ptr placeholder) noexcept;
+
+    ~texture_handle() = default;
+    texture_handle(const texture_handle&) = default;
+    texture_handle& operator=(const texture_handle&) = default;
+    texture_handle(texture_handle&&) noexcept = default;
+    texture_handle& operator=(texture_handle&&) noexcept = default;
+
+    //The loaded texture once ready, the placeholder otherwise
+    texture_ptr get() const;
+    texture_load_status status() const noexcept;
+    bool ready() const noexcept;
+
+    //Requests with the highest priority are decoded first, it can be changed until a worker begins to decode it
+    void set_priority(std::int32_t priority) noexcept;
+    std::int32_t priority() const noexcept;
+
+    //Cancels the request for all copies of this handle, does nothing if it has already been completed.
+    //The future gets nullptr and callbacks are called from this thread.
+    //The load itself is cancelled once every request sharing it has been cancelled.
+    void cancel();
+
+    //callback is called from the thread that calls engine::submit_transfers for successful loads,
+    //or immediately if the request has already been completed.
+    void on_completion(texture_load_callback callback);
+
+    //Gets nullptr if the request has been cancelled, rethrows the exception thrown by decoding if it has failed
+    std::shared_future<texture_ptr> future() const;
+
+    const texture_ptr& placeholder() const noexcept
+    {
+        return m_placeholder;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return static_cast<bool>(m_request);
+    }
+
+private:
+    std::shared_ptr<texture_load_request> m_request{};
+    texture_ptr m_placeholder{};
+};
+
 class CAPTAL_API texture_pool
 {
     struct path_hash
@@ -227,9 +311,14 @@ public:
 public:
     using load_callback_t = std::function<cpt::texture_ptr(const std::filesystem::path& path, const tph::sampler_info& sampling, color_space space)>;
 
+    static std::size_t default_worker_count() noexcept
+    {
+        return std::max(std::thread::hardware_concurrency() / 2u, 1u);
+    }
+
 public:
     texture_pool();
-    explicit texture_pool(load_callback_t load_callback);
+    explicit texture_pool(load_callback_t load_callback, std::size_t worker_count = default_worker_count());
 
     ~texture_pool() = default;
     texture_pool(const texture_pool&) = delete;
@@ -242,6 +331,29 @@ public:
     cpt::texture_weak_ptr weak_load(const std::filesystem::path& path) const;
     std::pair<cpt::texture_ptr, bool> emplace(std::filesystem::path path, texture_ptr texture);
 
+    //Returns immediately, the file is decoded by the pool's workers then uploaded through engine's transfer scheduler with schedule_upload.
+    //All mip levels are uploaded together, the texture is not streamed level by level (see upload_texture_levels in texture.cpp).
+    //Loads of a path that is already loading with the same sampling, color space and mipmaps share the same load, others get their own.
+    //As with load, a path that is already in the pool gets the pooled texture whatever the parameters are,
+    //and only the first texture loaded for a path is moved to the pool.
+    //The load callback is not used, files are decoded by tph::decode_image or tph::decode_texture_file.
+    texture_handle load_async(const std::filesystem::path& path, std::int32_t priority = 0, const tph::sampler_info& sampling = tph::sampler_info{}, color_space space = color_space::srgb, texture_mipmaps mipmaps = texture_mipmaps::none);
+
+    //Moves the textures loaded asynchronously to the pool, and forgets cancelled and failed requests.
+    //Called by load and load_async.
+    void collect();
+
+    //Texture returned by handles that are not ready, a 1x1 white texture by default
+    void set_placeholder(texture_ptr placeholder) noexcept
+    {
+        m_placeholder = std::move(placeholder);
+    }
+
+    const texture_ptr& placeholder() const noexcept
+    {
+        return m_placeholder;
+    }
+
     void clear(std::size_t threshold = 1);
 
     template<typename Predicate>
@@ -277,6 +389,10 @@ public:
 private:
     std::unordered_map<std::filesystem::path, texture_ptr, path_hash> m_pool{};
     load_callback_t m_load_callback{};
+    std::unordered_multimap<std::filesystem::path, std::shared_ptr<texture_load_state>, path_hash> m_loading{};
+    std::shared_ptr<texture_loader> m_loader{};
+    std::size_t m_worker_count{};
+    texture_ptr m_placeholder{};
 };
 
 class CAPTAL_API tileset
@@ -1,5 +1,7 @@
 #include "uniform_buffer.hpp"
 
+#include <cassert>
+
 #include <tephra/commands.hpp>
 
 #include "engine.hpp"
@@ -8,15 +10,15 @@ namespace cpt
 {
 
 uniform_buffer::uniform_buffer(const buffer_part& part)
-:m_parts{buffer_part_info{0, part.size}}
-,m_buffer{engine::instance().uniform_pool().allocate(part.size, engine::instance().graphics_device().limits().min_uniform_buffer_alignment)}
+:m_parts{buffer_part_info{0, part.size, part.type}}
+,m_buffer{engine::instance().uniform_pool().allocate(part.size, buffer_alignment())}
 {
 
 }
 
 uniform_buffer::uniform_buffer(std::span<const buffer_part> parts)
 :m_parts{compute_part_info(parts)}
-,m_buffer{engine::instance().uniform_pool().allocate(m_parts.back().offset + m_parts.back().size, engine::instance().graphics_device().limits().min_uniform_buffer_alignment)}
+,m_buffer{engine::instance().uniform_pool().allocate(m_parts.back().offset + m_parts.back().size, buffer_alignment())}
 {
 
 }
@@ -31,25 +33,41 @@ void uniform_buffer::upload(std::size_t index)
     m_buffer.upload(m_parts[index].offset, m_parts[index].size);
 }
 
+void uniform_buffer::upload(std::size_t index, std::uint64_t offset, std::uint64_t size)
+{
+    assert(offset + size <= m_parts[index].size && "cpt::uniform_buffer::upload range out of part bounds.");
+
+    m_buffer.upload(m_parts[index].offset + offset, size);
+}
+
+std::uint64_t uniform_buffer::buffer_alignment()
+{
+    const auto& limits{engine::instance().graphics_device().limits()};
+
+    return std::max(limits.min_uniform_buffer_alignment, limits.min_storage_buffer_alignment);
+}
+
 std::vector<uniform_buffer::buffer_part_info> uniform_buffer::compute_part_info(std::span<const buffer_part> parts)
 {
     const std::uint64_t uniform_alignment{engine::instance().graphics_device().limits().min_uniform_buffer_alignment};
+    const std::uint64_t storage_alignment{engine::instance().graphics_device().limits().min_storage_buffer_alignment};
 
     std::vector<uniform_buffer::buffer_part_info> output{};
 
     std::uint64_t offset{};
     for(auto&& part : parts)
     {
-        output.emplace_back(offset, part.size);
-
         if(part.type == buffer_part_type::uniform)
         {
-            offset = align_up(offset, uniform_alignment) + part.size;
+            offset = align_up(offset, uniform_alignment);
         }
-        else
+        else if(part.type == buffer_part_type::storage)
         {
-            offset += part.size;
+            offset = align_up(offset, storage_alignment);
         }
+
+        output.emplace_back(offset, part.size, part.type);
+        offset += part.size;
     }
 
     return output;
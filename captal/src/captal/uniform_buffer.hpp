@@ -43,6 +43,7 @@ enum class buffer_part_type : std::uint32_t
     uniform = 0,
     index = 1,
     vertex = 2,
+    storage = 3,
 };
 
 struct buffer_part
@@ -65,6 +66,7 @@ private:
     {
         std::uint64_t offset{};
         std::uint64_t size{};
+        buffer_part_type type{};
     };
 
 public:
@@ -80,6 +82,7 @@ public:
 
     void upload();
     void upload(std::size_t index);
+    void upload(std::size_t index, std::uint64_t offset, std::uint64_t size);
 
     template<typename T>
     T& get(std::size_t index) noexcept
@@ -103,6 +106,11 @@ public:
         return m_parts[index].size;
     }
 
+    buffer_part_type part_type(std::size_t index) const noexcept
+    {
+        return m_parts[index].type;
+    }
+
     buffer_info get_buffer() noexcept
     {
         return buffer_info{m_buffer.heap().buffer(), m_buffer.offset()};
@@ -114,6 +122,7 @@ public:
     }
 
 private:
+    static std::uint64_t buffer_alignment();
     static std::vector<buffer_part_info> compute_part_info(std::span<const buffer_part> parts);
 
 private:
@@ -127,7 +136,7 @@ using uniform_buffer_weak_ptr = std::weak_ptr<uniform_buffer>;
 template<typename... Args>
 uniform_buffer_ptr make_uniform_buffer(Args&&... args)
 {
-    return std::make_shared<uniform_buffer>(std::forward<Args>(args)...);
+    return make_asynchronous_resource<uniform_buffer>(std::forward<Args>(args)...);
 }
 
 }
@@ -47,18 +47,18 @@ void view::upload(memory_transfer_info info)
 {
     if(std::exchange(m_need_upload, false))
     {
-        auto buffer{std::get<uniform_buffer_ptr>(m_bindings.get(0))};
+        const auto& buffer{std::get<uniform_buffer_ptr>(m_bindings.get(0))};
 
         const auto center{m_position - (m_origin * m_scale)};
         buffer->get<uniform_data>(0).view = look_at(center, center - vec3f{0.0f, 0.0f, 1.0f}, vec3f{0.0f, 1.0f, 0.0f});
         buffer->get<uniform_data>(0).projection = orthographic(0.0f, m_size.x() * m_scale.x(), 0.0f, m_size.y() * m_scale.y(), m_z_near * m_scale.z(), m_z_far * m_scale.z());
 
         buffer->upload();
-        info.keeper.keep(std::move(buffer));
+        info.keeper.keep(buffer);
     }
 }
 
-void view::bind(frame_render_info info)
+void view::update()
 {
     if(std::exchange(m_need_descriptor_update, false))
     {
@@ -100,6 +100,11 @@ void view::bind(frame_render_info info)
 
         tph::write_descriptors(engine::instance().device(), writes);
     }
+}
+
+void view::bind(frame_render_info info)
+{
+    update();
 
     tph::cmd::set_viewport(info.buffer, m_viewport);
     tph::cmd::set_scissor(info.buffer, m_scissor);
@@ -62,6 +62,8 @@ public:
     view& operator=(view&&) noexcept = default;
 
     void upload(memory_transfer_info info);
+    //Updates the descriptor set if needed, bind calls it. Must be called before binding the view on several threads.
+    void update();
     void bind(frame_render_info info);
 
     void fit(std::uint32_t width, std::uint32_t height);
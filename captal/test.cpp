@@ -0,0 +1,44 @@
+#include <captal/texture.hpp>
+
+#include <utility>
+#include <chrono>
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_CONSOLE_WIDTH 120
+#include <catch2/catch.hpp>
+
+//Tests that do not need a Vulkan device, nor a cpt::engine.
+
+TEST_CASE("Empty texture handles behave as cancelled requests", "[texture]")
+{
+    cpt::texture_handle source{};
+    cpt::texture_handle moved{std::move(source)};
+
+    for(auto* handle : {&source, &moved})
+    {
+        REQUIRE(!*handle);
+        REQUIRE(handle->status() == cpt::texture_load_status::cancelled);
+        REQUIRE(!handle->ready());
+        REQUIRE(handle->get() == nullptr);
+
+        handle->set_priority(42);
+        REQUIRE(handle->priority() == 0);
+
+        handle->cancel();
+        REQUIRE(handle->status() == cpt::texture_load_status::cancelled);
+
+        bool called{};
+        handle->on_completion([&called](const cpt::texture_ptr& texture)
+        {
+            REQUIRE(texture == nullptr);
+            called = true;
+        });
+
+        REQUIRE(called);
+
+        const auto future{handle->future()};
+        REQUIRE(future.valid());
+        REQUIRE(future.wait_for(std::chrono::seconds{0}) == std::future_status::ready);
+        REQUIRE(future.get() == nullptr);
+    }
+}
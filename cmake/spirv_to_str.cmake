@@ -0,0 +1,13 @@
+#Converts a SPIR-V binary into the comma separated list of words embedded by the engine
+#Usage: cmake -DINPUT=<shader.spv> -DOUTPUT=<shader.spv.str> -P spirv_to_str.cmake
+
+file(READ ${INPUT} SPIRV_HEX HEX)
+string(REGEX MATCHALL "........" SPIRV_BYTES "${SPIRV_HEX}")
+
+set(SPIRV_WORDS "")
+foreach(SPIRV_BYTE ${SPIRV_BYTES})
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1," SPIRV_WORD ${SPIRV_BYTE})
+    string(APPEND SPIRV_WORDS ${SPIRV_WORD})
+endforeach()
+
+file(WRITE ${OUTPUT} ${SPIRV_WORDS})
@@ -25,6 +25,9 @@
 #include <captal_foundation/stack_allocator.hpp>
 
 #include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
 #include <numbers>
 #include <iostream>
 
@@ -85,6 +88,18 @@ audio_pulser::audio_pulser(audio_world& world, seconds minimum_latency, seconds
     assert(m_minimum_latency < m_resync_threshold);
 }
 
+audio_pulser::audio_pulser(audio_world& world, const pulser_demand_info& info)
+:m_world{&world}
+,m_mode{pulser_mode::demand}
+,m_block_size{info.block_size}
+,m_blocks_in_flight{info.blocks_in_flight}
+,m_frequency{static_cast<double>(world.sample_rate())}
+,m_period{1.0 / m_frequency}
+,m_thread{&audio_pulser::process, this}
+{
+    assert(m_block_size > 0 && m_blocks_in_flight > 0);
+}
+
 audio_pulser::~audio_pulser()
 {
     if(m_thread.joinable())
@@ -94,6 +109,7 @@ audio_pulser::~audio_pulser()
         lock.unlock();
 
         m_start_condition.notify_one();
+        wake_up();
         m_thread.join();
     }
 }
@@ -106,6 +122,7 @@ void audio_pulser::start()
     {
         m_status = pulser_status::running;
         m_last = clock::now();
+        m_last_block = clock::time_point{};
         m_start_condition.notify_one();
     }
 }
@@ -117,6 +134,7 @@ void audio_pulser::stop()
     if(m_status == pulser_status::running)
     {
         m_status = pulser_status::stopping;
+        wake_up();
         m_stop_condition.wait(lock);
         assert(m_status == pulser_status::stopped);
     }
@@ -126,9 +144,15 @@ listener_bind audio_pulser::bind(listener listener)
 {
     std::lock_guard lock{m_mutex};
 
-    m_binds.emplace_back(std::make_unique<impl::listener_bind_data>(std::move(listener)));
+    auto& bind{m_binds.emplace_back(std::make_unique<impl::listener_bind_data>(std::move(listener)))};
+
+    if(m_mode == pulser_mode::demand)
+    {
+        bind->listener.queue().set_drain_signal(&m_demand);
+        wake_up();
+    }
 
-    return listener_bind{this, m_binds.back().get()};
+    return listener_bind{this, bind.get()};
 }
 
 pulser_status audio_pulser::status() const
@@ -138,6 +162,35 @@ pulser_status audio_pulser::status() const
     return m_status;
 }
 
+pulser_statistics audio_pulser::statistics() const
+{
+    std::lock_guard lock{m_mutex};
+
+    pulser_statistics output{m_statistics};
+
+    if(m_period_count > 0)
+    {
+        const double mean{m_period_sum / static_cast<double>(m_period_count)};
+        const double variance{m_period_square_sum / static_cast<double>(m_period_count) - mean * mean};
+
+        output.mean_period = seconds{mean};
+        output.period_jitter = seconds{std::sqrt(std::max(variance, 0.0))};
+    }
+
+    return output;
+}
+
+void audio_pulser::reset_statistics()
+{
+    std::lock_guard lock{m_mutex};
+
+    m_statistics = pulser_statistics{};
+    m_last_block = clock::time_point{};
+    m_period_sum = 0.0;
+    m_period_square_sum = 0.0;
+    m_period_count = 0;
+}
+
 void audio_pulser::process() noexcept
 {
     increase_thread_priority();
@@ -163,43 +216,13 @@ void audio_pulser::process() noexcept
                 break;
             }
 
-            const auto now{clock::now()};
-            m_elapsed += std::chrono::duration_cast<seconds>(now - m_last);
-            m_last = now;
-
-            if(m_elapsed >= m_resync_threshold)
-            {
-                const auto jump{std::floor((m_elapsed - m_minimum_latency).count())};
-
-                const auto discard_count{std::floor(jump * m_frequency)};
-                m_elapsed -= seconds{discard_count * m_period};
-
-                lock.unlock();
-                m_world->discard(static_cast<std::size_t>(discard_count));
-
-                lock.lock();
-                register_listeners();
-                lock.unlock();
-
-                const auto count{std::floor(m_elapsed.count() * m_frequency)};
-                m_elapsed -= seconds{count * m_period};
-
-                m_world->generate(static_cast<std::size_t>(m_minimum_latency.count()));
-            }
-            else if(m_elapsed >= m_minimum_latency)
+            if(m_mode == pulser_mode::clock)
             {
-                register_listeners();
-                lock.unlock();
-
-                const auto count{std::floor(m_elapsed.count() * m_frequency)};
-                m_elapsed -= seconds{count * m_period};
-
-                m_world->generate(static_cast<std::size_t>(count));
+                clock_tick(lock);
             }
             else
             {
-                lock.unlock();
-                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                demand_tick(lock);
             }
         }
     }
@@ -210,6 +233,115 @@ void audio_pulser::process() noexcept
     }
 }
 
+void audio_pulser::clock_tick(std::unique_lock<std::mutex>& lock)
+{
+    const auto now{clock::now()};
+    m_elapsed += std::chrono::duration_cast<seconds>(now - m_last);
+    m_last = now;
+
+    if(m_elapsed >= m_resync_threshold)
+    {
+        const auto jump{std::floor((m_elapsed - m_minimum_latency).count())};
+
+        const auto discard_count{std::floor(jump * m_frequency)};
+        m_elapsed -= seconds{discard_count * m_period};
+
+        lock.unlock();
+        m_world->discard(static_cast<std::size_t>(discard_count));
+
+        lock.lock();
+        register_listeners();
+        lock.unlock();
+
+        const auto count{std::floor(m_elapsed.count() * m_frequency)};
+        m_elapsed -= seconds{count * m_period};
+
+        m_world->generate(static_cast<std::size_t>(m_minimum_latency.count()));
+    }
+    else if(m_elapsed >= m_minimum_latency)
+    {
+        register_listeners();
+        lock.unlock();
+
+        const auto count{std::floor(m_elapsed.count() * m_frequency)};
+        m_elapsed -= seconds{count * m_period};
+
+        m_world->generate(static_cast<std::size_t>(count));
+    }
+    else
+    {
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+}
+
+void audio_pulser::demand_tick(std::unique_lock<std::mutex>& lock)
+{
+    //Loaded before checking the queues, any drain after this point will wake the wait below
+    const auto signal{m_demand.load(std::memory_order_acquire)};
+
+    std::size_t buffered{std::numeric_limits<std::size_t>::max()};
+    for(const auto& bind : m_binds)
+    {
+        buffered = std::min(buffered, bind->listener.buffered() / bind->listener.channel_count());
+    }
+
+    if(!std::empty(m_binds) && buffered + m_block_size <= m_block_size * m_blocks_in_flight)
+    {
+        generate_block(lock, buffered);
+    }
+    else
+    {
+        lock.unlock();
+        m_demand.wait(signal, std::memory_order_acquire);
+    }
+}
+
+void audio_pulser::generate_block(std::unique_lock<std::mutex>& lock, std::size_t buffered)
+{
+    const auto begin{clock::now()};
+    const seconds latency{static_cast<double>(buffered) * m_period};
+
+    if(m_last_block != clock::time_point{})
+    {
+        const auto period{std::chrono::duration_cast<seconds>(begin - m_last_block).count()};
+
+        m_period_sum += period;
+        m_period_square_sum += period * period;
+        ++m_period_count;
+
+        if(buffered == 0)
+        {
+            ++m_statistics.starvation_count;
+        }
+    }
+
+    m_last_block = begin;
+
+    register_listeners();
+    lock.unlock();
+
+    m_world->generate(m_block_size);
+
+    const auto generation_time{std::chrono::duration_cast<seconds>(clock::now() - begin)};
+
+    lock.lock();
+
+    auto& stats{m_statistics};
+    const double count{static_cast<double>(++stats.block_count)};
+
+    stats.mean_latency += (latency - stats.mean_latency) / count;
+    stats.max_latency = std::max(stats.max_latency, latency);
+    stats.mean_generation_time += (generation_time - stats.mean_generation_time) / count;
+    stats.max_generation_time = std::max(stats.max_generation_time, generation_time);
+}
+
+void audio_pulser::wake_up()
+{
+    m_demand.fetch_add(1, std::memory_order_release);
+    m_demand.notify_all();
+}
+
 void audio_pulser::register_listeners()
 {
     for(auto& listener : m_binds)
@@ -227,6 +359,8 @@ listener audio_pulser::unregister_bind(impl::listener_bind_data* bind)
 
     std::lock_guard lock{m_mutex};
 
+    bind->listener.queue().set_drain_signal(nullptr);
+
     listener output{std::move(bind->listener)};
 
     const auto it{std::find_if(std::begin(m_binds), std::end(m_binds), predicate)};
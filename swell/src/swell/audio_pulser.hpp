@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <memory>
+#include <atomic>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -122,12 +123,37 @@ enum class pulser_status : std::uint32_t
     aborted = 3
 };
 
+enum class pulser_mode : std::uint32_t
+{
+    clock = 0,  //generates what the clock says has elapsed, in blocks of variable size
+    demand = 1, //generates fixed size blocks when listeners' queues are drained
+};
+
+struct pulser_demand_info
+{
+    std::size_t block_size{256}; //frames per generated block
+    std::size_t blocks_in_flight{2}; //blocks kept ready in listeners' queues
+};
+
+struct pulser_statistics
+{
+    std::uint64_t block_count{};
+    std::uint64_t starvation_count{}; //blocks generated while a listener's queue was already empty
+    seconds mean_latency{}; //audio already queued when a block is generated, the added output latency
+    seconds max_latency{};
+    seconds mean_period{}; //time between two generated blocks
+    seconds period_jitter{}; //standard deviation of the period
+    seconds mean_generation_time{};
+    seconds max_generation_time{};
+};
+
 class SWELL_API audio_pulser
 {
     friend class listener_bind;
 
 public:
     audio_pulser(audio_world& world, seconds minimum_latency = seconds{0.010}, seconds resync_threshold = seconds{0.050});
+    audio_pulser(audio_world& world, const pulser_demand_info& info);
     ~audio_pulser();
     audio_pulser(const audio_pulser&) = delete;
     audio_pulser& operator=(const audio_pulser&) = delete;
@@ -140,14 +166,34 @@ public:
     listener_bind bind(listener listener);
 
     pulser_status status() const;
+    pulser_statistics statistics() const;
+    void reset_statistics();
+
+    pulser_mode mode() const noexcept
+    {
+        return m_mode;
+    }
 
 private:
     void process() noexcept;
+    void clock_tick(std::unique_lock<std::mutex>& lock);
+    void demand_tick(std::unique_lock<std::mutex>& lock);
+    void generate_block(std::unique_lock<std::mutex>& lock, std::size_t buffered);
+    void wake_up();
     void register_listeners();
     listener unregister_bind(impl::listener_bind_data* bind);
 
 private:
     audio_world* m_world{};
+    pulser_mode m_mode{};
+    std::size_t m_block_size{};
+    std::size_t m_blocks_in_flight{};
+    std::atomic<std::uint64_t> m_demand{};
+    pulser_statistics m_statistics{};
+    clock::time_point m_last_block{};
+    double m_period_sum{};
+    double m_period_square_sum{};
+    std::uint64_t m_period_count{};
     seconds m_minimum_latency{};
     seconds m_resync_threshold{};
     seconds m_elapsed{};
@@ -155,11 +201,11 @@ private:
     double m_period{};
     clock::time_point m_last{};
     pulser_status m_status{};
-    std::thread m_thread{};
     std::condition_variable m_start_condition{};
     std::condition_variable m_stop_condition{};
     mutable std::mutex m_mutex{};
     std::vector<std::unique_ptr<impl::listener_bind_data>> m_binds{};
+    std::thread m_thread{}; //last, the thread must start after everything it uses is constructed
 };
 
 class SWELL_API listener_bridge
@@ -22,6 +22,8 @@
 
 #include "audio_world.hpp"
 
+#include <array>
+#include <functional>
 #include <cassert>
 #include <numbers>
 #include <utility>
@@ -29,7 +31,6 @@
 namespace swl
 {
 
-/*
 static constexpr std::array volumes_lut  //std::sqrt(std::pow(10.0f, value * 3.0f) / 1000.0f) with value = [0.0f, 1.0f]
 {
     0.0000000f, 0.0327341f, 0.0338844f, 0.0350752f, 0.0363078f, 0.0375837f, 0.0389045f, 0.0402717f,
@@ -46,7 +47,21 @@ static constexpr std::array volumes_lut  //std::sqrt(std::pow(10.0f, value * 3.0
     0.6606923f, 0.6839104f, 0.7079445f, 0.7328232f, 0.7585761f, 0.7852341f, 0.8128289f, 0.8413934f,
     0.8709618f, 0.9015692f, 0.9332523f, 0.9660488f, 1.0000000f
 };
-*/
+
+//Gains are computed exactly every gain_segment_size frames and linearly interpolated in between
+static constexpr std::size_t gain_segment_size{64};
+
+static constexpr auto gain_segment_offsets{[]()
+{
+    std::array<float, gain_segment_size> output{};
+
+    for(std::size_t i{}; i < gain_segment_size; ++i)
+    {
+        output[i] = static_cast<float>(i);
+    }
+
+    return output;
+}()};
 
 static float get_volume_multiplier(float value) noexcept
 {
@@ -58,102 +73,249 @@ static float get_volume_multiplier(float value) noexcept
     return std::sqrt(std::pow(10.0f, value * 3.0f) / 1000.0f);
 }
 
-listener::listener(std::uint32_t channel_count)
-:m_data{std::make_unique<impl::listener_data>()}
+//Same curve as get_volume_multiplier, interpolated from volumes_lut
+static float get_fading_multiplier(float value) noexcept
+{
+    const float position{std::clamp(value, 0.0f, 1.0f) * static_cast<float>(std::size(volumes_lut) - 1)};
+    const auto  index   {std::min(static_cast<std::size_t>(position), std::size(volumes_lut) - 2)};
+
+    return volumes_lut[index] + (volumes_lut[index + 1] - volumes_lut[index]) * (position - static_cast<float>(index));
+}
+
+static void advance_fading(impl::sound_state& state, std::uint64_t frame_count) noexcept
+{
+    if(state.fading == std::numeric_limits<std::uint64_t>::max())
+    {
+        return;
+    }
+
+    state.current_fading = std::min(state.current_fading + frame_count, state.fading);
+
+    if(state.current_fading == state.fading)
+    {
+        if(state.status == sound_status::fading_in)
+        {
+            state.status = sound_status::playing;
+            state.fading = std::numeric_limits<std::uint64_t>::max();
+            state.current_fading = 0;
+        }
+        else if(state.status == sound_status::fading_out)
+        {
+            state.status = sound_status::ended;
+        }
+    }
+}
+
+static vec3f get_sound_position(const impl::listener_spatialization& listener, const impl::sound_spatialization& sound) noexcept
+{
+    return sound.relative ? listener.position + sound.position : sound.position;
+}
+
+//Inverse distance attenuation, clamped to 1 inside the minimum distance
+static float distance_gain(const impl::listener_spatialization& listener, const impl::sound_spatialization& sound) noexcept
+{
+    const float distance{cpt::distance(get_sound_position(listener, sound), listener.position)};
+    const float minimum {sound.minimum_distance};
+
+    return minimum / (minimum + sound.attenuation * (std::max(distance, minimum) - minimum));
+}
+
+static bool is_playing(sound_status status) noexcept
+{
+    return status == sound_status::playing || status == sound_status::fading_in || status == sound_status::fading_out;
+}
+
+static constexpr std::uint64_t status_bits{8};
+static constexpr std::uint64_t status_mask{(1 << status_bits) - 1};
+
+//Written by the audio thread once it is done with the reader for this block, so the owner may take it back
+static void publish_state(impl::sound_data& sound, bool read) noexcept
+{
+    if(read)
+    {
+        try
+        {
+            sound.published_position.store(sound.reader->tell(), std::memory_order_relaxed);
+        }
+        catch(...)
+        {
+            sound.state.status = sound_status::aborted;
+        }
+    }
+
+    const auto status{(sound.applied.revision << status_bits) | static_cast<std::uint64_t>(sound.state.status)};
+
+    if(sound.published_status.load(std::memory_order_relaxed) != status)
+    {
+        sound.published_status.store(status, std::memory_order_release);
+        sound.published_status.notify_all();
+    }
+}
+
+//Applies the latest parameters and control published by the owner, called for every sound at the beginning of each block
+static void apply_control(impl::sound_data& sound) noexcept
+{
+    const auto& parameters{sound.published.load()};
+    const auto& control{parameters.control};
+
+    sound.state.volume = parameters.volume;
+    sound.state.priority = parameters.priority;
+    sound.state.spatialization = parameters.spatialization;
+
+    if(control.revision == sound.applied.revision)
+    {
+        return;
+    }
+
+    bool read{};
+
+    try
+    {
+        if(control.status_revision != sound.applied.status_revision)
+        {
+            sound.state.status = control.status;
+            sound.state.pause_initial_status = control.pause_initial_status;
+        }
+
+        if(control.restart_revision != sound.applied.restart_revision)
+        {
+            sound.state.current_volume = sound.state.volume;
+        }
+
+        if(control.fading_revision != sound.applied.fading_revision)
+        {
+            sound.state.current_fading = 0;
+            sound.state.fading = control.fading;
+        }
+
+        //The owner may have paused a fade in that ended during the block it was requested
+        if(sound.state.status == sound_status::fading_in && sound.state.fading == std::numeric_limits<std::uint64_t>::max())
+        {
+            sound.state.status = sound_status::playing;
+        }
+
+        if(control.loop_revision != sound.applied.loop_revision)
+        {
+            sound.state.loop_begin = control.loop_begin;
+            sound.state.loop_end = control.loop_end;
+
+            sound.reader->set_loop_points(control.loop_begin, control.loop_end);
+            read = true;
+        }
+
+        if(control.position_revision != sound.applied.position_revision)
+        {
+            sound.reader->seek(control.position);
+            read = true;
+        }
+    }
+    catch(...)
+    {
+        sound.state.status = sound_status::aborted;
+    }
+
+    sound.applied = control;
+
+    publish_state(sound, read);
+}
+
+//Status requested by the owner, until the audio thread applied it
+static sound_status get_status(const impl::sound_data& sound) noexcept
+{
+    const auto published{sound.published_status.load(std::memory_order_acquire)};
+
+    if((published >> status_bits) >= sound.parameters.control.status_revision)
+    {
+        return static_cast<sound_status>(published & status_mask);
+    }
+
+    return sound.parameters.control.status;
+}
+
+listener::listener(std::uint32_t channel_count, std::size_t queue_capacity)
+:m_data{std::make_unique<impl::listener_data>(queue_capacity)}
 {
     m_data->state.channel_count = channel_count;
+    m_data->published.store(m_data->state);
 }
 
 void listener::set_volume(float volume)
 {
-    std::lock_guard lock{m_data->mutex};
-
     m_data->state.volume = get_volume_multiplier(volume);
+    m_data->published.store(m_data->state);
 }
 
 void listener::enable_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
-
     m_data->state.spatialization.enable = true;
+    m_data->published.store(m_data->state);
 }
 
 void listener::disable_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
-
     m_data->state.spatialization.enable = false;
+    m_data->published.store(m_data->state);
 }
 
 void listener::move(const vec3f& relative)
 {
-    std::lock_guard lock{m_data->mutex};
-
     m_data->state.spatialization.position += relative;
+    m_data->published.store(m_data->state);
 }
 
 void listener::move_to(const vec3f& position)
 {
-    std::lock_guard lock{m_data->mutex};
-
     m_data->state.spatialization.position = position;
+    m_data->published.store(m_data->state);
 }
 
 void listener::set_direction(const vec3f& direction)
 {
-    std::lock_guard lock{m_data->mutex};
-
     m_data->state.spatialization.direction = direction;
+    m_data->published.store(m_data->state);
 }
 
 float listener::volume() const
 {
-    std::lock_guard lock{m_data->mutex};
-
     return m_data->state.volume;
 }
 
 std::uint32_t listener::channel_count() const
 {
-    std::lock_guard lock{m_data->mutex};
-
     return m_data->state.channel_count;
 }
 
 bool listener::is_spatialization_enabled() const
 {
-    std::lock_guard lock{m_data->mutex};
-
     return m_data->state.spatialization.enable;
 }
 
 vec3f listener::position() const
 {
-    std::lock_guard lock{m_data->mutex};
-
     return m_data->state.spatialization.position;
 }
 
 vec3f listener::direction() const
 {
-    std::lock_guard lock{m_data->mutex};
-
     return m_data->state.spatialization.direction;
 }
 
 sound::sound(audio_world& world, std::unique_ptr<sound_reader> reader)
 :m_data{world.make_sound()}
 {
-    m_data->reader = std::move(reader);
+    m_data->reader = make_resampling_reader(std::move(reader), m_data->sample_rate, m_data->resampling);
 }
 
 sound::~sound()
 {
     if(m_data)
     {
-        std::lock_guard lock{m_data->mutex};
+        auto& control{m_data->parameters.control};
+
+        control.status = sound_status::freed;
+        control.status_revision = ++control.revision;
 
-        m_data->state.status = sound_status::freed;
+        m_data->published.store(m_data->parameters);
     }
 }
 
@@ -172,274 +334,281 @@ sound& sound::operator=(sound&& other) noexcept
 
 void sound::start()
 {
-    std::lock_guard lock{m_data->mutex};
+    [[maybe_unused]] const auto status{get_status(*m_data)};
+    assert((status == sound_status::stopped || status == sound_status::ended || status == sound_status::aborted) && "swl::sound::start() can only be called on stopped, ended or arboted sound.");
 
-    assert((m_data->state.status == sound_status::stopped || m_data->state.status == sound_status::ended || m_data->state.status == sound_status::aborted) && "swl::sound::start() can only be called on stopped, ended or arboted sound.");
+    auto& control{m_data->parameters.control};
 
-    m_data->reader->seek(0);
-    m_data->state.status = sound_status::playing;
-    m_data->state.current_fading = 0;
-    m_data->state.fading = std::numeric_limits<std::uint64_t>::max();
+    control.status = sound_status::playing;
+    control.status_revision = ++control.revision;
+    control.restart_revision = control.revision;
+    control.fading = std::numeric_limits<std::uint64_t>::max();
+    control.fading_revision = control.revision;
+    control.position = 0;
+    control.position_revision = control.revision;
+
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::stop()
 {
-    std::lock_guard lock{m_data->mutex};
+    auto& control{m_data->parameters.control};
+
+    control.status = sound_status::stopped;
+    control.status_revision = ++control.revision;
 
-    m_data->state.status = sound_status::stopped;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::pause()
 {
-    std::lock_guard lock{m_data->mutex};
+    const auto status{get_status(*m_data)};
+    assert((status == sound_status::playing || status == sound_status::fading_in || status == sound_status::fading_out) && "swl::sound::pause() can only be called on playing or fading sound.");
+
+    auto& control{m_data->parameters.control};
 
-    assert((m_data->state.status == sound_status::playing || m_data->state.status == sound_status::fading_in || m_data->state.status == sound_status::fading_out) && "swl::sound::pause() can only be called on playing or fading sound.");
+    control.pause_initial_status = status;
+    control.status = sound_status::paused;
+    control.status_revision = ++control.revision;
 
-    m_data->state.pause_initial_status = m_data->state.status;
-    m_data->state.status = sound_status::paused;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::resume()
 {
-    std::lock_guard lock{m_data->mutex};
+    assert(get_status(*m_data) == sound_status::paused && "swl::sound::resume() can only be called on paused sound.");
 
-    assert(m_data->state.status == sound_status::paused && "swl::sound::resume() can only be called on paused sound.");
+    auto& control{m_data->parameters.control};
 
-    m_data->state.status = m_data->state.pause_initial_status;
+    control.status = control.pause_initial_status;
+    control.status_revision = ++control.revision;
+
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::fade_in(std::uint64_t frames)
 {
-    std::lock_guard lock{m_data->mutex};
+    const auto status{get_status(*m_data)};
+    assert((status == sound_status::stopped || status == sound_status::ended || status == sound_status::aborted || status == sound_status::paused) && "swl::sound::fade_in() can only be called on stopped, ended, paused or aborted sound.");
+
+    auto& control{m_data->parameters.control};
 
-    assert((m_data->state.status == sound_status::stopped || m_data->state.status == sound_status::ended || m_data->state.status == sound_status::aborted || m_data->state.status == sound_status::paused) && "swl::sound::fade_in() can only be called on stopped, ended, paused or aborted sound.");
+    control.status = sound_status::fading_in;
+    control.status_revision = ++control.revision;
+    control.fading = frames;
+    control.fading_revision = control.revision;
 
-    if(m_data->state.status == sound_status::stopped || m_data->state.status == sound_status::ended || m_data->state.status == sound_status::aborted)
+    if(status == sound_status::stopped || status == sound_status::ended || status == sound_status::aborted)
     {
-        //Can not call start() because the mutex is already locked
-        m_data->reader->seek(0);
-        m_data->state.current_fading = 0;
+        control.restart_revision = control.revision;
+        control.position = 0;
+        control.position_revision = control.revision;
     }
 
-    m_data->state.status = sound_status::fading_in;
-    m_data->state.fading = frames;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::fade_out(std::uint64_t frames)
 {
-    std::lock_guard lock{m_data->mutex};
+    assert(get_status(*m_data) == sound_status::playing && "swl::sound::fade_out() can only be called on playing sound.");
+
+    auto& control{m_data->parameters.control};
 
-    assert(m_data->state.status == sound_status::playing && "swl::sound::fade_out() can only be called on playing sound.");
+    control.status = sound_status::fading_out;
+    control.status_revision = ++control.revision;
+    control.fading = frames;
+    control.fading_revision = control.revision;
 
-    m_data->state.status = sound_status::fading_out;
-    m_data->state.fading = frames;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::set_volume(float volume)
 {
-    std::lock_guard lock{m_data->mutex};
-
-    m_data->state.volume = get_volume_multiplier(volume);
+    m_data->parameters.volume = get_volume_multiplier(volume);
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::set_loop_points(std::uint64_t begin_frame, std::uint64_t end_frame)
 {
-    std::lock_guard lock{m_data->mutex};
-
     assert(m_data->reader->info().seekable && "looped sound's reader must be seekable.");
     assert(m_data->reader->info().frame_count >= end_frame && "looped sound's end frame outside reader bounds.");
 
-    m_data->state.loop_begin = begin_frame;
-    m_data->state.loop_end = end_frame;
+    auto& control{m_data->parameters.control};
+
+    control.loop_begin = begin_frame;
+    control.loop_end = end_frame;
+    control.loop_revision = ++control.revision;
+
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::enable_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
-
-    m_data->state.spatialization.enable = true;
+    m_data->parameters.spatialization.enable = true;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::disable_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
-
-    m_data->state.spatialization.enable = false;
+    m_data->parameters.spatialization.enable = false;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::relative_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
-
-    m_data->state.spatialization.relative = true;
+    m_data->parameters.spatialization.relative = true;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::absolute_spatialization()
 {
-    std::lock_guard lock{m_data->mutex};
-
-    m_data->state.spatialization.relative = false;
+    m_data->parameters.spatialization.relative = false;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::set_minimum_distance(float distance)
 {
-    std::lock_guard lock{m_data->mutex};
-
-    m_data->state.spatialization.minimum_distance = distance;
+    m_data->parameters.spatialization.minimum_distance = distance;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::set_attenuation(float attenuation)
 {
-    std::lock_guard lock{m_data->mutex};
-
-    m_data->state.spatialization.attenuation = attenuation;
+    m_data->parameters.spatialization.attenuation = attenuation;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::move(const vec3f& relative)
 {
-    std::lock_guard lock{m_data->mutex};
-
-    m_data->state.spatialization.position += relative;
+    m_data->parameters.spatialization.position += relative;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::move_to(const vec3f& position)
 {
-    std::lock_guard lock{m_data->mutex};
-
-    m_data->state.spatialization.position = position;
+    m_data->parameters.spatialization.position = position;
+    m_data->published.store(m_data->parameters);
 }
 
 void sound::seek(std::uint64_t frame)
 {
-    std::lock_guard lock{m_data->mutex};
+    auto& control{m_data->parameters.control};
+
+    control.position = frame;
+    control.position_revision = ++control.revision;
 
-    m_data->reader->seek(frame);
+    m_data->published.store(m_data->parameters);
+}
+
+void sound::set_priority(std::int32_t priority)
+{
+    m_data->parameters.priority = priority;
+    m_data->published.store(m_data->parameters);
 }
 
+//The reader belongs to the audio thread while the sound plays, so if it may be playing, the sound is stopped
+//and this function waits until the audio thread has applied it. The world must then be generated (or discarded) by another thread.
 std::unique_ptr<sound_reader> sound::change_reader(std::unique_ptr<sound_reader> new_reader)
 {
-    std::lock_guard lock{m_data->mutex};
+    auto& control{m_data->parameters.control};
+
+    const auto published{m_data->published_status.load(std::memory_order_acquire)};
+    const bool idle{(published >> status_bits) == control.revision && !is_playing(static_cast<sound_status>(published & status_mask))};
+
+    control.status = sound_status::stopped;
+    control.status_revision = ++control.revision;
+
+    m_data->published.store(m_data->parameters);
+
+    if(!idle)
+    {
+        auto status{m_data->published_status.load(std::memory_order_acquire)};
+
+        while((status >> status_bits) < control.revision)
+        {
+            m_data->published_status.wait(status, std::memory_order_acquire);
+            status = m_data->published_status.load(std::memory_order_acquire);
+        }
+    }
 
     std::unique_ptr<sound_reader> output{std::move(m_data->reader)};
 
-    m_data->reader = std::move(new_reader);
-    m_data->state.status = sound_status::stopped;
+    m_data->reader = make_resampling_reader(std::move(new_reader), m_data->sample_rate, m_data->resampling);
+
+    if(control.loop_end != std::numeric_limits<std::uint64_t>::max())
+    {
+        m_data->reader->set_loop_points(control.loop_begin, control.loop_end);
+    }
+
+    //Published with the new reader, the audio thread only sees it with this control
+    control.position = m_data->reader->tell();
+    control.position_revision = ++control.revision;
+
+    m_data->published.store(m_data->parameters);
 
     return output;
 }
 
 sound_status sound::status() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.status;
+    return get_status(*m_data);
 }
 
 float sound::volume() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.volume;
+    return m_data->parameters.volume;
 }
 
 std::pair<std::uint64_t, std::uint64_t> sound::loop_points() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return std::make_pair(m_data->state.loop_begin, m_data->state.loop_end);
+    return std::make_pair(m_data->parameters.control.loop_begin, m_data->parameters.control.loop_end);
 }
 
 bool sound::is_spatialization_enabled() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.spatialization.enable;
+    return m_data->parameters.spatialization.enable;
 }
 
 bool sound::is_spatialization_relative() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.spatialization.relative;
+    return m_data->parameters.spatialization.relative;
 }
 
 float sound::minimum_distance() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.spatialization.minimum_distance;
+    return m_data->parameters.spatialization.minimum_distance;
 }
 
 float sound::attenuation() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.spatialization.attenuation;
+    return m_data->parameters.spatialization.attenuation;
 }
 
 vec3f sound::position() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->state.spatialization.position;
+    return m_data->parameters.spatialization.position;
 }
 
 std::uint64_t sound::tell() const
 {
-    std::lock_guard lock{m_data->mutex};
-
-    return m_data->reader->tell();
-}
-
-static constexpr float fast_pow(float value, std::size_t count) noexcept
-{
-    if(value == 0.0f)
-    {
-        return 0.0f;
-    }
-
-    if(value == 1.0f)
-    {
-        return 1.0f;
-    }
+    const auto published{m_data->published_status.load(std::memory_order_acquire)};
 
-    if(count == 0)
+    if((published >> status_bits) >= m_data->parameters.control.position_revision)
     {
-        return 1.0f;
+        return m_data->published_position.load(std::memory_order_relaxed);
     }
 
-    float output{1.0f};
-
-    if(count % 2 == 1)
-    {
-        output *= value;
-    }
-
-    for(std::size_t i{count / 2}; i != 0; i /= 2)
-    {
-        value *= value;
-
-        if(i % 2 == 1)
-        {
-            output *= value;
-        }
-    }
-
-    return output;
+    return m_data->parameters.control.position;
 }
 
-static constexpr float sign(float value) noexcept
+std::int32_t sound::priority() const
 {
-    return value >= 0.0f ? 1.0f : -1.0f;
+    return m_data->parameters.priority;
 }
 
-inline float mix_amplitude(float value, std::size_t count) noexcept
-{
-    return sign(value) * (1.0f - fast_pow(1.0f - std::abs(value), count));
-}
-
-audio_world::audio_world(std::uint32_t sample_rate)
+audio_world::audio_world(std::uint32_t sample_rate, std::size_t worker_count)
 :m_sample_rate{sample_rate}
+,m_workers{worker_count}
 {
 
 }
@@ -468,44 +637,16 @@ void audio_world::generate(std::size_t frame_count)
         return;
     }
 
-    m_sample_buffer.clear();
     store_sounds_data(frame_count);
 
     lock.unlock();
 
-    for(auto& sound : m_sounds_data)
-    {
-        apply_fading(sound, frame_count);
-    }
-
     for(auto& listener : m_listeners_data)
     {
-        std::lock_guard lock{*listener.queue};
-
-        m_listener_samples = listener.queue->begin(frame_count * listener.state.channel_count);
-
-        for(auto& sound : m_sounds_data)
-        {
-            if(sound.state.channel_count == 1 && listener.state.spatialization.enable && sound.state.spatialization.enable)
-            {
-                spatialize(listener, sound, frame_count);
-            }
-            else if(sound.state.channel_count != listener.state.channel_count)
-            {
-                adjust_channels(listener, sound, frame_count);
-            }
-            else //no spacialization and sound.state.channel_count == listener.state.channel_count
-            {
-                const float volume{sound.state.volume * listener.state.volume};
-
-                for(std::size_t i{}; i < std::size(sound.samples); ++i)
-                {
-                    m_listener_samples[i] += sound.samples[i] * volume;
-                }
-            }
-        }
+        const auto samples{listener.queue->begin(frame_count * listener.state.channel_count)};
 
-        mix_sounds();
+        mix_listener(listener, samples, frame_count);
+        mix_sounds(samples);
 
         listener.queue->end();
     }
@@ -515,6 +656,13 @@ void audio_world::generate(std::size_t frame_count)
     free_resources();
 }
 
+void audio_world::set_virtualization(const virtualization_info& info)
+{
+    std::lock_guard lock{m_mutex};
+
+    m_virtualization = info;
+}
+
 vec3f audio_world::up() const
 {
     std::lock_guard lock{m_mutex};
@@ -522,13 +670,36 @@ vec3f audio_world::up() const
     return m_up;
 }
 
+virtualization_info audio_world::virtualization() const
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_virtualization;
+}
+
+std::size_t audio_world::real_voice_count() const
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_real_voice_count;
+}
+
+std::size_t audio_world::virtual_voice_count() const
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_virtual_voice_count;
+}
+
 impl::sound_data* audio_world::make_sound()
 {
     std::lock_guard lock{m_mutex};
 
-    m_sounds.push_back(std::make_unique<impl::sound_data>());
+    auto& sound{m_sounds.emplace_back(std::make_unique<impl::sound_data>())};
+    sound->sample_rate = m_sample_rate;
+    sound->resampling = m_resampling_quality;
 
-    return m_sounds.back().get();
+    return sound.get();
 }
 
 void audio_world::discard_impl(std::size_t frame_count)
@@ -538,20 +709,22 @@ void audio_world::discard_impl(std::size_t frame_count)
 
     for(auto& sound : m_sounds)
     {
-        std::lock_guard sound_lock{sound->mutex};
+        apply_control(*sound);
 
-        try
+        if(is_playing(sound->state.status))
         {
-            if(sound->state.status == sound_status::playing || sound->state.status == sound_status::fading_in || sound->state.status == sound_status::fading_out)
+            try
             {
                 sound->state.channel_count = sound->reader->info().channel_count;
 
                 discard_sound_data(*sound, frame_count);
             }
-        }
-        catch(...)
-        {
-            sound->state.status = sound_status::aborted;
+            catch(...)
+            {
+                sound->state.status = sound_status::aborted;
+            }
+
+            publish_state(*sound, true);
         }
     }
 }
@@ -599,12 +772,9 @@ void audio_world::discard_sound_data(impl::sound_data& sound, std::size_t frame_
                 read += count;
             }
         }
-
-        if(sound.state.fading != std::numeric_limits<std::uint64_t>::max() && sound.state.current_fading + frame_count > sound.state.fading)
-        {
-            sound.state.status = sound_status::ended;
-        }
     }
+
+    advance_fading(sound.state, frame_count);
 }
 
 void audio_world::store_sounds_data(std::size_t frame_count)
@@ -614,32 +784,185 @@ void audio_world::store_sounds_data(std::size_t frame_count)
 
     for(auto& sound : m_sounds)
     {
-        std::lock_guard sound_lock{sound->mutex};
+        apply_control(*sound);
 
-        try
+        if(is_playing(sound->state.status))
+        {
+            sound->state.channel_count = sound->reader->info().channel_count;
+
+            m_sounds_data.emplace_back(sound.get(), std::span<float>{}, sound->state);
+        }
+    }
+
+    virtualize_sounds(frame_count);
+
+    std::size_t total_size{};
+    for(const auto& sound : m_sounds_data)
+    {
+        total_size += frame_count * sound.state.channel_count;
+    }
+
+    //Each sound gets its own slice of the sample buffer so they can be decoded concurrently
+    m_sample_buffer.resize(total_size);
+
+    std::size_t offset{};
+    for(auto& sound : m_sounds_data)
+    {
+        const auto count{frame_count * sound.state.channel_count};
+
+        sound.samples = std::span<float>{std::data(m_sample_buffer) + offset, count};
+        offset += count;
+    }
+
+    m_workers.run(std::size(m_sounds_data), [this, frame_count](std::size_t index)
+    {
+        read_sound_data(m_sounds_data[index], frame_count);
+    });
+
+    std::erase_if(m_sounds_data, [](const sound_data_buffer& sound)
+    {
+        return std::empty(sound.samples);
+    });
+
+    m_playing_voice_count = std::size(m_sounds_data) + m_virtual_voice_count;
+}
+
+void audio_world::virtualize_sounds(std::size_t frame_count)
+{
+    for(auto& sound : m_sounds_data)
+    {
+        sound.audibility = audibility(sound.state);
+    }
+
+    const auto real_begin{std::begin(m_sounds_data)};
+    //Neither partition nor nth_element allocate, unlike their stable versions, this runs on the audio thread
+    const auto audible_end{std::partition(std::begin(m_sounds_data), std::end(m_sounds_data), [threshold = m_virtualization.audibility_threshold](const sound_data_buffer& sound)
+    {
+        return sound.audibility > threshold;
+    })};
+
+    auto real_end{audible_end};
+
+    if(static_cast<std::size_t>(audible_end - real_begin) > m_virtualization.max_real_voices)
+    {
+        real_end = real_begin + static_cast<std::ptrdiff_t>(m_virtualization.max_real_voices);
+
+        //Ties are broken by address, so the same voices stay real from one block to the next
+        std::nth_element(real_begin, real_end, audible_end, [](const sound_data_buffer& left, const sound_data_buffer& right)
         {
-            if(sound->state.status == sound_status::playing || sound->state.status == sound_status::fading_in || sound->state.status == sound_status::fading_out)
+            if(left.state.priority != right.state.priority)
             {
-                sound->state.channel_count = sound->reader->info().channel_count;
+                return left.state.priority > right.state.priority;
+            }
+
+            if(left.audibility != right.audibility)
+            {
+                return left.audibility > right.audibility;
+            }
+
+            return std::less<>{}(left.sound, right.sound);
+        });
+    }
+
+    m_real_voice_count = static_cast<std::size_t>(real_end - real_begin);
+    m_virtual_voice_count = static_cast<std::size_t>(std::end(m_sounds_data) - real_end);
+
+    if(m_virtual_voice_count > 0)
+    {
+        //Non-seekable readers are decoded in this buffer, before it is resized for the real voices
+        m_sample_buffer.reserve(4096);
+        m_sample_buffer.resize(m_sample_buffer.capacity());
+
+        for(auto it{real_end}; it != std::end(m_sounds_data); ++it)
+        {
+            auto& data{*it->sound};
 
-                m_sounds_data.emplace_back(get_sound_data(*sound, frame_count), sound->state);
+            try
+            {
+                //Same position and gains at the end of the block as a real voice, so it comes back sample-accurately
+                data.state.current_volume = data.state.volume;
+                discard_sound_data(data, frame_count);
+
+                if(data.state.status == sound_status::ended)
+                {
+                    data.state.fading = std::numeric_limits<std::uint64_t>::max();
+                }
+            }
+            catch(...)
+            {
+                data.state.status = sound_status::aborted;
             }
+
+            publish_state(data, true);
         }
-        catch(...)
+
+        m_sounds_data.erase(real_end, std::end(m_sounds_data));
+    }
+}
+
+float audio_world::audibility(const impl::sound_state& state) const noexcept
+{
+    const float volume{std::max(state.volume, state.current_volume)};
+
+    float output{};
+    for(const auto& listener : m_listeners_data)
+    {
+        float gain{volume * listener.state.volume};
+
+        if(state.channel_count == 1 && listener.state.spatialization.enable && state.spatialization.enable)
         {
-            sound->state.status = sound_status::aborted;
+            gain *= distance_gain(listener.state.spatialization, state.spatialization);
         }
+
+        output = std::max(output, gain);
     }
+
+    return output;
 }
 
-std::span<float> audio_world::get_sound_data(impl::sound_data& sound, std::size_t frame_count)
+void audio_world::read_sound_data(sound_data_buffer& sound, std::size_t frame_count) noexcept
 {
-    const auto begin{std::size(m_sample_buffer)};
-    const auto count{frame_count * sound.state.channel_count};
+    //The state of the sound only changes on the audio thread, it is the same as in the snapshot taken by store_sounds_data
+    auto& data{*sound.sound};
+
+    try
+    {
+        const auto initial_status{data.state.status};
+
+        get_sound_data(data, sound.samples, frame_count);
+
+        //The snapshot keeps the gains at the beginning of the block, the shared state moves to the end of it
+        sound.state = data.state;
+        sound.state.status = initial_status;
+
+        data.state.current_volume = data.state.volume;
 
-    m_sample_buffer.resize(begin + count);
+        if(data.state.status == sound_status::ended)
+        {
+            data.state.fading = std::numeric_limits<std::uint64_t>::max();
+        }
+        else
+        {
+            advance_fading(data.state, frame_count);
+        }
+    }
+    catch(...)
+    {
+        data.state.status = sound_status::aborted;
+        sound.samples = std::span<float>{};
+    }
+
+    publish_state(data, true);
+
+    if(!std::empty(sound.samples))
+    {
+        apply_gain(sound, frame_count);
+    }
+}
 
-    const auto output  {std::data(m_sample_buffer) + begin};
+void audio_world::get_sound_data(impl::sound_data& sound, std::span<float> samples, std::size_t frame_count)
+{
+    const auto output  {std::data(samples)};
     const auto position{sound.reader->tell()};
 
     if((position + frame_count) > sound.state.loop_end) //Loop
@@ -676,59 +999,147 @@ std::span<float> audio_world::get_sound_data(impl::sound_data& sound, std::size_
             sound.state.status = sound_status::ended;
         }
     }
+}
+
+void audio_world::apply_gain(sound_data_buffer& sound, std::size_t frame_count) noexcept
+{
+    auto& state{sound.state};
+
+    const bool fading{state.fading != std::numeric_limits<std::uint64_t>::max()};
 
-    if(sound.state.fading != std::numeric_limits<std::uint64_t>::max() && sound.state.current_fading + frame_count > sound.state.fading)
+    if(!fading && state.current_volume == state.volume) //mix_sound will apply the volume
     {
-        sound.state.status = sound_status::ended;
+        return;
     }
 
-    return std::span<float>{output, frame_count * sound.state.channel_count};
-}
+    const auto gain_at = [&state, fading, frame_count](std::size_t frame) noexcept -> float
+    {
+        //Volume changes are spread over the whole block to avoid zipper noise
+        const float progress{static_cast<float>(frame) / static_cast<float>(frame_count)};
+        const float volume  {state.current_volume + (state.volume - state.current_volume) * progress};
 
-void audio_world::apply_fading(sound_data_buffer& sound, std::size_t frame_count)
-{
-    if(sound.state.fading != std::numeric_limits<std::uint64_t>::max())
+        if(!fading)
+        {
+            return volume;
+        }
+
+        const auto position{state.current_fading + frame};
+
+        if(position >= state.fading)
+        {
+            return state.status == sound_status::fading_in ? volume : 0.0f;
+        }
+
+        const float percent{static_cast<float>(position) / static_cast<float>(state.fading)};
+
+        return volume * get_fading_multiplier(state.status == sound_status::fading_in ? percent : 1.0f - percent);
+    };
+
+    const auto channel_count{state.channel_count};
+    auto samples{std::data(sound.samples)};
+
+    float gain{gain_at(0)};
+    for(std::size_t begin{}; begin < frame_count; begin += gain_segment_size)
     {
-        for(std::uint32_t i{}; i < frame_count; ++i) //fading
+        const auto count{std::min(gain_segment_size, frame_count - begin)};
+        const float next{gain_at(begin + count)};
+        const float step{(next - gain) / static_cast<float>(count)};
+
+        if(channel_count == 2)
         {
-            const float fading_percent{1.0f - (static_cast<float>(sound.state.current_fading + i) / static_cast<float>(sound.state.fading))};
-            if(fading_percent <= 0.0f)
+            for(std::size_t i{}; i < count; ++i)
             {
-                sound.state.current_fading += i;
+                const float current{gain + step * gain_segment_offsets[i]};
 
-                std::fill(std::begin(sound.samples) + i * sound.state.channel_count, std::end(sound.samples), 0.0f);
-                break;
+                samples[i * 2] *= current;
+                samples[i * 2 + 1] *= current;
             }
-
-            const float multiplier{get_volume_multiplier(fading_percent)};
-            for(std::uint32_t j{}; j < sound.state.channel_count; ++j)
+        }
+        else
+        {
+            for(std::size_t i{}; i < count; ++i)
             {
-                sound.samples[i * sound.state.channel_count + j] *= multiplier;
+                const float current{gain + step * gain_segment_offsets[i]};
+
+                for(std::uint32_t j{}; j < channel_count; ++j)
+                {
+                    samples[i * channel_count + j] *= current;
+                }
             }
         }
 
-        sound.state.current_fading += frame_count;
+        samples += count * channel_count;
+        gain = next;
     }
+
+    state.volume = 1.0f; //Already applied
 }
 
-void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept
+void audio_world::mix_listener(const listener_data_buffer& listener, std::span<float> output, std::size_t frame_count)
 {
-    const vec3f listener_position  {listener.state.spatialization.position};
-    const vec3f sound_base_position{sound.state.spatialization.position};
-    const vec3f sound_position     {sound.state.spatialization.relative ? listener_position + sound_base_position : sound_base_position};
+    const auto partition_count{std::min(m_workers.thread_count() + 1, std::size(m_sounds_data))};
 
-    const float distance   {cpt::distance(sound_position, listener_position)};
-    const float minimum    {sound.state.spatialization.minimum_distance};
-    const float attenuation{sound.state.spatialization.attenuation};
-    const float volume     {sound.state.volume * listener.state.volume};
-    const float factor     {(minimum / (minimum + attenuation * (std::max(distance, minimum) - minimum))) * volume};
+    if(partition_count <= 1)
+    {
+        for(const auto& sound : m_sounds_data)
+        {
+            mix_sound(listener, sound, output, frame_count);
+        }
 
-    if(listener.state.channel_count == 1)
+        return;
+    }
+
+    //Each partition accumulates a subset of the sounds in its own buffer, they are summed once every partition is done
+    const auto size{std::size(output)};
+    m_mix_buffer.resize(partition_count * size);
+
+    m_workers.run(partition_count, [this, &listener, partition_count, size, frame_count](std::size_t partition)
     {
-        for(std::size_t i{}; i < frame_count; ++i)
+        const std::span<float> buffer{std::data(m_mix_buffer) + partition * size, size};
+        std::fill(std::begin(buffer), std::end(buffer), 0.0f);
+
+        const auto begin{std::size(m_sounds_data) * partition / partition_count};
+        const auto end  {std::size(m_sounds_data) * (partition + 1) / partition_count};
+
+        for(auto i{begin}; i < end; ++i)
         {
-            m_listener_samples[i] += sound.samples[i] * factor;
+            mix_sound(listener, m_sounds_data[i], buffer, frame_count);
         }
+    });
+
+    for(std::size_t partition{}; partition < partition_count; ++partition)
+    {
+        m_kernels->accumulate(std::data(output), std::data(m_mix_buffer) + partition * size, size, 1.0f);
+    }
+}
+
+void audio_world::mix_sound(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) const noexcept
+{
+    if(sound.state.channel_count == 1 && listener.state.spatialization.enable && sound.state.spatialization.enable)
+    {
+        spatialize(listener, sound, output, frame_count);
+    }
+    else if(sound.state.channel_count != listener.state.channel_count)
+    {
+        adjust_channels(listener, sound, output, frame_count);
+    }
+    else //no spacialization and sound.state.channel_count == listener.state.channel_count
+    {
+        m_kernels->accumulate(std::data(output), std::data(sound.samples), std::size(sound.samples), sound.state.volume * listener.state.volume);
+    }
+}
+
+void audio_world::spatialize(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) const noexcept
+{
+    const vec3f listener_position{listener.state.spatialization.position};
+    const vec3f sound_position   {get_sound_position(listener.state.spatialization, sound.state.spatialization)};
+
+    const float volume{sound.state.volume * listener.state.volume};
+    const float factor{distance_gain(listener.state.spatialization, sound.state.spatialization) * volume};
+
+    if(listener.state.channel_count == 1)
+    {
+        m_kernels->accumulate(std::data(output), std::data(sound.samples), frame_count, factor);
 
         return;
     }
@@ -745,11 +1156,10 @@ void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer&
 
     if(listener.state.channel_count == 2)
     {
-        for(std::size_t i{}; i < frame_count; ++i)
-        {
-            m_listener_samples[i * 2]     += sound.samples[i] * factor * ((-sine) + 2.0f) / 4.0f; //right
-            m_listener_samples[i * 2 + 1] += sound.samples[i] * factor * (sine + 2.0f) / 4.0f; //left
-        }
+        const float right{factor * ((-sine) + 2.0f) / 4.0f};
+        const float left {factor * (sine + 2.0f) / 4.0f};
+
+        m_kernels->pan(std::data(output), std::data(sound.samples), frame_count, right, left);
     }
     else
     {
@@ -757,37 +1167,23 @@ void audio_world::spatialize(listener_data_buffer& listener, sound_data_buffer&
     }
 }
 
-void audio_world::adjust_channels(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept
+void audio_world::adjust_channels(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) const noexcept
 {
     const float volume{sound.state.volume * listener.state.volume};
 
     if(listener.state.channel_count == 2 && sound.state.channel_count == 1) //Mono -> Stereo
     {
-        for(std::size_t i{}; i < frame_count; ++i)
-        {
-            const float sample{sound.samples[i] * volume};
-
-            m_listener_samples[i * 2]     += sample; //right
-            m_listener_samples[i * 2 + 1] += sample; //left
-        }
+        m_kernels->pan(std::data(output), std::data(sound.samples), frame_count, volume, volume);
     }
     else if(listener.state.channel_count == 1 && sound.state.channel_count == 2)
     {
-        for(std::size_t i{}; i < frame_count; ++i)
-        {
-            const float sample{(sound.samples[i * 2] + sound.samples[i * 2 + 1]) * volume};
-
-            m_listener_samples[i] += mix_amplitude(sample, 2);
-        }
+        m_kernels->downmix(std::data(output), std::data(sound.samples), frame_count, volume);
     }
 }
 
-void audio_world::mix_sounds()
+void audio_world::mix_sounds(std::span<float> output) const noexcept
 {
-    for(auto& sample : m_listener_samples)
-    {
-        sample = mix_amplitude(sample, std::size(m_sounds_data));
-    }
+    m_kernels->soft_clip(std::data(output), std::size(output), m_playing_voice_count);
 }
 
 void audio_world::free_resources()
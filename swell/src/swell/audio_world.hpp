@@ -30,11 +30,18 @@
 #include <vector>
 #include <memory>
 #include <mutex>
-#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <bit>
 #include <span>
+#include <array>
+#include <thread>
 
 #include "sound_reader.hpp"
 #include "stream.hpp"
+#include "worker_pool.hpp"
+#include "mixing.hpp"
+#include "resampler.hpp"
 
 namespace swl
 {
@@ -45,12 +52,18 @@ class audio_world;
 
 class audio_queue
 {
-    friend class audio_world;
+    static constexpr std::size_t cache_line_size{64};
+
+public:
+    static constexpr std::size_t default_capacity{65536};
 
 public:
-    audio_queue(std::size_t reserved = 0)
+    explicit audio_queue(std::size_t capacity = default_capacity)
+    :m_capacity{std::bit_ceil(std::max(capacity, std::size_t{2}))}
+    ,m_mask{m_capacity - 1}
+    ,m_data{std::make_unique<float[]>(m_capacity)}
     {
-        m_data.reserve(reserved);
+
     }
 
     ~audio_queue() = default;
@@ -59,95 +72,209 @@ public:
     audio_queue(audio_queue&&) noexcept = delete;
     audio_queue& operator=(audio_queue&&) noexcept = delete;
 
+    //Producer side, begin() returns a zeroed block that will be pushed by end()
     std::span<float> begin(std::size_t size)
     {
-        const auto begin{std::size(m_data)};
-        m_data.resize(begin + size);
+        m_pending.clear();
+        m_pending.resize(size);
 
-        return std::span{std::data(m_data) + begin, size};
+        return std::span{m_pending};
     }
 
     void end()
     {
-        m_buffered.store(std::size(m_data), std::memory_order_release);
+        const auto write{m_write.load(std::memory_order_relaxed)};
+        const auto read {m_read.load(std::memory_order_acquire)};
+        const auto count{std::min(std::size(m_pending), m_capacity - (write - read))};
 
-        m_condition.notify_one();
-    }
+        const auto offset{write & m_mask};
+        const auto first {std::min(count, m_capacity - offset)};
 
-    void lock()
-    {
-        m_mutex.lock();
-    }
+        std::copy_n(std::data(m_pending), first, m_data.get() + offset);
+        std::copy_n(std::data(m_pending) + first, count - first, m_data.get());
 
-    void unlock()
-    {
-        m_mutex.unlock();
+        if(count < std::size(m_pending))
+        {
+            m_overflows.fetch_add(std::size(m_pending) - count, std::memory_order_relaxed);
+        }
+
+        m_write.store(write + count, std::memory_order_release);
     }
 
+    //Consumer side, never blocks nor allocates. Missing samples are replaced by silence and counted as underflows.
     template<typename OutputIt>
     void drain(OutputIt output, std::size_t count)
     {
-        std::unique_lock lock{m_mutex};
+        const auto read {m_read.load(std::memory_order_relaxed)};
+        const auto write{m_write.load(std::memory_order_acquire)};
+        const auto available{std::min(write - read, count)};
+
+        output = copy_out(read, available, output);
+        std::fill_n(output, count - available, 0.0f);
 
-        if(std::size(m_data) < count)
+        if(available < count)
         {
-            m_condition.wait(lock, [this, count]
-            {
-                return buffered() >= count;
-            });
+            m_underflows.fetch_add(count - available, std::memory_order_relaxed);
         }
 
-        m_buffered -= count;
-
-        std::copy_n(std::begin(m_data), count, output);
-        m_data.erase(std::begin(m_data), std::begin(m_data) + count);
+        m_read.store(read + available, std::memory_order_release);
+        signal_drain();
     }
 
     template<typename OutputIt>
     std::size_t drain_n(OutputIt output, std::size_t count)
     {
-        std::unique_lock lock{m_mutex};
+        const auto read {m_read.load(std::memory_order_relaxed)};
+        const auto write{m_write.load(std::memory_order_acquire)};
 
-        count = std::min(buffered(), count);
-        m_buffered -= count;
+        count = std::min(write - read, count);
+        copy_out(read, count, output);
 
-        std::copy_n(std::begin(m_data), count, output);
-        m_data.erase(std::begin(m_data), std::begin(m_data) + count);
+        m_read.store(read + count, std::memory_order_release);
+        signal_drain();
 
         return count;
     }
 
-    void discard(std::size_t count)
+    void discard(std::size_t count) noexcept
     {
-        std::unique_lock lock{m_mutex};
+        const auto read {m_read.load(std::memory_order_relaxed)};
+        const auto write{m_write.load(std::memory_order_acquire)};
 
-        m_data.erase(std::begin(m_data), std::begin(m_data) + count);
-        m_buffered.store(std::size(m_data), std::memory_order_release);
+        m_read.store(read + std::min(write - read, count), std::memory_order_release);
+        signal_drain();
     }
 
-    void discard()
+    void discard() noexcept
     {
-        std::unique_lock lock{m_mutex};
+        m_read.store(m_write.load(std::memory_order_acquire), std::memory_order_release);
+        signal_drain();
+    }
+
+    //The signal is incremented and notified (futex wake) each time the consumer takes samples, so a producer can sleep on it.
+    //When it returns, the consumer does not use the previous signal anymore, so it can be destroyed.
+    void set_drain_signal(std::atomic<std::uint64_t>* signal) noexcept
+    {
+        m_drain_signal.store(signal, std::memory_order_seq_cst);
+
+        //The consumer may have loaded the previous signal just before the store, it only holds it for a few instructions
+        while(m_drain_signal_users.load(std::memory_order_seq_cst) != 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    std::size_t buffered() const noexcept
+    {
+        const auto read{m_read.load(std::memory_order_acquire)};
 
-        m_data.clear();
-        m_buffered.store(0, std::memory_order_release);
+        return m_write.load(std::memory_order_acquire) - read;
     }
 
-    std::size_t buffered()
+    std::size_t capacity() const noexcept
     {
-        return m_buffered.load(std::memory_order_acquire);
+        return m_capacity;
+    }
+
+    std::size_t underflows() const noexcept
+    {
+        return m_underflows.load(std::memory_order_relaxed);
+    }
+
+    std::size_t overflows() const noexcept
+    {
+        return m_overflows.load(std::memory_order_relaxed);
+    }
+
+private:
+    void signal_drain() noexcept
+    {
+        //Announced before loading the signal, so set_drain_signal either sees this thread or the consumer sees the new signal
+        m_drain_signal_users.fetch_add(1, std::memory_order_seq_cst);
+
+        if(const auto signal{m_drain_signal.load(std::memory_order_seq_cst)}; signal)
+        {
+            signal->fetch_add(1, std::memory_order_release);
+            signal->notify_one();
+        }
+
+        m_drain_signal_users.fetch_sub(1, std::memory_order_release);
+    }
+
+    template<typename OutputIt>
+    OutputIt copy_out(std::size_t read, std::size_t count, OutputIt output)
+    {
+        const auto offset{read & m_mask};
+        const auto first {std::min(count, m_capacity - offset)};
+
+        output = std::copy_n(m_data.get() + offset, first, output);
+
+        return std::copy_n(m_data.get(), count - first, output);
     }
 
 private:
-    std::mutex m_mutex{};
-    std::condition_variable m_condition{};
-    std::atomic<std::size_t> m_buffered{};
-    std::vector<float> m_data{};
+    std::size_t m_capacity{};
+    std::size_t m_mask{};
+    std::unique_ptr<float[]> m_data{};
+    std::vector<float> m_pending{};
+    alignas(cache_line_size) std::atomic<std::size_t> m_write{};
+    std::atomic<std::size_t> m_overflows{};
+    alignas(cache_line_size) std::atomic<std::size_t> m_read{};
+    std::atomic<std::size_t> m_underflows{};
+    std::atomic<std::atomic<std::uint64_t>*> m_drain_signal{};
+    std::atomic<std::uint32_t> m_drain_signal_users{};
 };
 
 namespace impl
 {
 
+//Wait-free exchange of the latest value of a T between one producer and one consumer.
+//Each side owns a slot, the third one is shared: store() swaps the producer's slot with the shared one,
+//load() swaps the shared slot with the consumer's one if something was stored since the previous call.
+template<typename T>
+class triple_buffer
+{
+    static constexpr std::uint32_t index_mask{3};
+    static constexpr std::uint32_t dirty_bit{4};
+
+public:
+    triple_buffer() = default;
+
+    explicit triple_buffer(const T& value)
+    :m_slots{value, value, value}
+    {
+
+    }
+
+    ~triple_buffer() = default;
+    triple_buffer(const triple_buffer&) = delete;
+    triple_buffer& operator=(const triple_buffer&) = delete;
+    triple_buffer(triple_buffer&&) noexcept = delete;
+    triple_buffer& operator=(triple_buffer&&) noexcept = delete;
+
+    void store(const T& value) noexcept
+    {
+        m_slots[m_back] = value;
+        m_back = m_shared.exchange(m_back | dirty_bit, std::memory_order_acq_rel) & index_mask;
+    }
+
+    const T& load() noexcept
+    {
+        if(m_shared.load(std::memory_order_relaxed) & dirty_bit)
+        {
+            m_front = m_shared.exchange(m_front, std::memory_order_acq_rel) & index_mask;
+        }
+
+        return m_slots[m_front];
+    }
+
+private:
+    std::array<T, 3> m_slots{};
+    std::uint32_t m_back{0};
+    alignas(64) std::atomic<std::uint32_t> m_shared{1};
+    alignas(64) std::uint32_t m_front{2};
+};
+
 struct listener_spatialization
 {
     bool enable{true};
@@ -164,20 +291,27 @@ struct listener_state
 
 struct listener_data
 {
-    listener_state state{};
+    explicit listener_data(std::size_t queue_capacity = audio_queue::default_capacity)
+    :queue{queue_capacity}
+    {
+
+    }
+
+    listener_state state{}; //owner side, published to the audio thread through published
+    triple_buffer<listener_state> published{};
     audio_queue queue{};
-    std::mutex mutex{};
 };
 
 }
 
+//A listener must be changed from one thread at a time, its changes are published to the audio thread without any lock.
 class SWELL_API listener
 {
     friend class audio_world;
 
 public:
     listener() = default;
-    explicit listener(std::uint32_t channel_count);
+    explicit listener(std::uint32_t channel_count, std::size_t queue_capacity = audio_queue::default_capacity);
 
     ~listener() = default;
     listener(const listener&) = delete;
@@ -258,23 +392,60 @@ struct sound_state
     sound_status status{sound_status::stopped};
     sound_status pause_initial_status{sound_status::playing};
     float volume{1.0};
+    float current_volume{1.0}; //volume applied at the end of the last generated block, ramps toward volume
     std::uint32_t channel_count{};
     std::uint64_t loop_begin{};
     std::uint64_t loop_end{std::numeric_limits<std::uint64_t>::max()};
     std::uint64_t fading{std::numeric_limits<std::uint64_t>::max()};
     std::uint64_t current_fading{};
+    std::int32_t priority{};
+    sound_spatialization spatialization{};
+};
+
+//Playback changes requested by the owner. Each change takes a new revision,
+//so the audio thread only applies the changes made since the last control it applied.
+struct sound_control
+{
+    std::uint64_t revision{};
+    sound_status status{sound_status::stopped};
+    sound_status pause_initial_status{sound_status::playing};
+    std::uint64_t status_revision{};
+    std::uint64_t restart_revision{}; //the volume does not ramp from the one of the previous playback
+    std::uint64_t fading{std::numeric_limits<std::uint64_t>::max()};
+    std::uint64_t fading_revision{};
+    std::uint64_t position{};
+    std::uint64_t position_revision{};
+    std::uint64_t loop_begin{};
+    std::uint64_t loop_end{std::numeric_limits<std::uint64_t>::max()};
+    std::uint64_t loop_revision{};
+};
+
+//Written by the owner of the sound at any time, read by the audio thread once per block without any lock
+struct sound_parameters
+{
+    float volume{1.0f};
+    std::int32_t priority{};
     sound_spatialization spatialization{};
+    sound_control control{};
 };
 
 struct sound_data
 {
-    std::unique_ptr<sound_reader> reader{};
-    sound_state state{};
-    std::mutex mutex{};
+    std::unique_ptr<sound_reader> reader{}; //only changed by the owner while the audio thread does not use it
+    std::uint32_t sample_rate{}; //world's sample rate, readers with another frequency are resampled
+    resampling_quality resampling{resampling_quality::sinc};
+    sound_state state{}; //audio thread side, updated from published at the beginning of each block
+    sound_control applied{}; //audio thread side
+    sound_parameters parameters{}; //owner side
+    triple_buffer<sound_parameters> published{};
+    std::atomic<std::uint64_t> published_status{}; //written by the audio thread, applied control revision << 8 | status
+    std::atomic<std::uint64_t> published_position{}; //written by the audio thread before published_status
 };
 
 }
 
+//A sound must be used from one thread at a time, its changes are published to the audio thread without any lock.
+//Getters return the state requested by the owner until the audio thread has applied it.
 class SWELL_API sound
 {
 public:
@@ -317,6 +488,7 @@ public:
     void move(const vec3f& relative);
     void move_to(const vec3f& position);
     void seek(std::uint64_t frame);
+    void set_priority(std::int32_t priority);
 
     template<typename Rep1, typename Period1, typename Rep2, typename Period2>
     void set_loop_points(std::chrono::duration<Rep1, Period1> begin, std::chrono::duration<Rep2, Period2> end)
@@ -341,6 +513,7 @@ public:
     float attenuation() const;
     vec3f position() const;
     std::uint64_t tell() const;
+    std::int32_t priority() const;
 
     template<typename DurationT>
     DurationT frames_to_time(std::uint64_t frames) const
@@ -358,6 +531,15 @@ private:
     impl::sound_data* m_data{};
 };
 
+//Voices that are not worth mixing only have their position advanced, as if they were discarded.
+//A voice is audible if its highest gain over all listeners (volume and distance attenuation) is above the threshold.
+//If more voices are audible than the budget allows, the ones with the highest priority, then the highest gain, are kept.
+struct virtualization_info
+{
+    float audibility_threshold{}; //the default only virtualizes silent voices, 0.0001f is about -80dB
+    std::size_t max_real_voices{std::numeric_limits<std::size_t>::max()};
+};
+
 class SWELL_API audio_world
 {
     template<typename T>
@@ -378,7 +560,7 @@ class SWELL_API audio_world
 
 public:
     audio_world() = default;
-    explicit audio_world(std::uint32_t sample_rate);
+    explicit audio_world(std::uint32_t sample_rate, std::size_t worker_count = 0);
 
     ~audio_world() = default;
     audio_world(const audio_world&) = delete;
@@ -393,27 +575,52 @@ public:
     {
         static_assert(sizeof...(Listeners) != 0 && (std::is_same_v<listener, std::decay_t<Listeners>> && ...), "One of the parameters is not a swl::listener.");
 
-        const std::array locks{std::lock_guard{listeners.m_data->mutex}...};
-        (m_listeners_data.emplace_back(&listeners.m_data->queue, listeners.m_data->state), ...);
+        //Listeners must always be bound from the same thread, it is the consumer of their published state
+        (m_listeners_data.emplace_back(&listeners.m_data->queue, listeners.m_data->published.load()), ...);
     }
 
     void discard(std::size_t frame_count);
     void generate(std::size_t frame_count);
 
+    void set_virtualization(const virtualization_info& info);
+
     vec3f up() const;
+    virtualization_info virtualization() const;
+
+    //Voice counts of the last generated block
+    std::size_t real_voice_count() const;
+    std::size_t virtual_voice_count() const;
 
     std::uint32_t sample_rate() const noexcept
     {
         return m_sample_rate;
     }
 
+    std::size_t worker_count() const noexcept
+    {
+        return m_workers.thread_count();
+    }
+
+    //Only affects sounds created after the call
+    void set_resampling_quality(resampling_quality quality) noexcept
+    {
+        m_resampling_quality = quality;
+    }
+
+    resampling_quality resampling() const noexcept
+    {
+        return m_resampling_quality;
+    }
+
     impl::sound_data* make_sound();
 
 private:
     struct sound_data_buffer
     {
+        impl::sound_data* sound{};
         std::span<float> samples{};
         impl::sound_state state{};
+        float audibility{};
     };
 
     struct listener_data_buffer
@@ -427,26 +634,39 @@ private:
     void discard_sound_data(impl::sound_data& sound, std::size_t frame_count);
 
     void store_sounds_data(std::size_t frame_count);
-    std::span<float> get_sound_data(impl::sound_data& sound, std::size_t frame_count);
-
-    void apply_fading(sound_data_buffer& sound, std::size_t frame_count);
-    void spatialize(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept;
-    void adjust_channels(listener_data_buffer& listener, sound_data_buffer& sound, std::size_t frame_count) noexcept;
-    void mix_sounds();
+    void virtualize_sounds(std::size_t frame_count);
+    float audibility(const impl::sound_state& state) const noexcept;
+    void read_sound_data(sound_data_buffer& sound, std::size_t frame_count) noexcept;
+    void get_sound_data(impl::sound_data& sound, std::span<float> output, std::size_t frame_count);
+
+    void apply_gain(sound_data_buffer& sound, std::size_t frame_count) noexcept;
+    void mix_listener(const listener_data_buffer& listener, std::span<float> output, std::size_t frame_count);
+    void mix_sound(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) const noexcept;
+    void spatialize(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) const noexcept;
+    void adjust_channels(const listener_data_buffer& listener, const sound_data_buffer& sound, std::span<float> output, std::size_t frame_count) const noexcept;
+    void mix_sounds(std::span<float> output) const noexcept;
 
     void free_resources();
 
 private:
     std::uint32_t m_sample_rate{};
+    resampling_quality m_resampling_quality{resampling_quality::sinc};
 
     vec3f m_up{0.0f, 1.0f, 0.0f};
 
+    virtualization_info m_virtualization{};
+    std::size_t m_real_voice_count{};
+    std::size_t m_virtual_voice_count{};
+    std::size_t m_playing_voice_count{}; //real and virtual voices, the mix amplitude depends on all of them
+
     std::vector<std::unique_ptr<impl::sound_data>> m_sounds{};
     std::vector<float, default_init_allocator<float>> m_sample_buffer{};
     std::vector<sound_data_buffer> m_sounds_data{};
     std::vector<listener_data_buffer> m_listeners_data{};
+    std::vector<float, default_init_allocator<float>> m_mix_buffer{};
 
-    std::span<float> m_listener_samples{};
+    worker_pool m_workers{};
+    const mixing_kernels* m_kernels{&get_mixing_kernels()};
 
     mutable std::mutex m_mutex{};
 };
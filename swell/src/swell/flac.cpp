@@ -21,6 +21,7 @@
 //SOFTWARE.
 
 #include "flac.hpp"
+#include "pcm.hpp"
 
 #include <cassert>
 #include <algorithm>
@@ -198,15 +199,8 @@ static FLAC__StreamDecoderWriteStatus common_write(const FLAC__StreamDecoder* de
     context.buffer_index = 0;
 
     const float factor{get_factor(frame->header.bits_per_sample)};
-    std::size_t index{};
 
-    for(std::uint32_t i{}; i < frame->header.blocksize; ++i)
-    {
-        for(std::uint32_t j{}; j < frame->header.channels; ++j)
-        {
-            context.buffer[index++] = static_cast<float>(buffer[j][i]) * factor;
-        }
-    }
+    get_pcm_kernels().interleave_s32(std::data(context.buffer), buffer, frame->header.blocksize, frame->header.channels, factor);
 
     return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
@@ -236,6 +230,15 @@ flac_reader::flac_reader(const std::filesystem::path& file, sound_reader_options
 ,m_decoder{FLAC__stream_decoder_new()}
 ,m_context{std::make_unique<impl::flac_context>()}
 {
+    if(static_cast<bool>(m_options & sound_reader_options::mapped))
+    {
+        m_context->mapping = mapped_file{file};
+        m_context->source.data = m_context->mapping.data();
+        init_from_memory();
+
+        return;
+    }
+
     std::ifstream ifs{file, std::ios_base::binary};
     if(!ifs)
         throw std::runtime_error{"swl::flac_reader can not open file \"" + file.string() + "\"."};
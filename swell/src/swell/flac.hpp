@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "sound_reader.hpp"
+#include "mapped_file.hpp"
 
 namespace swl
 {
@@ -49,6 +50,7 @@ struct flac_context
 {
     std::vector<std::uint8_t> source_buffer{};
     std::ifstream file{};
+    mapped_file mapping{};
 
     flac_memory_stream source{};
     std::istream* stream{};
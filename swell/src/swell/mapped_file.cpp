@@ -0,0 +1,157 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "mapped_file.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace swl
+{
+
+#if defined(_WIN32)
+
+mapped_file::mapped_file(const std::filesystem::path& file)
+{
+    const HANDLE handle{CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr)};
+    if(handle == INVALID_HANDLE_VALUE)
+        throw std::runtime_error{"Can not open file \"" + file.string() + "\"."};
+
+    LARGE_INTEGER size{};
+    if(!GetFileSizeEx(handle, &size))
+    {
+        CloseHandle(handle);
+        throw std::runtime_error{"Can not get size of file \"" + file.string() + "\"."};
+    }
+
+    if(size.QuadPart == 0)
+    {
+        CloseHandle(handle);
+        return;
+    }
+
+    const HANDLE mapping{CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+    CloseHandle(handle);
+
+    if(!mapping)
+        throw std::runtime_error{"Can not map file \"" + file.string() + "\"."};
+
+    //The view keeps the mapping object alive
+    const auto view{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+    CloseHandle(mapping);
+
+    if(!view)
+        throw std::runtime_error{"Can not map file \"" + file.string() + "\"."};
+
+    m_data = static_cast<const std::uint8_t*>(view);
+    m_size = static_cast<std::size_t>(size.QuadPart);
+}
+
+void mapped_file::unmap() noexcept
+{
+    if(m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+}
+
+#else
+
+mapped_file::mapped_file(const std::filesystem::path& file)
+{
+    const int descriptor{open(file.c_str(), O_RDONLY)};
+    if(descriptor == -1)
+        throw std::runtime_error{"Can not open file \"" + file.string() + "\"."};
+
+    struct stat status{};
+    if(fstat(descriptor, &status) == -1)
+    {
+        close(descriptor);
+        throw std::runtime_error{"Can not get size of file \"" + file.string() + "\"."};
+    }
+
+    if(status.st_size == 0)
+    {
+        close(descriptor);
+        return;
+    }
+
+    const auto size{static_cast<std::size_t>(status.st_size)};
+    void* const address{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0)};
+
+    //The mapping stays valid once the descriptor is closed
+    close(descriptor);
+
+    if(address == MAP_FAILED)
+        throw std::runtime_error{"Can not map file \"" + file.string() + "\"."};
+
+    madvise(address, size, MADV_SEQUENTIAL);
+
+    m_data = static_cast<const std::uint8_t*>(address);
+    m_size = size;
+}
+
+void mapped_file::unmap() noexcept
+{
+    if(m_data)
+    {
+        munmap(const_cast<std::uint8_t*>(m_data), m_size);
+    }
+}
+
+#endif
+
+mapped_file::~mapped_file()
+{
+    unmap();
+}
+
+mapped_file::mapped_file(mapped_file&& other) noexcept
+:m_data{std::exchange(other.m_data, nullptr)}
+,m_size{std::exchange(other.m_size, 0)}
+{
+
+}
+
+mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+{
+    if(this != &other)
+    {
+        unmap();
+
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+
+    return *this;
+}
+
+}
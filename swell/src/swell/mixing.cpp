@@ -0,0 +1,601 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "mixing.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SWELL_MIXING_X86
+
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+
+        #define SWELL_TARGET_AVX2
+    #else
+        #define SWELL_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define SWELL_MIXING_SSE2
+    #endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #define SWELL_MIXING_NEON
+
+    #include <arm_neon.h>
+#endif
+
+namespace swl
+{
+
+//Scalar kernels, they also process the remaining samples of the vectorized ones
+
+static constexpr float sign(float value) noexcept
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+//Same multiplication sequence as the vectorized kernels, so the results are identical
+static float power(float value, bool odd, std::size_t half) noexcept
+{
+    float output{odd ? value : 1.0f};
+
+    for(auto i{half}; i != 0; i /= 2)
+    {
+        value *= value;
+
+        if(i % 2 == 1)
+        {
+            output *= value;
+        }
+    }
+
+    return output;
+}
+
+static void accumulate_scalar(float* output, const float* input, std::size_t sample_count, float gain) noexcept
+{
+    for(std::size_t i{}; i < sample_count; ++i)
+    {
+        output[i] += input[i] * gain;
+    }
+}
+
+static void pan_scalar(float* output, const float* input, std::size_t frame_count, float right_gain, float left_gain) noexcept
+{
+    for(std::size_t i{}; i < frame_count; ++i)
+    {
+        output[i * 2]     += input[i] * right_gain;
+        output[i * 2 + 1] += input[i] * left_gain;
+    }
+}
+
+static void downmix_scalar(float* output, const float* input, std::size_t frame_count, float gain) noexcept
+{
+    for(std::size_t i{}; i < frame_count; ++i)
+    {
+        const float sample{(input[i * 2] + input[i * 2 + 1]) * gain};
+        const float value {1.0f - std::abs(sample)};
+
+        output[i] += sign(sample) * (1.0f - value * value);
+    }
+}
+
+static void soft_clip_scalar(float* samples, std::size_t sample_count, std::size_t sound_count) noexcept
+{
+    if(sound_count == 0)
+    {
+        return;
+    }
+
+    const bool odd{sound_count % 2 == 1};
+    const auto half{sound_count / 2};
+
+    for(std::size_t i{}; i < sample_count; ++i)
+    {
+        samples[i] = sign(samples[i]) * (1.0f - power(1.0f - std::abs(samples[i]), odd, half));
+    }
+}
+
+static float dot_scalar(const float* left, const float* right, std::size_t count) noexcept
+{
+    float output{};
+
+    for(std::size_t i{}; i < count; ++i)
+    {
+        output += left[i] * right[i];
+    }
+
+    return output;
+}
+
+static constexpr mixing_kernels scalar_kernels{simd_level::none, accumulate_scalar, pan_scalar, downmix_scalar, soft_clip_scalar, dot_scalar};
+
+#ifdef SWELL_MIXING_SSE2
+
+static void accumulate_sse2(float* output, const float* input, std::size_t sample_count, float gain) noexcept
+{
+    const __m128 gains{_mm_set1_ps(gain)};
+
+    std::size_t i{};
+    for(; i + 4 <= sample_count; i += 4)
+    {
+        const __m128 samples{_mm_mul_ps(_mm_loadu_ps(input + i), gains)};
+
+        _mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i), samples));
+    }
+
+    accumulate_scalar(output + i, input + i, sample_count - i, gain);
+}
+
+static void pan_sse2(float* output, const float* input, std::size_t frame_count, float right_gain, float left_gain) noexcept
+{
+    const __m128 gains{_mm_setr_ps(right_gain, left_gain, right_gain, left_gain)};
+
+    std::size_t i{};
+    for(; i + 4 <= frame_count; i += 4)
+    {
+        const __m128 samples{_mm_loadu_ps(input + i)};
+        const __m128 low    {_mm_mul_ps(_mm_unpacklo_ps(samples, samples), gains)};
+        const __m128 high   {_mm_mul_ps(_mm_unpackhi_ps(samples, samples), gains)};
+
+        _mm_storeu_ps(output + i * 2,     _mm_add_ps(_mm_loadu_ps(output + i * 2), low));
+        _mm_storeu_ps(output + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(output + i * 2 + 4), high));
+    }
+
+    pan_scalar(output + i * 2, input + i, frame_count - i, right_gain, left_gain);
+}
+
+static void downmix_sse2(float* output, const float* input, std::size_t frame_count, float gain) noexcept
+{
+    const __m128 gains    {_mm_set1_ps(gain)};
+    const __m128 ones     {_mm_set1_ps(1.0f)};
+    const __m128 sign_mask{_mm_set1_ps(-0.0f)};
+
+    std::size_t i{};
+    for(; i + 4 <= frame_count; i += 4)
+    {
+        const __m128 first  {_mm_loadu_ps(input + i * 2)};
+        const __m128 second {_mm_loadu_ps(input + i * 2 + 4)};
+        const __m128 sum    {_mm_add_ps(_mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)))};
+        const __m128 samples{_mm_mul_ps(sum, gains)};
+        const __m128 value  {_mm_sub_ps(ones, _mm_andnot_ps(sign_mask, samples))};
+        const __m128 clipped{_mm_xor_ps(_mm_sub_ps(ones, _mm_mul_ps(value, value)), _mm_and_ps(samples, sign_mask))};
+
+        _mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i), clipped));
+    }
+
+    downmix_scalar(output + i, input + i * 2, frame_count - i, gain);
+}
+
+static void soft_clip_sse2(float* samples, std::size_t sample_count, std::size_t sound_count) noexcept
+{
+    if(sound_count == 0)
+    {
+        return;
+    }
+
+    const bool odd{sound_count % 2 == 1};
+    const auto half{sound_count / 2};
+
+    const __m128 ones     {_mm_set1_ps(1.0f)};
+    const __m128 sign_mask{_mm_set1_ps(-0.0f)};
+
+    std::size_t i{};
+    for(; i + 4 <= sample_count; i += 4)
+    {
+        const __m128 sample{_mm_loadu_ps(samples + i)};
+
+        __m128 value {_mm_sub_ps(ones, _mm_andnot_ps(sign_mask, sample))};
+        __m128 output{odd ? value : ones};
+
+        for(auto j{half}; j != 0; j /= 2)
+        {
+            value = _mm_mul_ps(value, value);
+
+            if(j % 2 == 1)
+            {
+                output = _mm_mul_ps(output, value);
+            }
+        }
+
+        _mm_storeu_ps(samples + i, _mm_xor_ps(_mm_sub_ps(ones, output), _mm_and_ps(sample, sign_mask)));
+    }
+
+    soft_clip_scalar(samples + i, sample_count - i, sound_count);
+}
+
+static float dot_sse2(const float* left, const float* right, std::size_t count) noexcept
+{
+    __m128 sum{_mm_setzero_ps()};
+
+    std::size_t i{};
+    for(; i + 4 <= count; i += 4)
+    {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(left + i), _mm_loadu_ps(right + i)));
+    }
+
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+
+    return _mm_cvtss_f32(sum) + dot_scalar(left + i, right + i, count - i);
+}
+
+static constexpr mixing_kernels sse2_kernels{simd_level::sse2, accumulate_sse2, pan_sse2, downmix_sse2, soft_clip_sse2, dot_sse2};
+
+#endif
+
+#ifdef SWELL_MIXING_X86
+
+SWELL_TARGET_AVX2 static void accumulate_avx2(float* output, const float* input, std::size_t sample_count, float gain) noexcept
+{
+    const __m256 gains{_mm256_set1_ps(gain)};
+
+    std::size_t i{};
+    for(; i + 8 <= sample_count; i += 8)
+    {
+        const __m256 samples{_mm256_mul_ps(_mm256_loadu_ps(input + i), gains)};
+
+        _mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_loadu_ps(output + i), samples));
+    }
+
+    _mm256_zeroupper(); //Avoid AVX to SSE transition penalties in the scalar code that follows
+
+    accumulate_scalar(output + i, input + i, sample_count - i, gain);
+}
+
+SWELL_TARGET_AVX2 static void pan_avx2(float* output, const float* input, std::size_t frame_count, float right_gain, float left_gain) noexcept
+{
+    const __m256 gains{_mm256_setr_ps(right_gain, left_gain, right_gain, left_gain, right_gain, left_gain, right_gain, left_gain)};
+
+    std::size_t i{};
+    for(; i + 8 <= frame_count; i += 8)
+    {
+        const __m256 samples{_mm256_loadu_ps(input + i)};
+        const __m256 low    {_mm256_unpacklo_ps(samples, samples)}; //0 0 1 1 | 4 4 5 5
+        const __m256 high   {_mm256_unpackhi_ps(samples, samples)}; //2 2 3 3 | 6 6 7 7
+        const __m256 first  {_mm256_mul_ps(_mm256_permute2f128_ps(low, high, 0x20), gains)};
+        const __m256 second {_mm256_mul_ps(_mm256_permute2f128_ps(low, high, 0x31), gains)};
+
+        _mm256_storeu_ps(output + i * 2,     _mm256_add_ps(_mm256_loadu_ps(output + i * 2), first));
+        _mm256_storeu_ps(output + i * 2 + 8, _mm256_add_ps(_mm256_loadu_ps(output + i * 2 + 8), second));
+    }
+
+    _mm256_zeroupper();
+
+    pan_scalar(output + i * 2, input + i, frame_count - i, right_gain, left_gain);
+}
+
+SWELL_TARGET_AVX2 static void downmix_avx2(float* output, const float* input, std::size_t frame_count, float gain) noexcept
+{
+    const __m256 gains    {_mm256_set1_ps(gain)};
+    const __m256 ones     {_mm256_set1_ps(1.0f)};
+    const __m256 sign_mask{_mm256_set1_ps(-0.0f)};
+
+    std::size_t i{};
+    for(; i + 8 <= frame_count; i += 8)
+    {
+        const __m256 first  {_mm256_loadu_ps(input + i * 2)};
+        const __m256 second {_mm256_loadu_ps(input + i * 2 + 8)};
+        const __m256 sum    {_mm256_add_ps(_mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)), _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)))}; //0 1 4 5 | 2 3 6 7
+        const __m256 ordered{_mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0)))};
+        const __m256 samples{_mm256_mul_ps(ordered, gains)};
+        const __m256 value  {_mm256_sub_ps(ones, _mm256_andnot_ps(sign_mask, samples))};
+        const __m256 clipped{_mm256_xor_ps(_mm256_sub_ps(ones, _mm256_mul_ps(value, value)), _mm256_and_ps(samples, sign_mask))};
+
+        _mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_loadu_ps(output + i), clipped));
+    }
+
+    _mm256_zeroupper();
+
+    downmix_scalar(output + i, input + i * 2, frame_count - i, gain);
+}
+
+SWELL_TARGET_AVX2 static void soft_clip_avx2(float* samples, std::size_t sample_count, std::size_t sound_count) noexcept
+{
+    if(sound_count == 0)
+    {
+        return;
+    }
+
+    const bool odd{sound_count % 2 == 1};
+    const auto half{sound_count / 2};
+
+    const __m256 ones     {_mm256_set1_ps(1.0f)};
+    const __m256 sign_mask{_mm256_set1_ps(-0.0f)};
+
+    std::size_t i{};
+    for(; i + 8 <= sample_count; i += 8)
+    {
+        const __m256 sample{_mm256_loadu_ps(samples + i)};
+
+        __m256 value {_mm256_sub_ps(ones, _mm256_andnot_ps(sign_mask, sample))};
+        __m256 output{odd ? value : ones};
+
+        for(auto j{half}; j != 0; j /= 2)
+        {
+            value = _mm256_mul_ps(value, value);
+
+            if(j % 2 == 1)
+            {
+                output = _mm256_mul_ps(output, value);
+            }
+        }
+
+        _mm256_storeu_ps(samples + i, _mm256_xor_ps(_mm256_sub_ps(ones, output), _mm256_and_ps(sample, sign_mask)));
+    }
+
+    _mm256_zeroupper();
+
+    soft_clip_scalar(samples + i, sample_count - i, sound_count);
+}
+
+SWELL_TARGET_AVX2 static float dot_avx2(const float* left, const float* right, std::size_t count) noexcept
+{
+    __m256 sum{_mm256_setzero_ps()};
+
+    std::size_t i{};
+    for(; i + 8 <= count; i += 8)
+    {
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(left + i), _mm256_loadu_ps(right + i)));
+    }
+
+    __m128 half{_mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1))};
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+
+    const float output{_mm_cvtss_f32(half)};
+
+    _mm256_zeroupper();
+
+    return output + dot_scalar(left + i, right + i, count - i);
+}
+
+static constexpr mixing_kernels avx2_kernels{simd_level::avx2, accumulate_avx2, pan_avx2, downmix_avx2, soft_clip_avx2, dot_avx2};
+
+static bool has_avx2() noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    std::array<int, 4> info{};
+
+    __cpuid(std::data(info), 0);
+    if(info[0] < 7)
+    {
+        return false;
+    }
+
+    __cpuid(std::data(info), 1);
+    const bool avx    {(info[2] & (1 << 28)) != 0};
+    const bool osxsave{(info[2] & (1 << 27)) != 0};
+
+    if(!avx || !osxsave || (_xgetbv(0) & 0x06) != 0x06) //The OS must save YMM registers
+    {
+        return false;
+    }
+
+    __cpuidex(std::data(info), 7, 0);
+
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+#ifdef SWELL_MIXING_NEON
+
+static void accumulate_neon(float* output, const float* input, std::size_t sample_count, float gain) noexcept
+{
+    const float32x4_t gains{vdupq_n_f32(gain)};
+
+    std::size_t i{};
+    for(; i + 4 <= sample_count; i += 4)
+    {
+        vst1q_f32(output + i, vaddq_f32(vld1q_f32(output + i), vmulq_f32(vld1q_f32(input + i), gains)));
+    }
+
+    accumulate_scalar(output + i, input + i, sample_count - i, gain);
+}
+
+static void pan_neon(float* output, const float* input, std::size_t frame_count, float right_gain, float left_gain) noexcept
+{
+    const float32x4_t right{vdupq_n_f32(right_gain)};
+    const float32x4_t left {vdupq_n_f32(left_gain)};
+
+    std::size_t i{};
+    for(; i + 4 <= frame_count; i += 4)
+    {
+        const float32x4_t samples{vld1q_f32(input + i)};
+
+        float32x4x2_t channels{vld2q_f32(output + i * 2)};
+        channels.val[0] = vaddq_f32(channels.val[0], vmulq_f32(samples, right));
+        channels.val[1] = vaddq_f32(channels.val[1], vmulq_f32(samples, left));
+
+        vst2q_f32(output + i * 2, channels);
+    }
+
+    pan_scalar(output + i * 2, input + i, frame_count - i, right_gain, left_gain);
+}
+
+static void downmix_neon(float* output, const float* input, std::size_t frame_count, float gain) noexcept
+{
+    const float32x4_t gains    {vdupq_n_f32(gain)};
+    const float32x4_t ones     {vdupq_n_f32(1.0f)};
+    const uint32x4_t  sign_mask{vdupq_n_u32(0x80000000u)};
+
+    std::size_t i{};
+    for(; i + 4 <= frame_count; i += 4)
+    {
+        const float32x4x2_t channels{vld2q_f32(input + i * 2)};
+
+        const float32x4_t samples{vmulq_f32(vaddq_f32(channels.val[0], channels.val[1]), gains)};
+        const float32x4_t value  {vsubq_f32(ones, vabsq_f32(samples))};
+        const float32x4_t clipped{vsubq_f32(ones, vmulq_f32(value, value))};
+        const uint32x4_t  signs  {vandq_u32(vreinterpretq_u32_f32(samples), sign_mask)};
+
+        vst1q_f32(output + i, vaddq_f32(vld1q_f32(output + i), vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(clipped), signs))));
+    }
+
+    downmix_scalar(output + i, input + i * 2, frame_count - i, gain);
+}
+
+static void soft_clip_neon(float* samples, std::size_t sample_count, std::size_t sound_count) noexcept
+{
+    if(sound_count == 0)
+    {
+        return;
+    }
+
+    const bool odd{sound_count % 2 == 1};
+    const auto half{sound_count / 2};
+
+    const float32x4_t ones     {vdupq_n_f32(1.0f)};
+    const uint32x4_t  sign_mask{vdupq_n_u32(0x80000000u)};
+
+    std::size_t i{};
+    for(; i + 4 <= sample_count; i += 4)
+    {
+        const float32x4_t sample{vld1q_f32(samples + i)};
+
+        float32x4_t value {vsubq_f32(ones, vabsq_f32(sample))};
+        float32x4_t output{odd ? value : ones};
+
+        for(auto j{half}; j != 0; j /= 2)
+        {
+            value = vmulq_f32(value, value);
+
+            if(j % 2 == 1)
+            {
+                output = vmulq_f32(output, value);
+            }
+        }
+
+        const uint32x4_t signs{vandq_u32(vreinterpretq_u32_f32(sample), sign_mask)};
+
+        vst1q_f32(samples + i, vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vsubq_f32(ones, output)), signs)));
+    }
+
+    soft_clip_scalar(samples + i, sample_count - i, sound_count);
+}
+
+static float dot_neon(const float* left, const float* right, std::size_t count) noexcept
+{
+    float32x4_t sum{vdupq_n_f32(0.0f)};
+
+    std::size_t i{};
+    for(; i + 4 <= count; i += 4)
+    {
+        sum = vaddq_f32(sum, vmulq_f32(vld1q_f32(left + i), vld1q_f32(right + i)));
+    }
+
+    const float32x2_t half{vadd_f32(vget_low_f32(sum), vget_high_f32(sum))};
+
+    return vget_lane_f32(vpadd_f32(half, half), 0) + dot_scalar(left + i, right + i, count - i);
+}
+
+static constexpr mixing_kernels neon_kernels{simd_level::neon, accumulate_neon, pan_neon, downmix_neon, soft_clip_neon, dot_neon};
+
+#endif
+
+bool is_simd_level_supported(simd_level level) noexcept
+{
+    switch(level)
+    {
+        case simd_level::none:
+            return true;
+
+#ifdef SWELL_MIXING_SSE2
+        case simd_level::sse2:
+            return true;
+#endif
+
+#ifdef SWELL_MIXING_X86
+        case simd_level::avx2:
+        {
+            static const bool supported{has_avx2()};
+
+            return supported;
+        }
+#endif
+
+#ifdef SWELL_MIXING_NEON
+        case simd_level::neon:
+            return true;
+#endif
+
+        default:
+            return false;
+    }
+}
+
+simd_level best_simd_level() noexcept
+{
+    for(const auto level : {simd_level::avx2, simd_level::neon, simd_level::sse2})
+    {
+        if(is_simd_level_supported(level))
+        {
+            return level;
+        }
+    }
+
+    return simd_level::none;
+}
+
+const mixing_kernels& get_mixing_kernels(simd_level level) noexcept
+{
+    assert(is_simd_level_supported(level) && "swl::get_mixing_kernels called with an unsupported SIMD level.");
+
+    switch(level)
+    {
+#ifdef SWELL_MIXING_SSE2
+        case simd_level::sse2:
+            return sse2_kernels;
+#endif
+
+#ifdef SWELL_MIXING_X86
+        case simd_level::avx2:
+            return avx2_kernels;
+#endif
+
+#ifdef SWELL_MIXING_NEON
+        case simd_level::neon:
+            return neon_kernels;
+#endif
+
+        default:
+            return scalar_kernels;
+    }
+}
+
+const mixing_kernels& get_mixing_kernels() noexcept
+{
+    static const mixing_kernels& kernels{get_mixing_kernels(best_simd_level())};
+
+    return kernels;
+}
+
+}
@@ -0,0 +1,63 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_MIXING_HPP_INCLUDED
+#define SWELL_MIXING_HPP_INCLUDED
+
+#include "config.hpp"
+
+namespace swl
+{
+
+enum class simd_level : std::uint32_t
+{
+    none = 0,
+    sse2 = 1,
+    avx2 = 2,
+    neon = 3
+};
+
+struct mixing_kernels
+{
+    using accumulate_function = void(*)(float* output, const float* input, std::size_t sample_count, float gain) noexcept;
+    using pan_function        = void(*)(float* output, const float* input, std::size_t frame_count, float right_gain, float left_gain) noexcept;
+    using downmix_function    = void(*)(float* output, const float* input, std::size_t frame_count, float gain) noexcept;
+    using soft_clip_function  = void(*)(float* samples, std::size_t sample_count, std::size_t sound_count) noexcept;
+    using dot_function        = float(*)(const float* left, const float* right, std::size_t count) noexcept;
+
+    simd_level level{};
+    accumulate_function accumulate{}; //output[i] += input[i] * gain
+    pan_function pan{}; //Mono input, stereo output: output[i * 2] += input[i] * right_gain, output[i * 2 + 1] += input[i] * left_gain
+    downmix_function downmix{}; //Stereo input, mono output: output[i] += soft clip of (input[i * 2] + input[i * 2 + 1]) * gain over 2 sounds
+    soft_clip_function soft_clip{}; //samples[i] = sign(samples[i]) * (1 - (1 - |samples[i]|)^sound_count)
+    dot_function dot{}; //sum of left[i] * right[i], used by resampling filters
+};
+
+SWELL_API bool is_simd_level_supported(simd_level level) noexcept;
+SWELL_API simd_level best_simd_level() noexcept;
+
+SWELL_API const mixing_kernels& get_mixing_kernels(simd_level level) noexcept;
+SWELL_API const mixing_kernels& get_mixing_kernels() noexcept;
+
+}
+
+#endif
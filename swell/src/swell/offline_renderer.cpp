@@ -0,0 +1,229 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "offline_renderer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <bit>
+
+#include "audio_world.hpp"
+
+namespace swl
+{
+
+template<typename T>
+static void write_value(std::ostream& stream, T value)
+{
+    static_assert(std::is_integral_v<T>);
+
+    for(std::size_t i{}; i < sizeof(T); ++i)
+    {
+        stream.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+static void write_header(std::ostream& stream, std::uint32_t sample_rate, std::uint32_t channel_count, std::uint64_t frame_count)
+{
+    const auto data_size{static_cast<std::uint32_t>(std::min<std::uint64_t>(frame_count * channel_count * sizeof(float), 0xFFFFFFFFu - 36))};
+
+    stream.write("RIFF", 4);
+    write_value(stream, std::uint32_t{36 + data_size});
+    stream.write("WAVE", 4);
+
+    stream.write("fmt ", 4);
+    write_value(stream, std::uint32_t{16});
+    write_value(stream, std::uint16_t{3}); //IEEE float
+    write_value(stream, static_cast<std::uint16_t>(channel_count));
+    write_value(stream, sample_rate);
+    write_value(stream, static_cast<std::uint32_t>(sample_rate * channel_count * sizeof(float)));
+    write_value(stream, static_cast<std::uint16_t>(channel_count * sizeof(float)));
+    write_value(stream, std::uint16_t{32});
+
+    stream.write("data", 4);
+    write_value(stream, data_size);
+}
+
+void memory_sink::write(std::span<const float> samples, std::uint32_t channel_count)
+{
+    assert((m_channel_count == 0 || m_channel_count == channel_count) && "swl::memory_sink channel count changed.");
+
+    m_channel_count = channel_count;
+    m_samples.insert(std::end(m_samples), std::begin(samples), std::end(samples));
+}
+
+std::uint64_t memory_sink::hash() const noexcept
+{
+    return hash_samples(m_samples);
+}
+
+wave_sink::wave_sink(const std::filesystem::path& file, std::uint32_t sample_rate, std::uint32_t channel_count)
+:m_file{file, std::ios_base::binary}
+,m_sample_rate{sample_rate}
+,m_channel_count{channel_count}
+{
+    if(!m_file)
+        throw std::runtime_error{"swl::wave_sink can not open file \"" + file.string() + "\"."};
+
+    write_header(m_file, m_sample_rate, m_channel_count, 0);
+}
+
+wave_sink::~wave_sink()
+{
+    if(m_file.is_open())
+    {
+        try
+        {
+            close();
+        }
+        catch(...)
+        {
+
+        }
+    }
+}
+
+void wave_sink::write(std::span<const float> samples, std::uint32_t channel_count)
+{
+    if(channel_count != m_channel_count)
+        throw std::runtime_error{"swl::wave_sink received samples with a different channel count."};
+
+    if constexpr(std::endian::native == std::endian::little)
+    {
+        m_file.write(reinterpret_cast<const char*>(std::data(samples)), static_cast<std::streamsize>(std::size(samples) * sizeof(float)));
+    }
+    else
+    {
+        for(const auto sample : samples)
+        {
+            write_value(m_file, std::bit_cast<std::uint32_t>(sample));
+        }
+    }
+
+    if(!m_file)
+        throw std::runtime_error{"swl::wave_sink can not write file."};
+
+    m_frame_count += std::size(samples) / channel_count;
+}
+
+void wave_sink::close()
+{
+    m_file.seekp(0);
+    write_header(m_file, m_sample_rate, m_channel_count, m_frame_count);
+    m_file.close();
+
+    if(!m_file)
+        throw std::runtime_error{"swl::wave_sink can not write file."};
+}
+
+offline_renderer::offline_renderer(audio_world& world, std::size_t block_size)
+:m_world{&world}
+,m_block_size{block_size}
+{
+    assert(m_block_size > 0 && "swl::offline_renderer created with a null block size.");
+}
+
+void offline_renderer::add_output(listener& listener, render_sink* sink)
+{
+    m_outputs.emplace_back(output{&listener, sink});
+}
+
+void offline_renderer::clear_outputs() noexcept
+{
+    m_outputs.clear();
+}
+
+offline_render_stats offline_renderer::render(std::size_t frame_count)
+{
+    offline_render_stats output{};
+
+    const auto begin{clock::now()};
+
+    while(output.frame_count < frame_count)
+    {
+        const auto count{std::min(m_block_size, frame_count - static_cast<std::size_t>(output.frame_count))};
+
+        for(auto& [target, sink] : m_outputs)
+        {
+            m_world->bind_listener(*target);
+        }
+
+        m_world->generate(count);
+
+        for(auto& [target, sink] : m_outputs)
+        {
+            const auto channel_count{target->channel_count()};
+
+            if(sink)
+            {
+                m_buffer.resize(count * channel_count);
+                target->drain(std::begin(m_buffer), count);
+                sink->write(m_buffer, channel_count);
+            }
+            else
+            {
+                target->queue().discard();
+            }
+        }
+
+        output.frame_count += count;
+        ++output.block_count;
+    }
+
+    output.elapsed = std::chrono::duration_cast<seconds>(clock::now() - begin);
+
+    if(output.frame_count > 0)
+    {
+        output.nanoseconds_per_frame = output.elapsed.count() * 1.0e9 / static_cast<double>(output.frame_count);
+    }
+
+    if(output.elapsed.count() > 0.0)
+    {
+        output.realtime_factor = static_cast<double>(output.frame_count) / static_cast<double>(m_world->sample_rate()) / output.elapsed.count();
+    }
+
+    return output;
+}
+
+offline_render_stats offline_renderer::render(seconds duration)
+{
+    return render(static_cast<std::size_t>(std::llround(duration.count() * static_cast<double>(m_world->sample_rate()))));
+}
+
+std::uint64_t hash_samples(std::span<const float> samples) noexcept
+{
+    std::uint64_t output{0xCBF29CE484222325ull};
+
+    for(const auto sample : samples)
+    {
+        const auto value{static_cast<std::int32_t>(std::lround(std::clamp(sample, -1.0f, 1.0f) * 32767.0f))};
+
+        output ^= static_cast<std::uint32_t>(value);
+        output *= 0x100000001B3ull;
+    }
+
+    return output;
+}
+
+}
@@ -0,0 +1,172 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_OFFLINE_RENDERER_HPP_INCLUDED
+#define SWELL_OFFLINE_RENDERER_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <span>
+#include <fstream>
+#include <filesystem>
+
+namespace swl
+{
+
+class audio_world;
+class listener;
+
+//Receives the interleaved output of a listener rendered by an offline_renderer
+class SWELL_API render_sink
+{
+public:
+    render_sink() = default;
+    virtual ~render_sink() = default;
+    render_sink(const render_sink&) = delete;
+    render_sink& operator=(const render_sink&) = delete;
+    render_sink(render_sink&& other) noexcept = default;
+    render_sink& operator=(render_sink&& other) noexcept = default;
+
+    virtual void write(std::span<const float> samples, std::uint32_t channel_count) = 0;
+};
+
+class SWELL_API memory_sink final : public render_sink
+{
+public:
+    memory_sink() = default;
+    ~memory_sink() = default;
+    memory_sink(const memory_sink&) = delete;
+    memory_sink& operator=(const memory_sink&) = delete;
+    memory_sink(memory_sink&& other) noexcept = default;
+    memory_sink& operator=(memory_sink&& other) noexcept = default;
+
+    void write(std::span<const float> samples, std::uint32_t channel_count) override;
+
+    void clear() noexcept
+    {
+        m_samples.clear();
+    }
+
+    std::span<const float> samples() const noexcept
+    {
+        return m_samples;
+    }
+
+    std::uint32_t channel_count() const noexcept
+    {
+        return m_channel_count;
+    }
+
+    std::uint64_t hash() const noexcept;
+
+private:
+    std::vector<float> m_samples{};
+    std::uint32_t m_channel_count{};
+};
+
+//Writes 32 bits float WAV files, the header is completed by close() or the destructor
+class SWELL_API wave_sink final : public render_sink
+{
+public:
+    wave_sink() = default;
+    explicit wave_sink(const std::filesystem::path& file, std::uint32_t sample_rate, std::uint32_t channel_count);
+
+    ~wave_sink();
+    wave_sink(const wave_sink&) = delete;
+    wave_sink& operator=(const wave_sink&) = delete;
+    wave_sink(wave_sink&& other) noexcept = default;
+    wave_sink& operator=(wave_sink&& other) noexcept = default;
+
+    void write(std::span<const float> samples, std::uint32_t channel_count) override;
+    void close();
+
+    std::uint64_t frame_count() const noexcept
+    {
+        return m_frame_count;
+    }
+
+private:
+    std::ofstream m_file{};
+    std::uint32_t m_sample_rate{};
+    std::uint32_t m_channel_count{};
+    std::uint64_t m_frame_count{};
+};
+
+struct offline_render_stats
+{
+    std::uint64_t frame_count{};
+    std::uint64_t block_count{};
+    seconds elapsed{};
+    double nanoseconds_per_frame{};
+    double realtime_factor{}; //rendered audio duration divided by elapsed time
+};
+
+//Drives an audio_world without any audio device, as fast as possible.
+//Listeners are bound before every block, then drained into their sinks.
+class SWELL_API offline_renderer
+{
+public:
+    static constexpr std::size_t default_block_size{1024};
+
+public:
+    offline_renderer() = default;
+    explicit offline_renderer(audio_world& world, std::size_t block_size = default_block_size);
+
+    ~offline_renderer() = default;
+    offline_renderer(const offline_renderer&) = delete;
+    offline_renderer& operator=(const offline_renderer&) = delete;
+    offline_renderer(offline_renderer&& other) noexcept = default;
+    offline_renderer& operator=(offline_renderer&& other) noexcept = default;
+
+    //The listener and the sink must outlive the renderer, or be removed with clear_outputs. A null sink discards the output.
+    void add_output(listener& listener, render_sink* sink = nullptr);
+    void clear_outputs() noexcept;
+
+    offline_render_stats render(std::size_t frame_count);
+    offline_render_stats render(seconds duration);
+
+    std::size_t block_size() const noexcept
+    {
+        return m_block_size;
+    }
+
+private:
+    struct output
+    {
+        listener* target{};
+        render_sink* sink{};
+    };
+
+private:
+    audio_world* m_world{};
+    std::size_t m_block_size{};
+    std::vector<output> m_outputs{};
+    std::vector<float> m_buffer{};
+};
+
+//Hash of the samples rounded to 16 bits, so outputs can be compared across SIMD paths and compilers
+SWELL_API std::uint64_t hash_samples(std::span<const float> samples) noexcept;
+
+}
+
+#endif
@@ -103,7 +103,8 @@ static int memory_seek(void* datasource, ogg_int64_t offset, int whence)
         stream.position = std::size(stream.data) + offset;
     }
 
-    return static_cast<int>(stream.position);
+    //vorbisfile only checks for failure, returning the position would overflow for files over 2GB
+    return stream.position <= std::size(stream.data) ? 0 : -1;
 }
 
 static long memory_tell(void* datasource)
@@ -119,6 +120,15 @@ ogg_reader::ogg_reader(const std::filesystem::path& file, sound_reader_options o
 :m_options{options}
 ,m_vorbis{new OggVorbis_File{}}
 {
+    if(static_cast<bool>(m_options & sound_reader_options::mapped))
+    {
+        m_mapping = mapped_file{file};
+        m_source = std::make_unique<impl::ogg_memory_stream>(m_mapping.data());
+        init_from_memory();
+
+        return;
+    }
+
     std::ifstream ifs{file, std::ios_base::binary};
     if(!ifs)
         throw std::runtime_error{"swl::ogg_reader can not open file \"" + file.string() + "\"."};
@@ -32,6 +32,7 @@
 #include <memory>
 
 #include "sound_reader.hpp"
+#include "mapped_file.hpp"
 
 struct OggVorbis_File;
 
@@ -94,6 +95,7 @@ private:
 
     std::vector<std::uint8_t> m_source_buffer{};
     std::unique_ptr<std::ifstream> m_file{};
+    mapped_file m_mapping{};
 
     std::vector<float> m_decoded_buffer{};
     std::unique_ptr<impl::ogg_memory_stream> m_source{};
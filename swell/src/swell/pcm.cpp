@@ -0,0 +1,656 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "pcm.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <array>
+#include <bit>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define SWELL_PCM_X86
+
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define SWELL_TARGET_AVX2
+    #else
+        #define SWELL_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define SWELL_PCM_SSE2
+    #endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #define SWELL_PCM_NEON
+
+    #include <arm_neon.h>
+#endif
+
+namespace swl
+{
+
+//Powers of two, so multiplying gives the same result as dividing
+static constexpr float u8_factor {1.0f / 128.0f};
+static constexpr float s16_factor{1.0f / 32768.0f};
+static constexpr float s24_factor{1.0f / 8388608.0f};
+static constexpr float s32_factor{1.0f / 2147483648.0f};
+
+//Scalar kernels, they also process the remaining samples of the vectorized ones
+
+static std::uint32_t load_uint32(const std::uint8_t* input) noexcept
+{
+    return static_cast<std::uint32_t>(input[0] | (input[1] << 8) | (input[2] << 16) | (static_cast<std::uint32_t>(input[3]) << 24));
+}
+
+static void convert_u8_scalar(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    for(std::size_t i{}; i < sample_count; ++i)
+    {
+        output[i] = static_cast<float>(static_cast<std::int32_t>(input[i]) - 128) * u8_factor;
+    }
+}
+
+static void convert_s16_scalar(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    for(std::size_t i{}; i < sample_count; ++i)
+    {
+        const auto value{static_cast<std::int16_t>(input[i * 2] | (input[i * 2 + 1] << 8))};
+
+        output[i] = static_cast<float>(value) * s16_factor;
+    }
+}
+
+static void convert_s24_scalar(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    for(std::size_t i{}; i < sample_count; ++i)
+    {
+        const auto bits{static_cast<std::uint32_t>(input[i * 3] | (input[i * 3 + 1] << 8) | (input[i * 3 + 2] << 16))};
+
+        output[i] = static_cast<float>(static_cast<std::int32_t>(bits << 8) >> 8) * s24_factor;
+    }
+}
+
+static void convert_s32_scalar(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    for(std::size_t i{}; i < sample_count; ++i)
+    {
+        output[i] = static_cast<float>(static_cast<std::int32_t>(load_uint32(input + i * 4))) * s32_factor;
+    }
+}
+
+static void convert_f32_scalar(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    if constexpr(std::endian::native == std::endian::little)
+    {
+        std::memcpy(output, input, sample_count * sizeof(float));
+    }
+    else
+    {
+        for(std::size_t i{}; i < sample_count; ++i)
+        {
+            output[i] = std::bit_cast<float>(load_uint32(input + i * 4));
+        }
+    }
+}
+
+//Planar buffers can not be offset by the vectorized kernels, so the scalar ones start at a given frame
+static void interleave_s32_from(float* output, const std::int32_t* const* inputs, std::size_t offset, std::size_t frame_count, std::uint32_t channel_count, float factor) noexcept
+{
+    for(std::size_t i{offset}; i < frame_count; ++i)
+    {
+        for(std::uint32_t j{}; j < channel_count; ++j)
+        {
+            output[i * channel_count + j] = static_cast<float>(inputs[j][i]) * factor;
+        }
+    }
+}
+
+static void deinterleave_from(float* const* outputs, const float* input, std::size_t offset, std::size_t frame_count, std::uint32_t channel_count) noexcept
+{
+    for(std::size_t i{offset}; i < frame_count; ++i)
+    {
+        for(std::uint32_t j{}; j < channel_count; ++j)
+        {
+            outputs[j][i] = input[i * channel_count + j];
+        }
+    }
+}
+
+static void interleave_s32_scalar(float* output, const std::int32_t* const* inputs, std::size_t frame_count, std::uint32_t channel_count, float factor) noexcept
+{
+    interleave_s32_from(output, inputs, 0, frame_count, channel_count, factor);
+}
+
+static void deinterleave_scalar(float* const* outputs, const float* input, std::size_t frame_count, std::uint32_t channel_count) noexcept
+{
+    deinterleave_from(outputs, input, 0, frame_count, channel_count);
+}
+
+static constexpr pcm_kernels scalar_kernels{simd_level::none, convert_u8_scalar, convert_s16_scalar, convert_s24_scalar, convert_s32_scalar, convert_f32_scalar, interleave_s32_scalar, deinterleave_scalar};
+
+#ifdef SWELL_PCM_SSE2
+
+static void store_sse2(float* output, __m128i values, __m128 factor) noexcept
+{
+    _mm_storeu_ps(output, _mm_mul_ps(_mm_cvtepi32_ps(values), factor));
+}
+
+static void convert_u8_sse2(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    const __m128i zero{_mm_setzero_si128()};
+    const __m128i bias{_mm_set1_epi16(128)};
+    const __m128 factor{_mm_set1_ps(u8_factor)};
+
+    std::size_t i{};
+    for(; i + 16 <= sample_count; i += 16)
+    {
+        const __m128i bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i))};
+        const __m128i low  {_mm_sub_epi16(_mm_unpacklo_epi8(bytes, zero), bias)};
+        const __m128i high {_mm_sub_epi16(_mm_unpackhi_epi8(bytes, zero), bias)};
+
+        //Duplicating each 16 bits value then shifting right sign-extends it to 32 bits
+        store_sse2(output + i,      _mm_srai_epi32(_mm_unpacklo_epi16(low, low), 16), factor);
+        store_sse2(output + i + 4,  _mm_srai_epi32(_mm_unpackhi_epi16(low, low), 16), factor);
+        store_sse2(output + i + 8,  _mm_srai_epi32(_mm_unpacklo_epi16(high, high), 16), factor);
+        store_sse2(output + i + 12, _mm_srai_epi32(_mm_unpackhi_epi16(high, high), 16), factor);
+    }
+
+    convert_u8_scalar(output + i, input + i, sample_count - i);
+}
+
+static void convert_s16_sse2(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    const __m128 factor{_mm_set1_ps(s16_factor)};
+
+    std::size_t i{};
+    for(; i + 8 <= sample_count; i += 8)
+    {
+        const __m128i values{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2))};
+
+        store_sse2(output + i,     _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16), factor);
+        store_sse2(output + i + 4, _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16), factor);
+    }
+
+    convert_s16_scalar(output + i, input + i * 2, sample_count - i);
+}
+
+static void convert_s24_sse2(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    const __m128 factor{_mm_set1_ps(s24_factor)};
+
+    const auto load = [](const std::uint8_t* data) noexcept
+    {
+        std::int32_t value;
+        std::memcpy(&value, data, sizeof(value));
+
+        return value;
+    };
+
+    //Each sample is loaded with the first byte of the next one, hence the extra sample at the end of the loop
+    std::size_t i{};
+    for(; i + 5 <= sample_count; i += 4)
+    {
+        const auto data{input + i * 3};
+        const __m128i values{_mm_setr_epi32(load(data), load(data + 3), load(data + 6), load(data + 9))};
+
+        store_sse2(output + i, _mm_srai_epi32(_mm_slli_epi32(values, 8), 8), factor);
+    }
+
+    convert_s24_scalar(output + i, input + i * 3, sample_count - i);
+}
+
+static void convert_s32_sse2(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    const __m128 factor{_mm_set1_ps(s32_factor)};
+
+    std::size_t i{};
+    for(; i + 4 <= sample_count; i += 4)
+    {
+        store_sse2(output + i, _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 4)), factor);
+    }
+
+    convert_s32_scalar(output + i, input + i * 4, sample_count - i);
+}
+
+static void interleave_s32_sse2(float* output, const std::int32_t* const* inputs, std::size_t frame_count, std::uint32_t channel_count, float factor) noexcept
+{
+    const __m128 factors{_mm_set1_ps(factor)};
+
+    std::size_t i{};
+
+    if(channel_count == 1)
+    {
+        for(; i + 4 <= frame_count; i += 4)
+        {
+            store_sse2(output + i, _mm_loadu_si128(reinterpret_cast<const __m128i*>(inputs[0] + i)), factors);
+        }
+    }
+    else if(channel_count == 2)
+    {
+        for(; i + 4 <= frame_count; i += 4)
+        {
+            const __m128 left {_mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inputs[0] + i))), factors)};
+            const __m128 right{_mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inputs[1] + i))), factors)};
+
+            _mm_storeu_ps(output + i * 2,     _mm_unpacklo_ps(left, right));
+            _mm_storeu_ps(output + i * 2 + 4, _mm_unpackhi_ps(left, right));
+        }
+    }
+
+    interleave_s32_from(output, inputs, i, frame_count, channel_count, factor);
+}
+
+static void deinterleave_sse2(float* const* outputs, const float* input, std::size_t frame_count, std::uint32_t channel_count) noexcept
+{
+    std::size_t i{};
+
+    if(channel_count == 2)
+    {
+        for(; i + 4 <= frame_count; i += 4)
+        {
+            const __m128 first {_mm_loadu_ps(input + i * 2)};
+            const __m128 second{_mm_loadu_ps(input + i * 2 + 4)};
+
+            _mm_storeu_ps(outputs[0] + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(outputs[1] + i, _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+    else if(channel_count == 1)
+    {
+        std::copy_n(input, frame_count, outputs[0]);
+
+        return;
+    }
+
+    deinterleave_from(outputs, input, i, frame_count, channel_count);
+}
+
+static constexpr pcm_kernels sse2_kernels{simd_level::sse2, convert_u8_sse2, convert_s16_sse2, convert_s24_sse2, convert_s32_sse2, convert_f32_scalar, interleave_s32_sse2, deinterleave_sse2};
+
+#endif
+
+#ifdef SWELL_PCM_X86
+
+SWELL_TARGET_AVX2 static void convert_u8_avx2(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    const __m256i bias{_mm256_set1_epi32(128)};
+    const __m256 factor{_mm256_set1_ps(u8_factor)};
+
+    std::size_t i{};
+    for(; i + 16 <= sample_count; i += 16)
+    {
+        const __m128i bytes{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i))};
+        const __m256i low  {_mm256_sub_epi32(_mm256_cvtepu8_epi32(bytes), bias)};
+        const __m256i high {_mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_unpackhi_epi64(bytes, bytes)), bias)};
+
+        _mm256_storeu_ps(output + i,     _mm256_mul_ps(_mm256_cvtepi32_ps(low), factor));
+        _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high), factor));
+    }
+
+    _mm256_zeroupper(); //Avoid AVX to SSE transition penalties in the scalar code that follows
+
+    convert_u8_scalar(output + i, input + i, sample_count - i);
+}
+
+SWELL_TARGET_AVX2 static void convert_s16_avx2(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    const __m256 factor{_mm256_set1_ps(s16_factor)};
+
+    std::size_t i{};
+    for(; i + 16 <= sample_count; i += 16)
+    {
+        const __m128i first {_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2))};
+        const __m128i second{_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2 + 16))};
+
+        _mm256_storeu_ps(output + i,     _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(first)), factor));
+        _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(second)), factor));
+    }
+
+    _mm256_zeroupper();
+
+    convert_s16_scalar(output + i, input + i * 2, sample_count - i);
+}
+
+SWELL_TARGET_AVX2 static void convert_s24_avx2(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    const __m256 factor{_mm256_set1_ps(s24_factor)};
+
+    //Moves the 3 bytes of each sample in the upper bytes of its 32 bits lane, an arithmetic shift then sign-extends it
+    const __m256i shuffle{_mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                                           -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11)};
+
+    //The second half is loaded with 16 bytes but only uses 12, hence the 2 extra samples at the end of the loop
+    std::size_t i{};
+    for(; i + 10 <= sample_count; i += 8)
+    {
+        const auto data{input + i * 3};
+        const __m128i low {_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))};
+        const __m128i high{_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 12))};
+        const __m256i values{_mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1), shuffle)};
+
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(values, 8)), factor));
+    }
+
+    _mm256_zeroupper();
+
+    convert_s24_scalar(output + i, input + i * 3, sample_count - i);
+}
+
+SWELL_TARGET_AVX2 static void convert_s32_avx2(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    const __m256 factor{_mm256_set1_ps(s32_factor)};
+
+    std::size_t i{};
+    for(; i + 8 <= sample_count; i += 8)
+    {
+        const __m256i values{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i * 4))};
+
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(values), factor));
+    }
+
+    _mm256_zeroupper();
+
+    convert_s32_scalar(output + i, input + i * 4, sample_count - i);
+}
+
+SWELL_TARGET_AVX2 static void interleave_s32_avx2(float* output, const std::int32_t* const* inputs, std::size_t frame_count, std::uint32_t channel_count, float factor) noexcept
+{
+    const __m256 factors{_mm256_set1_ps(factor)};
+
+    std::size_t i{};
+
+    if(channel_count == 1)
+    {
+        for(; i + 8 <= frame_count; i += 8)
+        {
+            const __m256i values{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs[0] + i))};
+
+            _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(values), factors));
+        }
+    }
+    else if(channel_count == 2)
+    {
+        for(; i + 8 <= frame_count; i += 8)
+        {
+            const __m256 left {_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs[0] + i))), factors)};
+            const __m256 right{_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inputs[1] + i))), factors)};
+
+            //Unpacking works on 128 bits lanes: low is frames 0, 1, 4, 5 and high is frames 2, 3, 6, 7
+            const __m256 low {_mm256_unpacklo_ps(left, right)};
+            const __m256 high{_mm256_unpackhi_ps(left, right)};
+
+            _mm256_storeu_ps(output + i * 2,     _mm256_permute2f128_ps(low, high, 0x20));
+            _mm256_storeu_ps(output + i * 2 + 8, _mm256_permute2f128_ps(low, high, 0x31));
+        }
+    }
+
+    _mm256_zeroupper();
+
+    interleave_s32_from(output, inputs, i, frame_count, channel_count, factor);
+}
+
+SWELL_TARGET_AVX2 static void deinterleave_avx2(float* const* outputs, const float* input, std::size_t frame_count, std::uint32_t channel_count) noexcept
+{
+    std::size_t i{};
+
+    if(channel_count == 2)
+    {
+        for(; i + 8 <= frame_count; i += 8)
+        {
+            const __m256 first {_mm256_loadu_ps(input + i * 2)};
+            const __m256 second{_mm256_loadu_ps(input + i * 2 + 8)};
+
+            //Shuffling works on 128 bits lanes, frames end up in 0, 1, 4, 5, 2, 3, 6, 7 order
+            const __m256 left {_mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0))};
+            const __m256 right{_mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1))};
+
+            _mm256_storeu_ps(outputs[0] + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(left), _MM_SHUFFLE(3, 1, 2, 0))));
+            _mm256_storeu_ps(outputs[1] + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(right), _MM_SHUFFLE(3, 1, 2, 0))));
+        }
+    }
+    else if(channel_count == 1)
+    {
+        std::copy_n(input, frame_count, outputs[0]);
+
+        return;
+    }
+
+    _mm256_zeroupper();
+
+    deinterleave_from(outputs, input, i, frame_count, channel_count);
+}
+
+static constexpr pcm_kernels avx2_kernels{simd_level::avx2, convert_u8_avx2, convert_s16_avx2, convert_s24_avx2, convert_s32_avx2, convert_f32_scalar, interleave_s32_avx2, deinterleave_avx2};
+
+#endif
+
+#ifdef SWELL_PCM_NEON
+
+static void convert_u8_neon(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    const int16x8_t bias{vdupq_n_s16(128)};
+
+    std::size_t i{};
+    for(; i + 16 <= sample_count; i += 16)
+    {
+        const uint8x16_t bytes{vld1q_u8(input + i)};
+        const int16x8_t low {vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(bytes))), bias)};
+        const int16x8_t high{vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(bytes))), bias)};
+
+        vst1q_f32(output + i,      vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(low))), u8_factor));
+        vst1q_f32(output + i + 4,  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(low))), u8_factor));
+        vst1q_f32(output + i + 8,  vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(high))), u8_factor));
+        vst1q_f32(output + i + 12, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(high))), u8_factor));
+    }
+
+    convert_u8_scalar(output + i, input + i, sample_count - i);
+}
+
+static void convert_s16_neon(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    std::size_t i{};
+    for(; i + 8 <= sample_count; i += 8)
+    {
+        const int16x8_t values{vreinterpretq_s16_u8(vld1q_u8(input + i * 2))};
+
+        vst1q_f32(output + i,     vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(values))), s16_factor));
+        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(values))), s16_factor));
+    }
+
+    convert_s16_scalar(output + i, input + i * 2, sample_count - i);
+}
+
+static void convert_s24_neon(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    std::size_t i{};
+    for(; i + 8 <= sample_count; i += 8)
+    {
+        //Loads 8 samples with each of their 3 bytes in its own vector
+        const uint8x8x3_t bytes{vld3_u8(input + i * 3)};
+        const uint16x8_t low {vorrq_u16(vmovl_u8(bytes.val[0]), vshll_n_u8(bytes.val[1], 8))};
+        const int16x8_t  high{vmovl_s8(vreinterpret_s8_u8(bytes.val[2]))};
+
+        const int32x4_t first {vorrq_s32(vshlq_n_s32(vmovl_s16(vget_low_s16(high)), 16), vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low))))};
+        const int32x4_t second{vorrq_s32(vshlq_n_s32(vmovl_s16(vget_high_s16(high)), 16), vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low))))};
+
+        vst1q_f32(output + i,     vmulq_n_f32(vcvtq_f32_s32(first), s24_factor));
+        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(second), s24_factor));
+    }
+
+    convert_s24_scalar(output + i, input + i * 3, sample_count - i);
+}
+
+static void convert_s32_neon(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept
+{
+    std::size_t i{};
+    for(; i + 4 <= sample_count; i += 4)
+    {
+        const int32x4_t values{vreinterpretq_s32_u8(vld1q_u8(input + i * 4))};
+
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(values), s32_factor));
+    }
+
+    convert_s32_scalar(output + i, input + i * 4, sample_count - i);
+}
+
+static void interleave_s32_neon(float* output, const std::int32_t* const* inputs, std::size_t frame_count, std::uint32_t channel_count, float factor) noexcept
+{
+    std::size_t i{};
+
+    if(channel_count == 1)
+    {
+        for(; i + 4 <= frame_count; i += 4)
+        {
+            vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(inputs[0] + i)), factor));
+        }
+    }
+    else if(channel_count == 2)
+    {
+        for(; i + 4 <= frame_count; i += 4)
+        {
+            float32x4x2_t frames;
+            frames.val[0] = vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(inputs[0] + i)), factor);
+            frames.val[1] = vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(inputs[1] + i)), factor);
+
+            vst2q_f32(output + i * 2, frames);
+        }
+    }
+
+    interleave_s32_from(output, inputs, i, frame_count, channel_count, factor);
+}
+
+static void deinterleave_neon(float* const* outputs, const float* input, std::size_t frame_count, std::uint32_t channel_count) noexcept
+{
+    std::size_t i{};
+
+    if(channel_count == 2)
+    {
+        for(; i + 4 <= frame_count; i += 4)
+        {
+            const float32x4x2_t frames{vld2q_f32(input + i * 2)};
+
+            vst1q_f32(outputs[0] + i, frames.val[0]);
+            vst1q_f32(outputs[1] + i, frames.val[1]);
+        }
+    }
+    else if(channel_count == 1)
+    {
+        std::copy_n(input, frame_count, outputs[0]);
+
+        return;
+    }
+
+    deinterleave_from(outputs, input, i, frame_count, channel_count);
+}
+
+static constexpr pcm_kernels neon_kernels{simd_level::neon, convert_u8_neon, convert_s16_neon, convert_s24_neon, convert_s32_neon, convert_f32_scalar, interleave_s32_neon, deinterleave_neon};
+
+#endif
+
+const pcm_kernels& get_pcm_kernels(simd_level level) noexcept
+{
+    assert(is_simd_level_supported(level) && "swl::get_pcm_kernels called with an unsupported SIMD level.");
+
+    switch(level)
+    {
+#ifdef SWELL_PCM_SSE2
+        case simd_level::sse2:
+            return sse2_kernels;
+#endif
+
+#ifdef SWELL_PCM_X86
+        case simd_level::avx2:
+            return avx2_kernels;
+#endif
+
+#ifdef SWELL_PCM_NEON
+        case simd_level::neon:
+            return neon_kernels;
+#endif
+
+        default:
+            return scalar_kernels;
+    }
+}
+
+const pcm_kernels& get_pcm_kernels() noexcept
+{
+    static const pcm_kernels& kernels{get_pcm_kernels(best_simd_level())};
+
+    return kernels;
+}
+
+void convert_pcm(pcm_format format, const std::uint8_t* input, float* output, std::size_t sample_count) noexcept
+{
+    get_pcm_kernels().convert(format)(output, input, sample_count);
+}
+
+void convert_pcm_planar(pcm_format format, const std::uint8_t* input, float* const* outputs, std::size_t frame_count, std::uint32_t channel_count) noexcept
+{
+    static constexpr std::size_t buffer_size{2048};
+    static constexpr std::uint32_t max_channel_count{32};
+
+    const auto& kernels{get_pcm_kernels()};
+    const auto convert{kernels.convert(format)};
+    const auto sample_size{pcm_format_size(format)};
+
+    if(channel_count > max_channel_count)
+    {
+        std::array<float, 1> sample{};
+
+        for(std::size_t i{}; i < frame_count; ++i)
+        {
+            for(std::uint32_t j{}; j < channel_count; ++j)
+            {
+                convert(std::data(sample), input + (i * channel_count + j) * sample_size, 1);
+                outputs[j][i] = sample[0];
+            }
+        }
+
+        return;
+    }
+
+    //Converts chunks in an interleaved buffer small enough to stay in cache, then splits them
+    std::array<float, buffer_size> buffer;
+    std::array<float*, max_channel_count> chunk_outputs;
+
+    const std::size_t chunk_size{buffer_size / channel_count};
+
+    for(std::size_t i{}; i < frame_count; i += chunk_size)
+    {
+        const auto count{std::min(chunk_size, frame_count - i)};
+
+        convert(std::data(buffer), input + i * channel_count * sample_size, count * channel_count);
+
+        for(std::uint32_t j{}; j < channel_count; ++j)
+        {
+            chunk_outputs[j] = outputs[j] + i;
+        }
+
+        kernels.deinterleave(std::data(chunk_outputs), std::data(buffer), count, channel_count);
+    }
+}
+
+}
@@ -0,0 +1,91 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_PCM_HPP_INCLUDED
+#define SWELL_PCM_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include "mixing.hpp"
+
+namespace swl
+{
+
+enum class pcm_format : std::uint32_t
+{
+    u8 = 0,  //unsigned 8 bits, 128 is silence
+    s16 = 1,
+    s24 = 2, //packed on 3 bytes
+    s32 = 3,
+    f32 = 4,
+};
+
+//Little endian PCM samples to float in [-1; 1[. Inputs do not have to be aligned.
+struct pcm_kernels
+{
+    using convert_function      = void(*)(float* output, const std::uint8_t* input, std::size_t sample_count) noexcept;
+    using interleave_function   = void(*)(float* output, const std::int32_t* const* inputs, std::size_t frame_count, std::uint32_t channel_count, float factor) noexcept;
+    using deinterleave_function = void(*)(float* const* outputs, const float* input, std::size_t frame_count, std::uint32_t channel_count) noexcept;
+
+    simd_level level{};
+    convert_function convert_u8{};
+    convert_function convert_s16{};
+    convert_function convert_s24{};
+    convert_function convert_s32{};
+    convert_function convert_f32{};
+    interleave_function interleave_s32{}; //Planar int32 input, as given by decoders: output[i * channel_count + j] = inputs[j][i] * factor
+    deinterleave_function deinterleave{}; //outputs[j][i] = input[i * channel_count + j]
+
+    convert_function convert(pcm_format format) const noexcept
+    {
+        switch(format)
+        {
+            case pcm_format::u8:  return convert_u8;
+            case pcm_format::s16: return convert_s16;
+            case pcm_format::s24: return convert_s24;
+            case pcm_format::s32: return convert_s32;
+            default:              return convert_f32;
+        }
+    }
+};
+
+SWELL_API const pcm_kernels& get_pcm_kernels(simd_level level) noexcept;
+SWELL_API const pcm_kernels& get_pcm_kernels() noexcept;
+
+constexpr std::size_t pcm_format_size(pcm_format format) noexcept
+{
+    switch(format)
+    {
+        case pcm_format::u8:  return 1;
+        case pcm_format::s16: return 2;
+        case pcm_format::s24: return 3;
+        default:              return 4;
+    }
+}
+
+//Convenience functions using the best kernels of the CPU
+SWELL_API void convert_pcm(pcm_format format, const std::uint8_t* input, float* output, std::size_t sample_count) noexcept;
+SWELL_API void convert_pcm_planar(pcm_format format, const std::uint8_t* input, float* const* outputs, std::size_t frame_count, std::uint32_t channel_count) noexcept;
+
+}
+
+#endif
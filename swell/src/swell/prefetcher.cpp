@@ -0,0 +1,309 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "prefetcher.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <chrono>
+
+namespace swl
+{
+
+//Guards against lost wake-ups, read() notifies without taking the lock
+static constexpr std::chrono::milliseconds wake_up_period{10};
+
+static bool is_looping(std::uint64_t position, std::uint64_t loop_begin, std::uint64_t loop_end, std::uint64_t frame_count) noexcept
+{
+    return loop_begin < loop_end && loop_end <= frame_count && position < loop_end;
+}
+
+prefetching_reader::prefetching_reader(std::unique_ptr<sound_reader> source, std::size_t buffer_frames, std::size_t block_frames)
+:m_source{std::move(source)}
+{
+    assert(m_source && "swl::prefetching_reader created with a null source.");
+    assert(block_frames > 0 && "swl::prefetching_reader created with a null block size.");
+
+    set_info(m_source->info());
+
+    m_capacity = std::bit_ceil(std::max(buffer_frames, block_frames * 2));
+    m_mask = m_capacity - 1;
+    m_block_frames = block_frames;
+    m_buffer = std::make_unique<float[]>(m_capacity * info().channel_count);
+
+    m_thread = std::thread{&prefetching_reader::decode, this};
+}
+
+prefetching_reader::~prefetching_reader()
+{
+    stop();
+}
+
+bool prefetching_reader::read(float* output, std::size_t frame_count)
+{
+    const auto channel_count{info().channel_count};
+
+    if(!m_buffer)
+    {
+        std::fill_n(output, frame_count * channel_count, 0.0f);
+
+        return false;
+    }
+
+    std::size_t done{};
+    bool ended{};
+
+    while(done < frame_count)
+    {
+        const bool looping{is_looping(m_current_frame, m_loop_begin, m_loop_end, info().frame_count)};
+        const auto end_frame{looping ? m_loop_end : info().frame_count};
+
+        if(m_current_frame >= end_frame)
+        {
+            ended = true;
+            break;
+        }
+
+        const auto read_index{m_read.load(std::memory_order_relaxed)};
+        const auto available {m_write.load(std::memory_order_acquire) - read_index};
+        const auto count     {static_cast<std::size_t>(std::min({static_cast<std::uint64_t>(frame_count - done), end_frame - m_current_frame, available}))};
+
+        if(count == 0)
+        {
+            std::unique_lock lock{m_mutex};
+
+            if(m_error)
+            {
+                std::rethrow_exception(m_error);
+            }
+
+            lock.unlock();
+
+            m_underruns.fetch_add(1, std::memory_order_relaxed);
+            m_underrun_frames.fetch_add(frame_count - done, std::memory_order_relaxed);
+
+            break;
+        }
+
+        const auto offset{static_cast<std::size_t>(read_index & m_mask)};
+        const auto first {std::min(count, m_capacity - offset)};
+
+        std::copy_n(m_buffer.get() + offset * channel_count, first * channel_count, output + done * channel_count);
+        std::copy_n(m_buffer.get(), (count - first) * channel_count, output + (done + first) * channel_count);
+
+        m_read.store(read_index + count, std::memory_order_release);
+        m_condition.notify_one();
+
+        m_current_frame += count;
+        done += count;
+
+        if(looping && m_current_frame == m_loop_end) //The decoding thread already continued from the loop beginning
+        {
+            m_current_frame = m_loop_begin;
+        }
+    }
+
+    std::fill(output + done * channel_count, output + frame_count * channel_count, 0.0f);
+
+    return !ended;
+}
+
+void prefetching_reader::seek(std::uint64_t frame_offset)
+{
+    if(frame_offset != m_current_frame)
+    {
+        restart(frame_offset);
+    }
+}
+
+std::uint64_t prefetching_reader::tell()
+{
+    return m_current_frame;
+}
+
+void prefetching_reader::set_loop_points(std::uint64_t begin_frame, std::uint64_t end_frame)
+{
+    m_loop_begin = begin_frame;
+    m_loop_end = end_frame;
+
+    restart(m_current_frame);
+}
+
+std::unique_ptr<sound_reader> prefetching_reader::release_source()
+{
+    stop();
+
+    m_buffer.reset();
+
+    if(m_source && m_source->info().seekable)
+    {
+        m_source->seek(0);
+    }
+
+    return std::move(m_source);
+}
+
+void prefetching_reader::stop()
+{
+    if(m_thread.joinable())
+    {
+        {
+            std::lock_guard lock{m_mutex};
+            m_stop = true;
+        }
+
+        m_condition.notify_one();
+        m_thread.join();
+    }
+}
+
+void prefetching_reader::restart(std::uint64_t frame)
+{
+    m_current_frame = frame;
+
+    if(!m_buffer)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard lock{m_mutex};
+
+        //Drop everything, frames decoded for the previous generation will never be published
+        m_read.store(m_write.load(std::memory_order_relaxed), std::memory_order_release);
+
+        ++m_request.generation;
+        m_request.position = frame;
+        m_request.loop_begin = m_loop_begin;
+        m_request.loop_end = m_loop_end;
+
+        m_error = nullptr;
+    }
+
+    m_condition.notify_one();
+}
+
+void prefetching_reader::decode()
+{
+    const auto channel_count{info().channel_count};
+    const auto frame_count{info().frame_count};
+
+    const auto free_frames = [this]() noexcept
+    {
+        return m_capacity - static_cast<std::size_t>(m_write.load(std::memory_order_relaxed) - m_read.load(std::memory_order_acquire));
+    };
+
+    decoding_state state{};
+    std::uint64_t position{};
+    bool seek_needed{};
+    bool finished{};
+
+    std::unique_lock lock{m_mutex};
+
+    while(true)
+    {
+        m_condition.wait_for(lock, wake_up_period, [&]()
+        {
+            return m_stop || m_request.generation != state.generation || (!finished && free_frames() >= m_block_frames);
+        });
+
+        if(m_stop)
+        {
+            return;
+        }
+
+        if(m_request.generation != state.generation)
+        {
+            state = m_request;
+            position = state.position;
+            seek_needed = true;
+            finished = false;
+        }
+
+        if(finished || free_frames() < m_block_frames)
+        {
+            continue;
+        }
+
+        const auto generation {state.generation};
+        const auto write_index{m_write.load(std::memory_order_relaxed)};
+
+        lock.unlock();
+
+        std::size_t count{};
+
+        try
+        {
+            if(seek_needed)
+            {
+                m_source->seek(position);
+                seek_needed = false;
+            }
+
+            const bool looping{is_looping(position, state.loop_begin, state.loop_end, frame_count)};
+            const auto end_frame{looping ? state.loop_end : frame_count};
+
+            if(position < end_frame)
+            {
+                const auto offset{static_cast<std::size_t>(write_index & m_mask)};
+
+                count = static_cast<std::size_t>(std::min<std::uint64_t>(std::min(m_block_frames, m_capacity - offset), end_frame - position));
+
+                m_source->read(m_buffer.get() + offset * channel_count, count);
+                position += count;
+            }
+
+            if(looping && position == state.loop_end)
+            {
+                m_source->seek(state.loop_begin);
+                position = state.loop_begin;
+            }
+            else if(position >= frame_count)
+            {
+                finished = true;
+            }
+        }
+        catch(...)
+        {
+            lock.lock();
+
+            if(m_request.generation == generation)
+            {
+                m_error = std::current_exception();
+            }
+
+            finished = true;
+
+            continue;
+        }
+
+        lock.lock();
+
+        if(m_request.generation == generation)
+        {
+            m_write.store(write_index + count, std::memory_order_release);
+        }
+    }
+}
+
+}
@@ -0,0 +1,142 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_PREFETCHER_HPP_INCLUDED
+#define SWELL_PREFETCHER_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+#include <limits>
+
+#include "sound_reader.hpp"
+
+namespace swl
+{
+
+//Decodes another reader ahead of time on a background thread, so read() only copies already decoded frames.
+//Loop points given through set_loop_points are followed by the decoding thread: seeking back to the loop beginning
+//when the end is reached costs nothing. Any other seek drops the prefetched frames and restarts decoding.
+//If the decoding thread falls behind, read() outputs silence for the missing frames and counts an underrun;
+//the playback position does not move for the missing frames.
+class SWELL_API prefetching_reader final : public sound_reader
+{
+public:
+    static constexpr std::size_t default_buffer_frames{32768};
+    static constexpr std::size_t default_block_frames{4096};
+
+public:
+    prefetching_reader() = default;
+    explicit prefetching_reader(std::unique_ptr<sound_reader> source, std::size_t buffer_frames = default_buffer_frames, std::size_t block_frames = default_block_frames);
+
+    ~prefetching_reader();
+    prefetching_reader(const prefetching_reader&) = delete;
+    prefetching_reader& operator=(const prefetching_reader&) = delete;
+    prefetching_reader(prefetching_reader&& other) noexcept = delete;
+    prefetching_reader& operator=(prefetching_reader&& other) noexcept = delete;
+
+    bool read(float* output, std::size_t frame_count) override;
+    void seek(std::uint64_t frame_offset) override;
+    std::uint64_t tell() override;
+    void set_loop_points(std::uint64_t begin_frame, std::uint64_t end_frame) override;
+
+    //Stops the decoding thread and gives back the source, rewound to the beginning if it is seekable.
+    //The prefetching_reader only outputs silence afterward.
+    std::unique_ptr<sound_reader> release_source();
+
+    sound_reader& source() const noexcept
+    {
+        return *m_source;
+    }
+
+    std::size_t buffered_frames() const noexcept
+    {
+        return static_cast<std::size_t>(m_write.load(std::memory_order_acquire) - m_read.load(std::memory_order_relaxed));
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    std::size_t block_frames() const noexcept
+    {
+        return m_block_frames;
+    }
+
+    std::uint64_t underruns() const noexcept
+    {
+        return m_underruns.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t underrun_frames() const noexcept
+    {
+        return m_underrun_frames.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct decoding_state
+    {
+        std::uint64_t generation{};
+        std::uint64_t position{};
+        std::uint64_t loop_begin{};
+        std::uint64_t loop_end{std::numeric_limits<std::uint64_t>::max()};
+    };
+
+private:
+    void restart(std::uint64_t frame);
+    void stop();
+    void decode();
+
+private:
+    std::unique_ptr<sound_reader> m_source{};
+    std::size_t m_capacity{};
+    std::size_t m_mask{};
+    std::size_t m_block_frames{};
+    std::unique_ptr<float[]> m_buffer{};
+
+    //Consumer side, serialized by the caller
+    std::uint64_t m_current_frame{};
+    std::uint64_t m_loop_begin{};
+    std::uint64_t m_loop_end{std::numeric_limits<std::uint64_t>::max()};
+
+    alignas(64) std::atomic<std::uint64_t> m_write{};
+    alignas(64) std::atomic<std::uint64_t> m_read{};
+    std::atomic<std::uint64_t> m_underruns{};
+    std::atomic<std::uint64_t> m_underrun_frames{};
+
+    decoding_state m_request{};
+    std::exception_ptr m_error{};
+    bool m_stop{};
+    std::mutex m_mutex{};
+    std::condition_variable m_condition{};
+    std::thread m_thread{};
+};
+
+}
+
+#endif
@@ -0,0 +1,318 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "resampler.hpp"
+#include "pcm.hpp"
+#include "prefetcher.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <numeric>
+
+namespace swl
+{
+
+static constexpr std::size_t source_block_size{1024};
+static constexpr std::size_t compaction_threshold{4096};
+
+static std::uint64_t resampled_frame_count(std::uint64_t frame_count, std::uint64_t numerator, std::uint64_t denominator) noexcept
+{
+    const auto quotient {frame_count / numerator};
+    const auto remainder{frame_count % numerator};
+
+    if(quotient > std::numeric_limits<std::uint64_t>::max() / denominator - 1)
+    {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+
+    return quotient * denominator + (remainder * denominator + numerator - 1) / numerator;
+}
+
+static double sinc(double value) noexcept
+{
+    if(value == 0.0)
+    {
+        return 1.0;
+    }
+
+    return std::sin(std::numbers::pi * value) / (std::numbers::pi * value);
+}
+
+static double blackman(double value, double half_width) noexcept
+{
+    const double position{std::numbers::pi * value / half_width};
+
+    return 0.42 + 0.5 * std::cos(position) + 0.08 * std::cos(2.0 * position);
+}
+
+resampling_reader::resampling_reader(std::unique_ptr<sound_reader> source, std::uint32_t frequency, resampling_quality quality)
+:m_source{std::move(source)}
+,m_quality{quality}
+,m_taps{quality == resampling_quality::linear ? 2 : sinc_taps}
+{
+    assert(m_source && "swl::resampling_reader created with a null source.");
+    assert(frequency > 0 && "swl::resampling_reader created with a null frequency.");
+
+    const auto& source_info{m_source->info()};
+    const auto divisor{std::gcd(source_info.frequency, frequency)};
+
+    m_step_numerator = source_info.frequency / divisor;
+    m_step_denominator = frequency / divisor;
+    m_step_integer = m_step_numerator / m_step_denominator;
+    m_step_remainder = m_step_numerator % m_step_denominator;
+
+    sound_info info{source_info};
+    info.frequency = frequency;
+    info.frame_count = resampled_frame_count(source_info.frame_count, m_step_numerator, m_step_denominator);
+
+    set_info(info);
+
+    if(m_quality == resampling_quality::sinc)
+    {
+        m_phase_count = std::min<std::size_t>(m_step_denominator, max_phases);
+        m_filters.resize(m_phase_count * m_taps);
+
+        //Cutoff is lowered when downsampling to remove frequencies the output can not represent
+        const double cutoff{0.95 * std::min(1.0, static_cast<double>(m_step_denominator) / static_cast<double>(m_step_numerator))};
+        const double half_width{static_cast<double>(m_taps / 2)};
+
+        for(std::size_t phase{}; phase < m_phase_count; ++phase)
+        {
+            const double offset{static_cast<double>(phase) / static_cast<double>(m_phase_count)};
+            const auto filter{std::data(m_filters) + phase * m_taps};
+
+            double sum{};
+            std::vector<double> coefficients{};
+            coefficients.reserve(m_taps);
+
+            for(std::size_t tap{}; tap < m_taps; ++tap)
+            {
+                const double position{static_cast<double>(tap) - (half_width - 1.0) - offset};
+                const double coefficient{cutoff * sinc(cutoff * position) * blackman(position, half_width)};
+
+                coefficients.push_back(coefficient);
+                sum += coefficient;
+            }
+
+            for(std::size_t tap{}; tap < m_taps; ++tap) //Normalize to unity gain
+            {
+                filter[tap] = static_cast<float>(coefficients[tap] / sum);
+            }
+        }
+    }
+
+    m_input.resize(info.channel_count);
+    reset(0);
+}
+
+bool resampling_reader::read(float* output, std::size_t frame_count)
+{
+    if(frame_count == 0)
+    {
+        return m_current_frame <= info().frame_count;
+    }
+
+    compact();
+    fill(frame_count);
+
+    if(m_quality == resampling_quality::linear)
+    {
+        read_linear(output, frame_count);
+    }
+    else
+    {
+        read_sinc(output, frame_count);
+    }
+
+    m_current_frame += frame_count;
+
+    return m_current_frame <= info().frame_count;
+}
+
+void resampling_reader::seek(std::uint64_t frame_offset)
+{
+    const auto position{frame_offset * m_step_numerator};
+
+    m_current_frame = frame_offset;
+    m_fraction = position % m_step_denominator;
+    m_source->seek(reset(position / m_step_denominator));
+}
+
+std::uint64_t resampling_reader::tell()
+{
+    return m_current_frame;
+}
+
+std::uint64_t resampling_reader::reset(std::uint64_t source_frame)
+{
+    //Filters are centered on the output frame, the first tap is (m_taps / 2 - 1) frames before it
+    const std::uint64_t history{m_taps / 2 - 1};
+    const std::uint64_t first{source_frame >= history ? source_frame - history : 0};
+
+    for(auto& channel : m_input)
+    {
+        channel.clear();
+        channel.resize(history - (source_frame - first), 0.0f);
+    }
+
+    m_input_frame = 0;
+    m_source_ended = false;
+
+    return first;
+}
+
+void resampling_reader::fill(std::size_t frame_count)
+{
+    const auto channel_count{info().channel_count};
+
+    const auto last_frame{(m_fraction + (frame_count - 1) * m_step_numerator) / m_step_denominator};
+    const auto required{m_input_frame + static_cast<std::size_t>(last_frame) + m_taps};
+    const auto available{std::size(m_input[0])};
+
+    if(available >= required)
+    {
+        return;
+    }
+
+    const auto block_size{std::max(required - available, source_block_size)};
+
+    m_source_buffer.clear();
+    m_source_buffer.resize(block_size * channel_count);
+
+    if(!m_source_ended) //Past the end we only need silence to flush the filters
+    {
+        m_source_ended = !m_source->read(std::data(m_source_buffer), block_size);
+    }
+
+    m_input_pointers.resize(channel_count);
+
+    for(std::uint32_t channel{}; channel < channel_count; ++channel)
+    {
+        auto& input{m_input[channel]};
+        input.resize(available + block_size);
+
+        m_input_pointers[channel] = std::data(input) + available;
+    }
+
+    get_pcm_kernels().deinterleave(std::data(m_input_pointers), std::data(m_source_buffer), block_size, channel_count);
+}
+
+void resampling_reader::compact()
+{
+    if(m_input_frame >= compaction_threshold)
+    {
+        for(auto& channel : m_input)
+        {
+            channel.erase(std::begin(channel), std::begin(channel) + m_input_frame);
+        }
+
+        m_input_frame = 0;
+    }
+}
+
+void resampling_reader::read_linear(float* output, std::size_t frame_count) noexcept
+{
+    const auto channel_count{info().channel_count};
+    const float scale{1.0f / static_cast<float>(m_step_denominator)};
+
+    for(std::size_t i{}; i < frame_count; ++i)
+    {
+        const float position{static_cast<float>(m_fraction) * scale};
+
+        for(std::uint32_t channel{}; channel < channel_count; ++channel)
+        {
+            const auto input{std::data(m_input[channel]) + m_input_frame};
+
+            output[i * channel_count + channel] = input[0] + (input[1] - input[0]) * position;
+        }
+
+        m_input_frame += m_step_integer;
+        m_fraction += m_step_remainder;
+
+        if(m_fraction >= m_step_denominator)
+        {
+            m_fraction -= m_step_denominator;
+            ++m_input_frame;
+        }
+    }
+}
+
+void resampling_reader::read_sinc(float* output, std::size_t frame_count) noexcept
+{
+    const auto channel_count{info().channel_count};
+    const bool exact_phases{m_phase_count == m_step_denominator};
+
+    for(std::size_t i{}; i < frame_count; ++i)
+    {
+        //When the ratio needs more phases than we store, the nearest lower phase is used
+        const auto phase{exact_phases ? m_fraction : m_fraction * m_phase_count / m_step_denominator};
+        const auto filter{std::data(m_filters) + phase * m_taps};
+
+        for(std::uint32_t channel{}; channel < channel_count; ++channel)
+        {
+            output[i * channel_count + channel] = m_kernels->dot(std::data(m_input[channel]) + m_input_frame, filter, m_taps);
+        }
+
+        m_input_frame += m_step_integer;
+        m_fraction += m_step_remainder;
+
+        if(m_fraction >= m_step_denominator)
+        {
+            m_fraction -= m_step_denominator;
+            ++m_input_frame;
+        }
+    }
+}
+
+std::unique_ptr<sound_reader> make_resampling_reader(std::unique_ptr<sound_reader> source, std::uint32_t frequency, resampling_quality quality)
+{
+    if(!source || frequency == 0 || source->info().frequency == 0 || source->info().frequency == frequency)
+    {
+        return source;
+    }
+
+    //The prefetcher is moved above the resampler: loop points then reach it in output frames, and the seeks done when looping
+    //happen on its decoding thread instead of dropping the prefetched frames.
+    if(const auto prefetcher{dynamic_cast<prefetching_reader*>(source.get())}; prefetcher)
+    {
+        const auto position    {prefetcher->tell()};
+        const auto capacity    {prefetcher->capacity()};
+        const auto block_frames{prefetcher->block_frames()};
+
+        auto resampler{std::make_unique<resampling_reader>(prefetcher->release_source(), frequency, quality)};
+        auto output{std::make_unique<prefetching_reader>(std::move(resampler), capacity, block_frames)};
+
+        if(position != 0)
+        {
+            output->seek(position * frequency / source->info().frequency);
+        }
+
+        return output;
+    }
+
+    return std::make_unique<resampling_reader>(std::move(source), frequency, quality);
+}
+
+}
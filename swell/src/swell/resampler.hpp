@@ -0,0 +1,121 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_RESAMPLER_HPP_INCLUDED
+#define SWELL_RESAMPLER_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "sound_reader.hpp"
+#include "mixing.hpp"
+
+namespace swl
+{
+
+enum class resampling_quality : std::uint32_t
+{
+    linear = 0, //2 taps linear interpolation, cheap but aliases
+    sinc = 1,   //32 taps Blackman windowed-sinc polyphase filter
+};
+
+//Converts the output of another reader to a different frequency.
+//The source is read sequentially, in blocks, so non-seekable sources (ogg or flac streams) are supported, as long as seek is not used.
+class SWELL_API resampling_reader final : public sound_reader
+{
+public:
+    static constexpr std::size_t max_phases{512};
+    static constexpr std::size_t sinc_taps{32};
+
+public:
+    resampling_reader() = default;
+    explicit resampling_reader(std::unique_ptr<sound_reader> source, std::uint32_t frequency, resampling_quality quality = resampling_quality::sinc);
+
+    ~resampling_reader() = default;
+    resampling_reader(const resampling_reader&) = delete;
+    resampling_reader& operator=(const resampling_reader&) = delete;
+    resampling_reader(resampling_reader&& other) noexcept = default;
+    resampling_reader& operator=(resampling_reader&& other) noexcept = default;
+
+    bool read(float* output, std::size_t frame_count) override;
+    void seek(std::uint64_t frame_offset) override;
+    std::uint64_t tell() override;
+
+    std::unique_ptr<sound_reader> release_source() noexcept
+    {
+        return std::move(m_source);
+    }
+
+    sound_reader& source() const noexcept
+    {
+        return *m_source;
+    }
+
+    resampling_quality quality() const noexcept
+    {
+        return m_quality;
+    }
+
+private:
+    std::uint64_t reset(std::uint64_t source_frame);
+    void fill(std::size_t frame_count);
+    void compact();
+
+    void read_linear(float* output, std::size_t frame_count) noexcept;
+    void read_sinc(float* output, std::size_t frame_count) noexcept;
+
+private:
+    std::unique_ptr<sound_reader> m_source{};
+    resampling_quality m_quality{};
+    std::size_t m_taps{};
+
+    //source frequency / output frequency, as an irreducible fraction
+    std::uint64_t m_step_numerator{};
+    std::uint64_t m_step_denominator{};
+    std::uint64_t m_step_integer{};
+    std::uint64_t m_step_remainder{};
+
+    std::uint64_t m_current_frame{};
+    std::size_t m_input_frame{}; //index in m_input of the first tap of the next output frame
+    std::uint64_t m_fraction{}; //m_fraction / m_step_denominator is the position between two input frames
+    bool m_source_ended{};
+
+    std::size_t m_phase_count{};
+    std::vector<float> m_filters{}; //m_phase_count filters of m_taps coefficients each
+
+    std::vector<std::vector<float>> m_input{}; //one planar buffer per channel, so filters run on contiguous memory
+    std::vector<float*> m_input_pointers{};
+    std::vector<float> m_source_buffer{};
+
+    const mixing_kernels* m_kernels{&get_mixing_kernels()};
+};
+
+//Returns source itself if it already has the right frequency, or a resampling_reader otherwise.
+//A null frequency means "don't care" and also returns source.
+//If source is a prefetching_reader, the output is a new prefetching_reader around a resampling_reader of its source.
+SWELL_API std::unique_ptr<sound_reader> make_resampling_reader(std::unique_ptr<sound_reader> source, std::uint32_t frequency, resampling_quality quality = resampling_quality::sinc);
+
+}
+
+#endif
@@ -0,0 +1,294 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "sound_cache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+
+#include "sound_file.hpp"
+
+namespace swl
+{
+
+cached_sound_reader::cached_sound_reader(std::shared_ptr<const decoded_sound> sound)
+:m_sound{std::move(sound)}
+{
+    assert(m_sound && "swl::cached_sound_reader created with a null sound.");
+
+    set_info(m_sound->info);
+}
+
+bool cached_sound_reader::read(float* output, std::size_t frame_count)
+{
+    const auto channel_count{info().channel_count};
+    const auto& samples{m_sound->samples};
+
+    const auto begin{std::min(static_cast<std::size_t>(m_current_frame) * channel_count, std::size(samples))};
+    const auto count{std::min(frame_count * channel_count, std::size(samples) - begin)};
+
+    std::fill(std::copy_n(std::data(samples) + begin, count, output), output + frame_count * channel_count, 0.0f);
+
+    m_current_frame += frame_count;
+
+    return count == frame_count * channel_count;
+}
+
+void cached_sound_reader::seek(std::uint64_t frame_offset)
+{
+    m_current_frame = frame_offset;
+}
+
+std::uint64_t cached_sound_reader::tell()
+{
+    return m_current_frame;
+}
+
+static std::shared_ptr<const decoded_sound> decode(sound_reader& reader)
+{
+    auto output{std::make_shared<decoded_sound>()};
+
+    output->info = reader.info();
+    output->info.seekable = true;
+    output->samples.resize(output->info.frame_count * output->info.channel_count);
+
+    reader.read(std::data(output->samples), output->info.frame_count);
+
+    return output;
+}
+
+static std::size_t resident_size(const decoded_sound& sound, std::span<const std::uint8_t> source) noexcept
+{
+    return std::size(sound.samples) * sizeof(float) + std::size(source);
+}
+
+//Memory sources with the same key may still differ if their hashes collide
+static bool same_source(const std::vector<std::uint8_t>& cached, std::span<const std::uint8_t> source) noexcept
+{
+    return std::equal(std::begin(cached), std::end(cached), std::begin(source), std::end(source));
+}
+
+static std::string make_key(const std::filesystem::path& file)
+{
+    const auto path{std::filesystem::canonical(file)};
+    const auto size{std::filesystem::file_size(path)};
+    const auto time{std::filesystem::last_write_time(path).time_since_epoch().count()};
+
+    return "file:" + path.string() + ":" + std::to_string(size) + ":" + std::to_string(time);
+}
+
+static std::uint64_t hash_mix(std::uint64_t value) noexcept
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccd;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53;
+
+    return value ^ (value >> 33);
+}
+
+static std::string make_key(std::span<const std::uint8_t> data)
+{
+    //The same memory may be reused by another file so the address is not enough, the content is hashed.
+    //Four independent lanes of 8 bytes keep this far cheaper than decoding.
+    std::array<std::uint64_t, 4> lanes{0x9e3779b97f4a7c15, 0xbf58476d1ce4e5b9, 0x94d049bb133111eb, 0x2545f4914f6cdd1d};
+
+    std::size_t i{};
+    for(; i + 32 <= std::size(data); i += 32)
+    {
+        for(std::size_t j{}; j < 4; ++j)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, std::data(data) + i + j * 8, 8);
+
+            lanes[j] = (lanes[j] ^ word) * 0x100000001b3;
+        }
+    }
+
+    std::uint64_t hash{std::size(data)};
+    for(const auto lane : lanes)
+    {
+        hash = hash_mix(hash ^ lane);
+    }
+
+    for(; i < std::size(data); ++i)
+    {
+        hash = (hash ^ data[i]) * 0x100000001b3;
+    }
+
+    return "memory:" + std::to_string(std::size(data)) + ":" + std::to_string(hash_mix(hash));
+}
+
+sound_cache::sound_cache(std::size_t budget)
+:m_budget{budget}
+{
+
+}
+
+std::unique_ptr<sound_reader> sound_cache::open(const std::filesystem::path& file)
+{
+    return std::make_unique<cached_sound_reader>(load(file));
+}
+
+std::unique_ptr<sound_reader> sound_cache::open(std::span<const std::uint8_t> data)
+{
+    return std::make_unique<cached_sound_reader>(load(data));
+}
+
+std::shared_ptr<const decoded_sound> sound_cache::load(const std::filesystem::path& file)
+{
+    const auto key{make_key(file)};
+
+    if(auto sound{find(key)}; sound)
+    {
+        return sound;
+    }
+
+    //Decoding is done without holding the lock, other sounds can be loaded concurrently
+    return insert(key, decode(*open_file(file, sound_reader_options::mapped)));
+}
+
+std::shared_ptr<const decoded_sound> sound_cache::load(std::span<const std::uint8_t> data)
+{
+    const auto key{make_key(data)};
+
+    if(auto sound{find(key, data)}; sound)
+    {
+        return sound;
+    }
+
+    return insert(key, decode(*open_file(data, sound_reader_options::none)), data);
+}
+
+void sound_cache::set_budget(std::size_t budget)
+{
+    std::lock_guard lock{m_mutex};
+
+    m_budget = budget;
+    evict();
+}
+
+void sound_cache::clear()
+{
+    std::lock_guard lock{m_mutex};
+
+    m_stats.evictions += std::size(m_entries);
+    m_stats.resident_bytes = 0;
+    m_stats.entry_count = 0;
+
+    m_entries.clear();
+    m_lru.clear();
+}
+
+std::size_t sound_cache::budget() const
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_budget;
+}
+
+sound_cache_stats sound_cache::stats() const
+{
+    std::lock_guard lock{m_mutex};
+
+    return m_stats;
+}
+
+std::shared_ptr<const decoded_sound> sound_cache::find(const std::string& key, std::span<const std::uint8_t> source)
+{
+    std::lock_guard lock{m_mutex};
+
+    const auto it{m_entries.find(key)};
+
+    if(it == std::end(m_entries) || !same_source(it->second.source, source))
+    {
+        ++m_stats.misses;
+
+        return nullptr;
+    }
+
+    m_lru.splice(std::begin(m_lru), m_lru, it->second.position);
+    ++m_stats.hits;
+
+    return it->second.sound;
+}
+
+std::shared_ptr<const decoded_sound> sound_cache::insert(const std::string& key, std::shared_ptr<const decoded_sound> sound, std::span<const std::uint8_t> source)
+{
+    std::lock_guard lock{m_mutex};
+
+    if(const auto it{m_entries.find(key)}; it != std::end(m_entries))
+    {
+        if(!same_source(it->second.source, source)) //Hash collision, the cached sound is kept
+        {
+            return sound;
+        }
+
+        //Another thread decoded it first
+        m_lru.splice(std::begin(m_lru), m_lru, it->second.position);
+
+        return it->second.sound;
+    }
+
+    if(resident_size(*sound, source) > m_budget)
+    {
+        return sound;
+    }
+
+    m_lru.push_front(key);
+    m_entries.emplace(key, entry{sound, std::vector<std::uint8_t>{std::begin(source), std::end(source)}, std::begin(m_lru)});
+
+    m_stats.resident_bytes += resident_size(*sound, source);
+    m_stats.entry_count = std::size(m_entries);
+
+    evict();
+
+    return sound;
+}
+
+void sound_cache::evict()
+{
+    while(m_stats.resident_bytes > m_budget && !std::empty(m_lru))
+    {
+        const auto it{m_entries.find(m_lru.back())};
+        assert(it != std::end(m_entries) && "swl::sound_cache LRU list out of sync.");
+
+        m_stats.resident_bytes -= resident_size(*it->second.sound, it->second.source);
+        ++m_stats.evictions;
+
+        m_entries.erase(it);
+        m_lru.pop_back();
+    }
+
+    m_stats.entry_count = std::size(m_entries);
+}
+
+sound_cache& default_sound_cache()
+{
+    static sound_cache cache{};
+
+    return cache;
+}
+
+}
@@ -0,0 +1,142 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_SOUND_CACHE_HPP_INCLUDED
+#define SWELL_SOUND_CACHE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <memory>
+#include <filesystem>
+#include <span>
+#include <vector>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+#include "sound_reader.hpp"
+
+namespace swl
+{
+
+struct decoded_sound
+{
+    sound_info info{};
+    std::vector<float> samples{}; //interleaved
+};
+
+//A cursor over a decoded_sound, many readers can share the same decoded data
+class SWELL_API cached_sound_reader final : public sound_reader
+{
+public:
+    cached_sound_reader() = default;
+    explicit cached_sound_reader(std::shared_ptr<const decoded_sound> sound);
+
+    ~cached_sound_reader() = default;
+    cached_sound_reader(const cached_sound_reader&) = delete;
+    cached_sound_reader& operator=(const cached_sound_reader&) = delete;
+    cached_sound_reader(cached_sound_reader&& other) noexcept = default;
+    cached_sound_reader& operator=(cached_sound_reader&& other) noexcept = default;
+
+    bool read(float* output, std::size_t frame_count) override;
+    void seek(std::uint64_t frame_offset) override;
+    std::uint64_t tell() override;
+
+    const std::shared_ptr<const decoded_sound>& sound() const noexcept
+    {
+        return m_sound;
+    }
+
+private:
+    std::shared_ptr<const decoded_sound> m_sound{};
+    std::uint64_t m_current_frame{};
+};
+
+struct sound_cache_stats
+{
+    std::uint64_t hits{};
+    std::uint64_t misses{};
+    std::uint64_t evictions{};
+    std::size_t resident_bytes{}; //decoded samples and memory sources owned by the cache, readers may keep evicted sounds alive
+    std::size_t entry_count{};
+};
+
+//Decoded PCM cache, keyed by source identity:
+// - files by canonical path, size and last write time,
+// - memory by size and content hash, a copy of the content is kept to confirm matches byte per byte.
+//Least recently used entries are evicted when the resident size goes over the budget.
+//Sounds bigger than the budget are decoded but never cached.
+class SWELL_API sound_cache
+{
+public:
+    static constexpr std::size_t default_budget{64 * 1024 * 1024};
+
+public:
+    sound_cache() = default;
+    explicit sound_cache(std::size_t budget);
+
+    ~sound_cache() = default;
+    sound_cache(const sound_cache&) = delete;
+    sound_cache& operator=(const sound_cache&) = delete;
+    sound_cache(sound_cache&& other) noexcept = delete;
+    sound_cache& operator=(sound_cache&& other) noexcept = delete;
+
+    std::unique_ptr<sound_reader> open(const std::filesystem::path& file);
+    std::unique_ptr<sound_reader> open(std::span<const std::uint8_t> data);
+
+    std::shared_ptr<const decoded_sound> load(const std::filesystem::path& file);
+    std::shared_ptr<const decoded_sound> load(std::span<const std::uint8_t> data);
+
+    void set_budget(std::size_t budget);
+    void clear();
+
+    std::size_t budget() const;
+    sound_cache_stats stats() const;
+
+private:
+    struct entry
+    {
+        std::shared_ptr<const decoded_sound> sound{};
+        std::vector<std::uint8_t> source{}; //content of memory sources, empty for files
+        std::list<std::string>::iterator position{};
+    };
+
+private:
+    std::shared_ptr<const decoded_sound> find(const std::string& key, std::span<const std::uint8_t> source = {});
+    std::shared_ptr<const decoded_sound> insert(const std::string& key, std::shared_ptr<const decoded_sound> sound, std::span<const std::uint8_t> source = {});
+    void evict();
+
+private:
+    std::size_t m_budget{default_budget};
+    std::unordered_map<std::string, entry> m_entries{};
+    std::list<std::string> m_lru{}; //most recently used first
+    sound_cache_stats m_stats{};
+    mutable std::mutex m_mutex{};
+};
+
+//Cache used by open_file when sound_reader_options::decoded is requested
+SWELL_API sound_cache& default_sound_cache();
+
+}
+
+#endif
@@ -28,6 +28,8 @@
 #include "wave.hpp"
 #include "ogg.hpp"
 #include "flac.hpp"
+#include "sound_cache.hpp"
+#include "prefetcher.hpp"
 
 namespace swl
 {
@@ -79,6 +81,16 @@ audio_file_format file_format(const std::filesystem::path& file)
     return file_format(ifs);
 }
 
+static std::unique_ptr<sound_reader> prefetch(std::unique_ptr<sound_reader> reader, sound_reader_options options)
+{
+    if(static_cast<bool>(options & sound_reader_options::prefetched))
+    {
+        return std::make_unique<prefetching_reader>(std::move(reader));
+    }
+
+    return reader;
+}
+
 template<typename... Args>
 std::unique_ptr<sound_reader> make_reader(audio_file_format format, Args&&... args)
 {
@@ -100,17 +112,27 @@ std::unique_ptr<sound_reader> make_reader(audio_file_format format, Args&&... ar
 
 std::unique_ptr<sound_reader> open_file(const std::filesystem::path& file, sound_reader_options options)
 {
-    return make_reader(file_format(file), file, options);
+    if(static_cast<bool>(options & sound_reader_options::decoded))
+    {
+        return default_sound_cache().open(file);
+    }
+
+    return prefetch(make_reader(file_format(file), file, options), options);
 }
 
 std::unique_ptr<sound_reader> open_file(std::span<const std::uint8_t> data, sound_reader_options options)
 {
-    return make_reader(file_format(data), data, options);
+    if(static_cast<bool>(options & sound_reader_options::decoded))
+    {
+        return default_sound_cache().open(data);
+    }
+
+    return prefetch(make_reader(file_format(data), data, options), options);
 }
 
 std::unique_ptr<sound_reader> open_file(std::istream& stream, sound_reader_options options)
 {
-    return make_reader(file_format(stream), stream, options);
+    return prefetch(make_reader(file_format(stream), stream, options), options);
 }
 
 }
@@ -47,6 +47,9 @@ SWELL_API audio_file_format file_format(std::span<const std::uint8_t> data) noex
 SWELL_API audio_file_format file_format(std::istream& stream);
 SWELL_API audio_file_format file_format(const std::filesystem::path& file);
 
+//With sound_reader_options::decoded, files and memory sources are decoded once and shared through default_sound_cache()
+//With sound_reader_options::prefetched, the reader is wrapped in a prefetching_reader.
+//prefetched is ignored when decoded is also set, decoded sounds are already in memory.
 SWELL_API std::unique_ptr<sound_reader> open_file(const std::filesystem::path& file, sound_reader_options options = sound_reader_options::none);
 SWELL_API std::unique_ptr<sound_reader> open_file(std::span<const std::uint8_t> data, sound_reader_options options = sound_reader_options::none);
 SWELL_API std::unique_ptr<sound_reader> open_file(std::istream& stream, sound_reader_options options = sound_reader_options::none);
@@ -34,7 +34,9 @@ enum class sound_reader_options : std::uint32_t
 {
     none = 0x00,
     buffered = 0x01,
-    decoded = 0x02
+    decoded = 0x02,
+    mapped = 0x04, //file is memory-mapped instead of read, only meaningful for readers created from a path
+    prefetched = 0x08, //open_file wraps the reader in a prefetching_reader, decoding happens on a background thread
 };
 
 struct sound_info
@@ -65,6 +67,13 @@ public:
         return 0;
     }
 
+    //Hint that the reader will be seeked back to begin_frame each time it reaches end_frame.
+    //Readers that decode ahead can use it to prepare the jump.
+    virtual void set_loop_points(std::uint64_t begin_frame [[maybe_unused]], std::uint64_t end_frame [[maybe_unused]])
+    {
+
+    }
+
     const sound_info& info() const noexcept
     {
         return m_info;
@@ -30,45 +30,11 @@
 namespace swl
 {
 
-template<std::uint32_t Bits>
-static std::int32_t extend_sign(std::uint32_t value) noexcept
-{
-    if(value > (1u << (Bits - 1u)))
-    {
-        return static_cast<std::int32_t>((0xFFFFFFFFu << Bits) | value);
-    }
-    else
-    {
-        return static_cast<std::int32_t>(value);
-    }
-}
-
-
-static std::uint8_t read_uint8(const std::uint8_t* data) noexcept
-{
-    return data[0];
-}
-
-static std::int16_t read_int16(const std::uint8_t* data) noexcept
-{
-    return static_cast<std::int16_t>(data[0] | (data[1] << 8));
-}
-
 static std::uint16_t read_uint16(const std::uint8_t* data) noexcept
 {
     return static_cast<std::uint16_t>(data[0] | (data[1] << 8));
 }
 
-static std::int32_t read_int24(const std::uint8_t* data) noexcept
-{
-    return extend_sign<24>(static_cast<std::uint32_t>(data[0] | (data[1] << 8) | (data[2] << 16)));
-}
-
-static std::int32_t read_int32(const std::uint8_t* data) noexcept
-{
-    return static_cast<std::int32_t>(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
-}
-
 static std::uint32_t read_uint32(const std::uint8_t* data) noexcept
 {
     return static_cast<std::uint32_t>(data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24));
@@ -79,40 +45,6 @@ static std::array<std::uint8_t, 4> read_bits32(const std::uint8_t* data) noexcep
     return {data[0], data[1], data[2], data[3]};
 }
 
-static void read_samples(const std::uint8_t* data, std::size_t bits_per_sample, float* output, std::size_t sample_count) noexcept
-{
-    const std::size_t byte_per_sample{bits_per_sample / 8u};
-
-    if(bits_per_sample == 8)
-    {
-        for(std::size_t i{}; i < sample_count; ++i)
-        {
-            output[i] = static_cast<float>(static_cast<std::int32_t>(read_uint8(data + (i * byte_per_sample))) - 128) / static_cast<float>(0x80);
-        }
-    }
-    else if(bits_per_sample == 16)
-    {
-        for(std::size_t i{}; i < sample_count; ++i)
-        {
-            output[i] = static_cast<float>(read_int16(data + (i * byte_per_sample))) / static_cast<float>(0x8000);
-        }
-    }
-    else if(bits_per_sample == 24)
-    {
-        for(std::size_t i{}; i < sample_count; ++i)
-        {
-            output[i] = static_cast<float>(read_int24(data + (i * byte_per_sample))) / static_cast<float>(0x800000);
-        }
-    }
-    else if(bits_per_sample == 32)
-    {
-        for(std::size_t i{}; i < sample_count; ++i)
-        {
-            output[i] = static_cast<float>(read_int32(data + (i * byte_per_sample))) / static_cast<float>(0x80000000);
-        }
-    }
-}
-
 static constexpr std::array<std::uint8_t, 4> riff_block_id  {0x52, 0x49, 0x46, 0x46};
 static constexpr std::array<std::uint8_t, 4> riff_type_wave {0x57, 0x41, 0x56, 0x45};
 static constexpr std::array<std::uint8_t, 4> format_block_id{0x66, 0x6D, 0x74, 0x20};
@@ -154,6 +86,11 @@ public:
         return m_bits_per_sample;
     }
 
+    pcm_format format() const noexcept
+    {
+        return m_format;
+    }
+
 private:
     void init()
     {
@@ -220,14 +157,31 @@ private:
 
     void read_format_block(const std::uint8_t* block)
     {
-        if(read_uint16(block) != 1)
-        {
-            throw std::runtime_error{"swl::wave_reader invalid format. Only uncompressed (PCM) data are supported."};
-        }
+        const auto format_tag{read_uint16(block)};
 
         m_info.channel_count = static_cast<std::uint32_t>(read_uint16(block + 2));
         m_info.frequency     = read_uint32(block + 4);
         m_bits_per_sample    = static_cast<std::size_t>(read_uint16(block + 14));
+
+        if(format_tag == 1) //PCM
+        {
+            switch(m_bits_per_sample)
+            {
+                case 8:  m_format = pcm_format::u8;  break;
+                case 16: m_format = pcm_format::s16; break;
+                case 24: m_format = pcm_format::s24; break;
+                case 32: m_format = pcm_format::s32; break;
+                default: throw std::runtime_error{"swl::wave_reader invalid format. Only 8, 16, 24 and 32 bits PCM data are supported."};
+            }
+        }
+        else if(format_tag == 3 && m_bits_per_sample == 32) //IEEE float
+        {
+            m_format = pcm_format::f32;
+        }
+        else
+        {
+            throw std::runtime_error{"swl::wave_reader invalid format. Only uncompressed PCM and 32 bits float data are supported."};
+        }
     }
 
     bool read_source(std::uint8_t* output, std::size_t size)
@@ -307,6 +261,7 @@ private:
 
     sound_info m_info{};
     std::size_t m_bits_per_sample{};
+    pcm_format m_format{};
     std::size_t m_data_offset{};
     std::size_t m_data_size{};
 };
@@ -314,6 +269,15 @@ private:
 wave_reader::wave_reader(const std::filesystem::path& file, sound_reader_options options)
 :m_options{options}
 {
+    if(static_cast<bool>(m_options & sound_reader_options::mapped))
+    {
+        //Samples are converted straight from the mapping, as for memory sources
+        m_mapping = mapped_file{file};
+        init_from_memory(m_mapping.data());
+
+        return;
+    }
+
     std::ifstream ifs{file, std::ios_base::binary};
     if(!ifs)
         throw std::runtime_error{"Can not read file \"" + file.string() + "\"."};
@@ -322,6 +286,7 @@ wave_reader::wave_reader(const std::filesystem::path& file, sound_reader_options
     set_info(decoder.info());
     m_data_offset     = decoder.data_offset();
     m_bits_per_sample = decoder.bits_per_sample();
+    m_format          = decoder.format();
 
     if(static_cast<bool>(m_options & sound_reader_options::decoded))
     {
@@ -336,7 +301,7 @@ wave_reader::wave_reader(const std::filesystem::path& file, sound_reader_options
         const auto sample_count{sample_size(info().frame_count)};
 
         m_decoded_buffer.resize(sample_count);
-        read_samples(std::data(data), m_bits_per_sample, std::data(m_decoded_buffer), sample_count);
+        convert_pcm(m_format, std::data(data), std::data(m_decoded_buffer), sample_count);
     }
     else if(static_cast<bool>(m_options & sound_reader_options::buffered))
     {
@@ -361,72 +326,79 @@ wave_reader::wave_reader(const std::filesystem::path& file, sound_reader_options
 wave_reader::wave_reader(std::span<const std::uint8_t> data, sound_reader_options options)
 :m_options{options}
 {
-    wave_decoder decoder{data};
+    init_from_memory(data);
+}
+
+wave_reader::wave_reader(std::istream& stream, sound_reader_options options)
+:m_options{options}
+{
+    assert(stream && "Invalid stream.");
+
+    wave_decoder decoder{stream};
     set_info(decoder.info());
     m_data_offset     = decoder.data_offset();
     m_bits_per_sample = decoder.bits_per_sample();
+    m_format          = decoder.format();
 
     if(static_cast<bool>(m_options & sound_reader_options::decoded))
     {
         m_decoded_buffer.resize(sample_size(info().frame_count));
 
-        read_samples(std::data(data) + m_data_offset, m_bits_per_sample, std::data(m_decoded_buffer), std::size(m_decoded_buffer));
+        std::vector<std::uint8_t> data{};
+        data.resize(byte_size(info().frame_count));
+
+        stream.clear();
+        stream.seekg(m_data_offset, std::ios_base::beg);
+        if(!stream.read(reinterpret_cast<char*>(std::data(data)), static_cast<std::streamsize>(std::size(data))))
+            throw std::runtime_error{"Too short wave data."};
+
+        convert_pcm(m_format, std::data(data), std::data(m_decoded_buffer), sample_size(info().frame_count));
     }
     else if(static_cast<bool>(m_options & sound_reader_options::buffered))
     {
-        data = data.subspan(m_data_offset, byte_size(info().frame_count));
+        m_source_buffer.resize(byte_size(info().frame_count));
 
-        m_source_buffer.resize(std::size(data));
-        std::copy(std::begin(data), std::end(data), std::begin(m_source_buffer));
+        stream.clear();
+        stream.seekg(m_data_offset, std::ios_base::beg);
+        if(!stream.read(reinterpret_cast<char*>(std::data(m_source_buffer)), static_cast<std::streamsize>(std::size(m_source_buffer))))
+            throw std::runtime_error{"Too short wave data."};
 
         m_source = m_source_buffer;
     }
     else
     {
-        m_source = data.subspan(m_data_offset, byte_size(info().frame_count));
+        m_stream = &stream;
     }
 
     seek(0);
 }
 
-wave_reader::wave_reader(std::istream& stream, sound_reader_options options)
-:m_options{options}
+void wave_reader::init_from_memory(std::span<const std::uint8_t> data)
 {
-    assert(stream && "Invalid stream.");
-
-    wave_decoder decoder{stream};
+    wave_decoder decoder{data};
     set_info(decoder.info());
     m_data_offset     = decoder.data_offset();
     m_bits_per_sample = decoder.bits_per_sample();
+    m_format          = decoder.format();
 
     if(static_cast<bool>(m_options & sound_reader_options::decoded))
     {
         m_decoded_buffer.resize(sample_size(info().frame_count));
 
-        std::vector<std::uint8_t> data{};
-        data.resize(byte_size(info().frame_count));
-
-        stream.clear();
-        stream.seekg(m_data_offset, std::ios_base::beg);
-        if(!stream.read(reinterpret_cast<char*>(std::data(data)), static_cast<std::streamsize>(std::size(data))))
-            throw std::runtime_error{"Too short wave data."};
-
-        read_samples(std::data(data), m_bits_per_sample, std::data(m_decoded_buffer), sample_size(info().frame_count));
+        convert_pcm(m_format, std::data(data) + m_data_offset, std::data(m_decoded_buffer), std::size(m_decoded_buffer));
     }
     else if(static_cast<bool>(m_options & sound_reader_options::buffered))
     {
-        m_source_buffer.resize(byte_size(info().frame_count));
+        data = data.subspan(m_data_offset, byte_size(info().frame_count));
 
-        stream.clear();
-        stream.seekg(m_data_offset, std::ios_base::beg);
-        if(!stream.read(reinterpret_cast<char*>(std::data(m_source_buffer)), static_cast<std::streamsize>(std::size(m_source_buffer))))
-            throw std::runtime_error{"Too short wave data."};
+        m_source_buffer.resize(std::size(data));
+        std::copy(std::begin(data), std::end(data), std::begin(m_source_buffer));
 
         m_source = m_source_buffer;
     }
     else
     {
-        m_stream = &stream;
+        m_source = data.subspan(m_data_offset, byte_size(info().frame_count));
     }
 
     seek(0);
@@ -507,7 +479,7 @@ bool wave_reader::read_samples_from_memory(float* output, std::size_t frame_coun
         const auto size{byte_size(m_current_frame)};
         const auto max {(std::size(m_source) - size) / (m_bits_per_sample / 8)};
 
-        read_samples(std::data(m_source) + size, m_bits_per_sample, output, max);
+        convert_pcm(m_format, std::data(m_source) + size, output, max);
         std::fill(output + max, output + sample_size(frame_count), 0.0f);
 
         m_current_frame += frame_count;
@@ -516,7 +488,7 @@ bool wave_reader::read_samples_from_memory(float* output, std::size_t frame_coun
     }
     else
     {
-        read_samples(std::data(m_source) + byte_size(m_current_frame), m_bits_per_sample, output, sample_size(frame_count));
+        convert_pcm(m_format, std::data(m_source) + byte_size(m_current_frame), output, sample_size(frame_count));
 
         m_current_frame += frame_count;
 
@@ -530,7 +502,7 @@ bool wave_reader::read_samples_from_stream(float* output, std::size_t frame_coun
     m_source_buffer.resize(byte_size(frame_count));
 
     m_stream->read(reinterpret_cast<char*>(std::data(m_source_buffer)), std::size(m_source_buffer));
-    read_samples(std::data(m_source_buffer), m_bits_per_sample, output, sample_size(frame_count));
+    convert_pcm(m_format, std::data(m_source_buffer), output, sample_size(frame_count));
 
     m_current_frame += frame_count;
 
@@ -32,6 +32,8 @@
 #include <vector>
 
 #include "sound_reader.hpp"
+#include "pcm.hpp"
+#include "mapped_file.hpp"
 
 namespace swl
 {
@@ -55,6 +57,8 @@ public:
     std::uint64_t tell() override;
 
 private:
+    void init_from_memory(std::span<const std::uint8_t> data);
+
     std::size_t sample_size(std::size_t frame_count);
     std::size_t byte_size(std::size_t frame_count);
 
@@ -70,9 +74,11 @@ private:
     std::uint64_t m_current_frame{};
     std::size_t m_data_offset{};
     std::size_t m_bits_per_sample{};
+    pcm_format m_format{};
 
     std::vector<std::uint8_t> m_source_buffer{};
     std::ifstream m_file{};
+    mapped_file m_mapping{};
 
     std::vector<float> m_decoded_buffer{};
     std::span<const std::uint8_t> m_source{};
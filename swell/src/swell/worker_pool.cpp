@@ -0,0 +1,123 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "worker_pool.hpp"
+
+namespace swl
+{
+
+worker_pool::worker_pool(std::size_t thread_count)
+{
+    m_threads.reserve(thread_count);
+
+    for(std::size_t i{}; i < thread_count; ++i)
+    {
+        m_threads.emplace_back(&worker_pool::work, this);
+    }
+}
+
+worker_pool::~worker_pool()
+{
+    std::unique_lock lock{m_mutex};
+    m_stop = true;
+    lock.unlock();
+
+    m_start_condition.notify_all();
+
+    for(auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void worker_pool::run_impl(std::size_t task_count, task_type task, void* context)
+{
+    if(std::empty(m_threads) || task_count <= 1)
+    {
+        for(std::size_t i{}; i < task_count; ++i)
+        {
+            task(context, i);
+        }
+
+        return;
+    }
+
+    std::unique_lock lock{m_mutex};
+
+    m_task = task;
+    m_context = context;
+    m_task_count = task_count;
+    m_next.store(0, std::memory_order_relaxed);
+    m_running = std::size(m_threads);
+    ++m_generation;
+
+    lock.unlock();
+    m_start_condition.notify_all();
+
+    execute();
+
+    lock.lock();
+    m_end_condition.wait(lock, [this]
+    {
+        return m_running == 0;
+    });
+}
+
+void worker_pool::work() noexcept
+{
+    std::uint64_t generation{};
+
+    while(true)
+    {
+        std::unique_lock lock{m_mutex};
+        m_start_condition.wait(lock, [this, generation]
+        {
+            return m_stop || m_generation != generation;
+        });
+
+        if(m_stop)
+        {
+            break;
+        }
+
+        generation = m_generation;
+        lock.unlock();
+
+        execute();
+
+        lock.lock();
+        if(--m_running == 0)
+        {
+            m_end_condition.notify_one();
+        }
+    }
+}
+
+void worker_pool::execute() noexcept
+{
+    for(auto i{m_next.fetch_add(1, std::memory_order_relaxed)}; i < m_task_count; i = m_next.fetch_add(1, std::memory_order_relaxed))
+    {
+        m_task(m_context, i);
+    }
+}
+
+}
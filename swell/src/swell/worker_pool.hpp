@@ -0,0 +1,95 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef SWELL_WORKER_POOL_HPP_INCLUDED
+#define SWELL_WORKER_POOL_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+namespace swl
+{
+
+class SWELL_API worker_pool
+{
+    using task_type = void(*)(void* context, std::size_t index);
+
+public:
+    worker_pool() = default;
+    explicit worker_pool(std::size_t thread_count);
+
+    ~worker_pool();
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+    worker_pool(worker_pool&&) noexcept = delete;
+    worker_pool& operator=(worker_pool&&) noexcept = delete;
+
+    //Calls func(i) for each i in [0, task_count), the calling thread takes part in the work. Returns once every task has completed.
+    //func must not throw.
+    template<typename Func>
+    void run(std::size_t task_count, Func&& func)
+    {
+        using func_type = std::remove_reference_t<Func>;
+
+        const auto invoker = [](void* context, std::size_t index)
+        {
+            (*static_cast<func_type*>(context))(index);
+        };
+
+        run_impl(task_count, invoker, const_cast<void*>(static_cast<const void*>(std::addressof(func))));
+    }
+
+    std::size_t thread_count() const noexcept
+    {
+        return std::size(m_threads);
+    }
+
+private:
+    void run_impl(std::size_t task_count, task_type task, void* context);
+    void work() noexcept;
+    void execute() noexcept;
+
+private:
+    std::vector<std::thread> m_threads{};
+    std::mutex m_mutex{};
+    std::condition_variable m_start_condition{};
+    std::condition_variable m_end_condition{};
+    std::uint64_t m_generation{};
+    std::size_t m_running{};
+    bool m_stop{};
+
+    task_type m_task{};
+    void* m_context{};
+    std::size_t m_task_count{};
+    std::atomic<std::size_t> m_next{};
+};
+
+}
+
+#endif
@@ -0,0 +1,2218 @@
+#include <swell/audio_world.hpp>
+#include <swell/audio_pulser.hpp>
+#include <swell/mixing.hpp>
+#include <swell/pcm.hpp>
+#include <swell/sound_cache.hpp>
+#include <swell/sound_file.hpp>
+#include <swell/wave.hpp>
+#include <swell/mapped_file.hpp>
+#include <swell/prefetcher.hpp>
+#include <swell/offline_renderer.hpp>
+
+#include <vector>
+#include <thread>
+#include <random>
+#include <numeric>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <fstream>
+#include <filesystem>
+#include <map>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_CONSOLE_WIDTH 120
+#include <catch2/catch.hpp>
+
+TEST_CASE("Audio queue single thread", "[audio_queue]")
+{
+    swl::audio_queue queue{16};
+
+    REQUIRE(queue.capacity() == 16);
+    REQUIRE(queue.buffered() == 0);
+
+    SECTION("swl::audio_queue preserves order across wrap around")
+    {
+        float next{};
+        float expected{};
+
+        for(std::size_t i{}; i < 10; ++i)
+        {
+            const auto samples{queue.begin(12)};
+            std::iota(std::begin(samples), std::end(samples), next);
+            next += 12.0f;
+            queue.end();
+
+            REQUIRE(queue.buffered() == 12);
+
+            std::array<float, 12> output{};
+            REQUIRE(queue.drain_n(std::begin(output), std::size(output)) == 12);
+
+            for(const float value : output)
+            {
+                REQUIRE(value == expected);
+                expected += 1.0f;
+            }
+        }
+
+        REQUIRE(queue.underflows() == 0);
+        REQUIRE(queue.overflows() == 0);
+    }
+
+    SECTION("swl::audio_queue fills missing samples with silence and counts underflows")
+    {
+        const auto samples{queue.begin(4)};
+        std::fill(std::begin(samples), std::end(samples), 1.0f);
+        queue.end();
+
+        std::array<float, 8> output{};
+        std::fill(std::begin(output), std::end(output), 2.0f);
+        queue.drain(std::begin(output), std::size(output));
+
+        REQUIRE(std::count(std::begin(output), std::begin(output) + 4, 1.0f) == 4);
+        REQUIRE(std::count(std::begin(output) + 4, std::end(output), 0.0f) == 4);
+        REQUIRE(queue.underflows() == 4);
+        REQUIRE(queue.buffered() == 0);
+    }
+
+    SECTION("swl::audio_queue drops samples that do not fit and counts overflows")
+    {
+        queue.begin(20);
+        queue.end();
+
+        REQUIRE(queue.buffered() == 16);
+        REQUIRE(queue.overflows() == 4);
+
+        queue.discard(6);
+        REQUIRE(queue.buffered() == 10);
+
+        queue.discard();
+        REQUIRE(queue.buffered() == 0);
+    }
+}
+
+TEST_CASE("Audio queue producer/consumer stress test", "[audio_queue]")
+{
+    constexpr std::size_t total{1 << 22};
+
+    swl::audio_queue queue{4096};
+
+    std::thread producer{[&queue]()
+    {
+        std::mt19937 rng{42};
+        std::uniform_int_distribution<std::size_t> dist{1, 1024};
+
+        std::size_t written{};
+        while(written < total)
+        {
+            const auto count{std::min(dist(rng), total - written)};
+
+            while(queue.capacity() - queue.buffered() < count)
+            {
+                std::this_thread::yield();
+            }
+
+            const auto samples{queue.begin(count)};
+            for(auto& sample : samples)
+            {
+                sample = static_cast<float>(written++);
+            }
+
+            queue.end();
+        }
+    }};
+
+    std::mt19937 rng{1337};
+    std::uniform_int_distribution<std::size_t> dist{1, 1024};
+    std::vector<float> buffer{};
+
+    std::size_t read{};
+    std::size_t errors{};
+    while(read < total)
+    {
+        buffer.resize(dist(rng));
+
+        const auto count{queue.drain_n(std::begin(buffer), std::size(buffer))};
+        for(std::size_t i{}; i < count; ++i)
+        {
+            if(buffer[i] != static_cast<float>(read++))
+            {
+                ++errors;
+            }
+        }
+    }
+
+    producer.join();
+
+    REQUIRE(errors == 0);
+    REQUIRE(read == total);
+    REQUIRE(queue.buffered() == 0);
+    REQUIRE(queue.overflows() == 0);
+    REQUIRE(queue.underflows() == 0);
+}
+
+TEST_CASE("Triple buffer publishes consistent values", "[triple_buffer]")
+{
+    struct value
+    {
+        std::uint64_t first{};
+        std::uint64_t second{};
+    };
+
+    swl::impl::triple_buffer<value> buffer{};
+    REQUIRE(buffer.load().first == 0);
+
+    buffer.store(value{1, 2});
+    buffer.store(value{2, 4});
+    REQUIRE(buffer.load().first == 2);
+    REQUIRE(buffer.load().second == 4);
+
+    constexpr std::uint64_t count{1000000};
+
+    std::thread producer{[&buffer]()
+    {
+        for(std::uint64_t i{3}; i <= count; ++i)
+        {
+            buffer.store(value{i, i * 2});
+        }
+    }};
+
+    std::uint64_t last{2};
+    bool consistent{true};
+    while(last < count)
+    {
+        const auto current{buffer.load()};
+
+        consistent = consistent && current.second == current.first * 2 && current.first >= last;
+        last = current.first;
+    }
+
+    producer.join();
+
+    REQUIRE(consistent);
+}
+
+class synthetic_reader final : public swl::sound_reader
+{
+public:
+    synthetic_reader(std::uint32_t channel_count, float frequency, float amplitude, std::uint32_t sample_rate = 48000)
+    :m_step{2.0 * 3.14159265358979 * frequency / sample_rate}
+    ,m_amplitude{amplitude}
+    {
+        set_info(swl::sound_info{std::numeric_limits<std::uint64_t>::max() / 2, sample_rate, channel_count, true});
+    }
+
+    bool read(float* output, std::size_t frame_count) override
+    {
+        for(std::size_t i{}; i < frame_count; ++i)
+        {
+            const auto value{static_cast<float>(m_amplitude * std::sin(m_step * static_cast<double>(m_position + i)))};
+
+            for(std::size_t j{}; j < info().channel_count; ++j)
+            {
+                *output++ = value;
+            }
+        }
+
+        m_position += frame_count;
+
+        return true;
+    }
+
+    void seek(std::uint64_t frame) override
+    {
+        m_position = frame;
+    }
+
+    std::uint64_t tell() override
+    {
+        return m_position;
+    }
+
+private:
+    double m_step{};
+    double m_amplitude{};
+    std::uint64_t m_position{};
+};
+
+static std::vector<swl::sound> make_synthetic_sounds(swl::audio_world& world, std::size_t count)
+{
+    std::vector<swl::sound> output{};
+    output.reserve(count);
+
+    for(std::size_t i{}; i < count; ++i)
+    {
+        auto& sound{output.emplace_back(world, std::make_unique<synthetic_reader>(i % 2 == 0 ? 1 : 2, 110.0f + static_cast<float>(i), 1.0f / static_cast<float>(count)))};
+
+        if(i % 4 == 0)
+        {
+            sound.enable_spatialization();
+            sound.move_to(swl::vec3f{static_cast<float>(i % 7) - 3.0f, 0.0f, 2.0f});
+        }
+
+        sound.start();
+    }
+
+    return output;
+}
+
+static std::vector<float> render_synthetic(std::size_t worker_count, std::size_t voice_count, std::size_t block_count, std::size_t frame_count)
+{
+    swl::audio_world world{48000, worker_count};
+    swl::listener listener{2};
+    auto sounds{make_synthetic_sounds(world, voice_count)};
+
+    std::vector<float> output{};
+    output.resize(block_count * frame_count * 2);
+
+    for(std::size_t i{}; i < block_count; ++i)
+    {
+        world.bind_listener(listener);
+        world.generate(frame_count);
+
+        listener.drain_n(std::data(output) + i * frame_count * 2, frame_count);
+    }
+
+    return output;
+}
+
+TEST_CASE("Audio world multithreaded generation", "[audio_world]")
+{
+    const auto reference{render_synthetic(0, 37, 8, 480)};
+    const auto threaded {render_synthetic(3, 37, 8, 480)};
+
+    REQUIRE(std::size(reference) == std::size(threaded));
+
+    std::size_t mismatches{};
+    for(std::size_t i{}; i < std::size(reference); ++i)
+    {
+        if(std::abs(reference[i] - threaded[i]) > 1.0e-5f)
+        {
+            ++mismatches;
+        }
+    }
+
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Demand-driven audio pulser", "[audio_pulser]")
+{
+    constexpr std::size_t block_size{128};
+    constexpr std::size_t blocks_in_flight{3};
+    constexpr std::size_t limit{block_size * blocks_in_flight};
+
+    swl::audio_world world{48000};
+    auto sounds{make_synthetic_sounds(world, 8)};
+
+    swl::audio_pulser pulser{world, swl::pulser_demand_info{block_size, blocks_in_flight}};
+    REQUIRE(pulser.mode() == swl::pulser_mode::demand);
+
+    auto bind{pulser.bind(swl::listener{2})};
+    pulser.start();
+
+    std::vector<float> output{};
+    output.resize(96 * 2);
+
+    std::size_t drained{};
+    std::size_t max_buffered{};
+    const auto timeout{std::chrono::steady_clock::now() + std::chrono::seconds{10}};
+
+    while(drained < 48000 && std::chrono::steady_clock::now() < timeout)
+    {
+        max_buffered = std::max(max_buffered, bind->buffered() / 2);
+        drained += bind->drain_n(std::data(output), std::size(output) / 2) / 2;
+        std::this_thread::yield();
+    }
+
+    REQUIRE(drained >= 48000);
+    REQUIRE(max_buffered <= limit);
+
+    //Nothing is drained anymore, the pulser must stop at the limit and sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    const auto stats{pulser.statistics()};
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+    REQUIRE(pulser.statistics().block_count == stats.block_count);
+    REQUIRE(bind->buffered() / 2 <= limit);
+    REQUIRE(bind->buffered() / 2 + block_size > limit);
+
+    REQUIRE(stats.block_count >= drained / block_size);
+    REQUIRE(stats.max_latency.count() <= static_cast<double>(limit) / 48000.0);
+    REQUIRE(stats.mean_generation_time.count() > 0.0);
+    REQUIRE(stats.mean_generation_time <= stats.max_generation_time);
+
+    pulser.reset_statistics();
+    REQUIRE(pulser.statistics().block_count == 0);
+
+    //stop must wake up the sleeping thread
+    pulser.stop();
+    REQUIRE(pulser.status() == swl::pulser_status::stopped);
+
+    bind.unregister();
+}
+
+TEST_CASE("Listener unbound while it is drained", "[audio_pulser]")
+{
+    swl::audio_world world{48000};
+    auto sounds{make_synthetic_sounds(world, 2)};
+
+    for(std::size_t i{}; i < 20; ++i)
+    {
+        auto pulser{std::make_unique<swl::audio_pulser>(world, swl::pulser_demand_info{64, 2})};
+        auto bind{pulser->bind(swl::listener{2})};
+        auto& queue{bind->queue()};
+
+        std::atomic<bool> stop{};
+        std::thread consumer{[&queue, &stop]()
+        {
+            std::array<float, 64> output{};
+
+            while(!stop.load(std::memory_order_relaxed))
+            {
+                queue.drain_n(std::begin(output), std::size(output));
+            }
+        }};
+
+        pulser->start();
+        std::this_thread::sleep_for(std::chrono::milliseconds{2});
+
+        //The consumer must not signal the pulser's drain signal once it is destroyed
+        auto listener{bind.unregister()};
+        pulser.reset();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        stop.store(true, std::memory_order_relaxed);
+        consumer.join();
+
+        REQUIRE(listener.queue().capacity() > 0);
+    }
+}
+
+TEST_CASE("swl::audio_world generate benchmark", "[audio_world_bench]")
+{
+    constexpr std::size_t voice_count{256};
+    constexpr std::size_t frame_count{480};
+    constexpr std::size_t block_count{100};
+
+    const std::size_t max_workers{std::max(std::thread::hardware_concurrency(), 2u) - 1};
+
+    for(std::size_t worker_count{}; worker_count <= max_workers; ++worker_count)
+    {
+        swl::audio_world world{48000, worker_count};
+        swl::listener listener{2};
+        auto sounds{make_synthetic_sounds(world, voice_count)};
+
+        const auto begin{std::chrono::steady_clock::now()};
+
+        for(std::size_t i{}; i < block_count; ++i)
+        {
+            world.bind_listener(listener);
+            world.generate(frame_count);
+
+            listener.queue().discard();
+        }
+
+        const std::chrono::duration<double> time{std::chrono::steady_clock::now() - begin};
+
+        std::cout << voice_count << " voices, " << worker_count << " worker threads: " << static_cast<double>(block_count * frame_count) / time.count() << " frames/s" << std::endl;
+    }
+}
+
+class constant_reader final : public swl::sound_reader
+{
+public:
+    constant_reader(std::uint32_t channel_count, float value)
+    :m_value{value}
+    {
+        set_info(swl::sound_info{std::numeric_limits<std::uint64_t>::max() / 2, 48000, channel_count, true});
+    }
+
+    bool read(float* output, std::size_t frame_count) override
+    {
+        std::fill_n(output, frame_count * info().channel_count, m_value);
+        m_position += frame_count;
+
+        return true;
+    }
+
+    void seek(std::uint64_t frame) override
+    {
+        m_position = frame;
+    }
+
+    std::uint64_t tell() override
+    {
+        return m_position;
+    }
+
+private:
+    float m_value{};
+    std::uint64_t m_position{};
+};
+
+template<typename Func>
+static std::vector<float> render_gain(std::size_t block_count, std::size_t frame_count, Func&& update)
+{
+    swl::audio_world world{48000};
+    swl::listener listener{1};
+    swl::sound sound{world, std::make_unique<constant_reader>(1, 1.0f)};
+
+    std::vector<float> output{};
+    output.resize(block_count * frame_count);
+
+    for(std::size_t i{}; i < block_count; ++i)
+    {
+        update(sound, i);
+
+        world.bind_listener(listener);
+        world.generate(frame_count);
+
+        listener.drain_n(std::data(output) + i * frame_count, frame_count);
+    }
+
+    return output;
+}
+
+static float max_step(const std::vector<float>& samples) noexcept
+{
+    float output{};
+    for(std::size_t i{1}; i < std::size(samples); ++i)
+    {
+        output = std::max(output, std::abs(samples[i] - samples[i - 1]));
+    }
+
+    return output;
+}
+
+TEST_CASE("Audio world fading and volume ramps", "[audio_world]")
+{
+    constexpr std::size_t block_count{20};
+    constexpr std::size_t frame_count{480};
+    constexpr std::size_t fading{4800};
+
+    SECTION("Fade out")
+    {
+        swl::sound_status status{};
+        const auto output{render_gain(block_count, frame_count, [&status](swl::sound& sound, std::size_t block)
+        {
+            if(block == 0)
+            {
+                sound.start();
+                sound.fade_out(fading);
+            }
+
+            status = sound.status();
+        })};
+
+        REQUIRE(status == swl::sound_status::ended);
+        REQUIRE(output[0] == Approx(1.0f).margin(1.0e-3));
+        REQUIRE(std::is_sorted(std::rbegin(output), std::rend(output)));
+        REQUIRE(std::all_of(std::begin(output) + fading, std::end(output), [](float value){ return value == 0.0f; }));
+        REQUIRE(max_step(output) < 0.01f);
+    }
+
+    SECTION("Fade in")
+    {
+        swl::sound_status status{};
+        const auto output{render_gain(block_count, frame_count, [&status](swl::sound& sound, std::size_t block)
+        {
+            if(block == 0)
+            {
+                sound.fade_in(fading);
+            }
+
+            status = sound.status();
+        })};
+
+        REQUIRE(status == swl::sound_status::playing);
+        REQUIRE(output[0] == 0.0f);
+        REQUIRE(std::is_sorted(std::begin(output), std::end(output)));
+        REQUIRE(std::all_of(std::begin(output) + fading, std::end(output), [](float value){ return value == Approx(1.0f); }));
+        REQUIRE(max_step(output) < 0.01f);
+    }
+
+    SECTION("Volume changes are ramped over a block")
+    {
+        const auto output{render_gain(block_count, frame_count, [](swl::sound& sound, std::size_t block)
+        {
+            if(block == 0)
+            {
+                sound.start();
+            }
+            else if(block == 5)
+            {
+                sound.set_volume(0.0f);
+            }
+            else if(block == 10)
+            {
+                sound.set_volume(1.0f);
+            }
+        })};
+
+        REQUIRE(output[5 * frame_count - 1] == Approx(1.0f));
+        REQUIRE(output[6 * frame_count] == 0.0f);
+        REQUIRE(output[11 * frame_count] == Approx(1.0f));
+        REQUIRE(max_step(output) < 0.01f);
+    }
+}
+
+TEST_CASE("Sound changes are applied by the audio thread", "[audio_world]")
+{
+    constexpr std::size_t frame_count{480};
+
+    swl::audio_world world{48000};
+    swl::listener listener{1};
+    swl::sound sound{world, std::make_unique<synthetic_reader>(1, 440.0f, 0.5f)};
+
+    std::vector<float> output{};
+    output.resize(frame_count);
+
+    const auto generate = [&]()
+    {
+        world.bind_listener(listener);
+        world.generate(frame_count);
+        listener.drain_n(std::data(output), frame_count);
+    };
+
+    SECTION("Getters return the requested state until it is applied")
+    {
+        sound.start();
+        sound.seek(1000);
+        sound.pause();
+
+        REQUIRE(sound.status() == swl::sound_status::paused);
+        REQUIRE(sound.tell() == 1000);
+
+        generate();
+
+        REQUIRE(sound.status() == swl::sound_status::paused);
+        REQUIRE(sound.tell() == 1000);
+
+        sound.resume();
+        generate();
+
+        REQUIRE(sound.status() == swl::sound_status::playing);
+        REQUIRE(sound.tell() == 1000 + frame_count);
+    }
+
+    SECTION("Only the last status of a block is applied")
+    {
+        sound.start();
+        sound.stop();
+        sound.start();
+        generate();
+
+        REQUIRE(sound.status() == swl::sound_status::playing);
+        REQUIRE(sound.tell() == frame_count);
+
+        sound.stop();
+        generate();
+
+        REQUIRE(sound.status() == swl::sound_status::stopped);
+        REQUIRE(sound.tell() == frame_count);
+    }
+
+    SECTION("Readers of stopped sounds are changed without waiting for the audio thread")
+    {
+        sound.start();
+        generate();
+        sound.stop();
+        generate();
+
+        auto old{sound.change_reader(std::make_unique<synthetic_reader>(1, 220.0f, 0.5f))};
+
+        REQUIRE(old != nullptr);
+        REQUIRE(sound.status() == swl::sound_status::stopped);
+        REQUIRE(sound.tell() == 0);
+
+        sound.start();
+        generate();
+
+        REQUIRE(sound.tell() == frame_count);
+    }
+
+    SECTION("Readers of playing sounds are changed once the audio thread stopped them")
+    {
+        sound.start();
+
+        std::atomic<bool> running{true};
+        std::thread thread{[&]()
+        {
+            while(running.load())
+            {
+                world.discard(frame_count);
+            }
+        }};
+
+        for(std::size_t i{}; i < 100; ++i)
+        {
+            auto old{sound.change_reader(std::make_unique<synthetic_reader>(1, 220.0f, 0.5f))};
+
+            REQUIRE(old != nullptr);
+            REQUIRE(sound.status() == swl::sound_status::stopped);
+
+            sound.start();
+        }
+
+        running.store(false);
+        thread.join();
+    }
+}
+
+static void reference_apply_fading(float* samples, std::size_t frame_count, std::size_t channel_count, std::uint64_t current_fading, std::uint64_t fading)
+{
+    for(std::size_t i{}; i < frame_count; ++i)
+    {
+        const float fading_percent{1.0f - (static_cast<float>(current_fading + i) / static_cast<float>(fading))};
+        const float multiplier{std::sqrt(std::pow(10.0f, fading_percent * 3.0f) / 1000.0f)};
+
+        for(std::size_t j{}; j < channel_count; ++j)
+        {
+            samples[i * channel_count + j] *= multiplier;
+        }
+    }
+}
+
+TEST_CASE("Audio world fading benchmark", "[fading_bench]")
+{
+    constexpr std::size_t voice_count{64};
+    constexpr std::size_t frame_count{480};
+
+    SECTION("Per-frame std::pow, as apply_fading used to do")
+    {
+        std::vector<float> samples{};
+        samples.resize(voice_count * frame_count * 2, 0.5f);
+
+        BENCHMARK("Reference fading, 64 stereo voices")
+        {
+            for(std::size_t i{}; i < voice_count; ++i)
+            {
+                reference_apply_fading(std::data(samples) + i * frame_count * 2, frame_count, 2, 1000, 1000000);
+            }
+
+            return samples[0];
+        };
+    }
+
+    for(const bool fading : {false, true})
+    {
+        swl::audio_world world{48000};
+        swl::listener listener{2};
+
+        std::vector<swl::sound> sounds{};
+        sounds.reserve(voice_count);
+
+        for(std::size_t i{}; i < voice_count; ++i)
+        {
+            auto& sound{sounds.emplace_back(world, std::make_unique<constant_reader>(2, 0.5f / voice_count))};
+
+            if(fading)
+            {
+                sound.start();
+                sound.fade_out(std::numeric_limits<std::uint64_t>::max() - 1);
+            }
+            else
+            {
+                sound.start();
+            }
+        }
+
+        BENCHMARK(std::string{"audio_world generate, 64 stereo voices, "} + (fading ? "fading" : "steady"))
+        {
+            world.bind_listener(listener);
+            world.generate(frame_count);
+            listener.queue().discard();
+
+            return listener.queue().buffered();
+        };
+    }
+}
+
+//Reference implementations, as audio_world used to mix before the kernels were vectorized
+static constexpr float reference_fast_pow(float value, std::size_t count) noexcept
+{
+    if(value == 0.0f)
+    {
+        return 0.0f;
+    }
+
+    if(value == 1.0f)
+    {
+        return 1.0f;
+    }
+
+    if(count == 0)
+    {
+        return 1.0f;
+    }
+
+    float output{1.0f};
+
+    if(count % 2 == 1)
+    {
+        output *= value;
+    }
+
+    for(std::size_t i{count / 2}; i != 0; i /= 2)
+    {
+        value *= value;
+
+        if(i % 2 == 1)
+        {
+            output *= value;
+        }
+    }
+
+    return output;
+}
+
+static float reference_mix_amplitude(float value, std::size_t count) noexcept
+{
+    return (value >= 0.0f ? 1.0f : -1.0f) * (1.0f - reference_fast_pow(1.0f - std::abs(value), count));
+}
+
+static std::vector<float> random_samples(std::size_t count, float amplitude, std::uint32_t seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_real_distribution<float> dist{-amplitude, amplitude};
+
+    std::vector<float> output{};
+    output.resize(count);
+
+    for(auto& sample : output)
+    {
+        sample = dist(rng);
+    }
+
+    return output;
+}
+
+static std::size_t count_mismatches(const std::vector<float>& left, const std::vector<float>& right, float tolerance)
+{
+    std::size_t output{};
+
+    for(std::size_t i{}; i < std::size(left); ++i)
+    {
+        if(std::abs(left[i] - right[i]) > tolerance)
+        {
+            ++output;
+        }
+    }
+
+    return output;
+}
+
+static std::vector<swl::simd_level> supported_simd_levels()
+{
+    std::vector<swl::simd_level> output{};
+
+    for(const auto level : {swl::simd_level::none, swl::simd_level::sse2, swl::simd_level::avx2, swl::simd_level::neon})
+    {
+        if(swl::is_simd_level_supported(level))
+        {
+            output.emplace_back(level);
+        }
+    }
+
+    return output;
+}
+
+static std::string simd_level_name(swl::simd_level level)
+{
+    switch(level)
+    {
+        case swl::simd_level::sse2: return "SSE2";
+        case swl::simd_level::avx2: return "AVX2";
+        case swl::simd_level::neon: return "NEON";
+        default: return "scalar";
+    }
+}
+
+TEST_CASE("Mixing kernels match the scalar mixing", "[mixing]")
+{
+    constexpr std::size_t frame_count{1037}; //not a multiple of any vector size, to test the tails
+    constexpr float tolerance{1.0e-6f};
+
+    const auto mono  {random_samples(frame_count, 1.0f, 1)};
+    const auto stereo{random_samples(frame_count * 2, 1.0f, 2)};
+    const auto base  {random_samples(frame_count * 2, 0.5f, 3)};
+
+    for(const auto level : supported_simd_levels())
+    {
+        const auto& kernels{swl::get_mixing_kernels(level)};
+
+        REQUIRE(kernels.level == level);
+
+        SECTION("Gain and accumulate, " + simd_level_name(level))
+        {
+            auto expected{base};
+            for(std::size_t i{}; i < std::size(stereo); ++i)
+            {
+                expected[i] += stereo[i] * 0.7f;
+            }
+
+            auto output{base};
+            kernels.accumulate(std::data(output), std::data(stereo), std::size(stereo), 0.7f);
+
+            REQUIRE(count_mismatches(expected, output, tolerance) == 0);
+        }
+
+        SECTION("Mono to stereo pan, " + simd_level_name(level))
+        {
+            const float factor{0.8f};
+            const float sine  {0.35f};
+
+            auto expected{base};
+            for(std::size_t i{}; i < frame_count; ++i)
+            {
+                expected[i * 2]     += mono[i] * factor * ((-sine) + 2.0f) / 4.0f;
+                expected[i * 2 + 1] += mono[i] * factor * (sine + 2.0f) / 4.0f;
+            }
+
+            auto output{base};
+            kernels.pan(std::data(output), std::data(mono), frame_count, factor * ((-sine) + 2.0f) / 4.0f, factor * (sine + 2.0f) / 4.0f);
+
+            REQUIRE(count_mismatches(expected, output, tolerance) == 0);
+        }
+
+        SECTION("Stereo downmix, " + simd_level_name(level))
+        {
+            std::vector<float> expected{std::begin(base), std::begin(base) + frame_count};
+            for(std::size_t i{}; i < frame_count; ++i)
+            {
+                expected[i] += reference_mix_amplitude((stereo[i * 2] + stereo[i * 2 + 1]) * 0.6f, 2);
+            }
+
+            std::vector<float> output{std::begin(base), std::begin(base) + frame_count};
+            kernels.downmix(std::data(output), std::data(stereo), frame_count, 0.6f);
+
+            REQUIRE(count_mismatches(expected, output, tolerance) == 0);
+        }
+
+        SECTION("Soft clip, " + simd_level_name(level))
+        {
+            for(const std::size_t sound_count : {1u, 2u, 3u, 7u, 64u, 257u})
+            {
+                auto expected{stereo};
+                for(auto& sample : expected)
+                {
+                    sample = reference_mix_amplitude(sample, sound_count);
+                }
+
+                auto output{stereo};
+                kernels.soft_clip(std::data(output), std::size(output), sound_count);
+
+                REQUIRE(count_mismatches(expected, output, tolerance) == 0);
+            }
+        }
+
+        SECTION("Dot product, " + simd_level_name(level))
+        {
+            for(const std::size_t count : {0u, 2u, 7u, 32u, 1037u})
+            {
+                double expected{};
+                for(std::size_t i{}; i < count; ++i)
+                {
+                    expected += static_cast<double>(stereo[i]) * static_cast<double>(base[i]);
+                }
+
+                REQUIRE(std::abs(kernels.dot(std::data(stereo), std::data(base), count) - expected) < 1.0e-4);
+            }
+        }
+    }
+}
+
+TEST_CASE("Mixing kernels benchmark", "[mixing_bench]")
+{
+    constexpr std::size_t frame_count{4800};
+
+    const auto mono  {random_samples(frame_count, 1.0f, 1)};
+    const auto stereo{random_samples(frame_count * 2, 1.0f, 2)};
+
+    std::vector<float> output{};
+    output.resize(frame_count * 2);
+
+    for(const auto level : supported_simd_levels())
+    {
+        const auto& kernels{swl::get_mixing_kernels(level)};
+        const auto name{simd_level_name(level)};
+
+        BENCHMARK("Gain and accumulate, " + name)
+        {
+            kernels.accumulate(std::data(output), std::data(stereo), std::size(stereo), 0.5f);
+            return output[0];
+        };
+
+        BENCHMARK("Mono to stereo pan, " + name)
+        {
+            kernels.pan(std::data(output), std::data(mono), frame_count, 0.25f, 0.75f);
+            return output[0];
+        };
+
+        BENCHMARK("Stereo downmix, " + name)
+        {
+            kernels.downmix(std::data(output), std::data(stereo), frame_count, 0.5f);
+            return output[0];
+        };
+
+        BENCHMARK("Soft clip, " + name)
+        {
+            std::copy(std::begin(stereo), std::end(stereo), std::begin(output));
+            kernels.soft_clip(std::data(output), std::size(output), 200);
+            return output[0];
+        };
+
+        BENCHMARK("Dot product 32 taps x 4800, " + name)
+        {
+            float sum{};
+            for(std::size_t i{}; i < frame_count; ++i)
+            {
+                sum += kernels.dot(std::data(stereo) + i, std::data(mono), swl::resampling_reader::sinc_taps);
+            }
+
+            return sum;
+        };
+    }
+}
+
+static std::vector<std::uint8_t> random_bytes(std::size_t count, std::uint32_t seed)
+{
+    std::mt19937 engine{seed};
+    std::uniform_int_distribution<std::uint32_t> distribution{0, 255};
+
+    std::vector<std::uint8_t> output{};
+    output.reserve(count);
+
+    for(std::size_t i{}; i < count; ++i)
+    {
+        output.push_back(static_cast<std::uint8_t>(distribution(engine)));
+    }
+
+    return output;
+}
+
+//Straightforward conversion, independent from the library's scalar kernels
+static float reference_pcm_sample(swl::pcm_format format, const std::uint8_t* data)
+{
+    switch(format)
+    {
+        case swl::pcm_format::u8:
+            return (static_cast<float>(data[0]) - 128.0f) / 128.0f;
+
+        case swl::pcm_format::s16:
+            return static_cast<float>(static_cast<std::int16_t>(data[0] | (data[1] << 8))) / 32768.0f;
+
+        case swl::pcm_format::s24:
+        {
+            std::int32_t value{data[0] | (data[1] << 8) | (data[2] << 16)};
+            if(value >= 0x800000)
+            {
+                value -= 0x1000000;
+            }
+
+            return static_cast<float>(value) / 8388608.0f;
+        }
+
+        case swl::pcm_format::s32:
+        {
+            std::int32_t value{};
+            std::memcpy(&value, data, sizeof(value));
+
+            return static_cast<float>(value) / 2147483648.0f;
+        }
+
+        default:
+        {
+            float value{};
+            std::memcpy(&value, data, sizeof(value));
+
+            return value;
+        }
+    }
+}
+
+static std::string pcm_format_name(swl::pcm_format format)
+{
+    constexpr std::array names{"u8", "s16", "s24", "s32", "f32"};
+
+    return names[static_cast<std::size_t>(format)];
+}
+
+static constexpr std::array pcm_formats{swl::pcm_format::u8, swl::pcm_format::s16, swl::pcm_format::s24, swl::pcm_format::s32, swl::pcm_format::f32};
+
+TEST_CASE("PCM conversion kernels", "[pcm]")
+{
+    constexpr std::size_t sample_count{1037}; //not a multiple of any vector size, to test the tails
+
+    for(const auto level : supported_simd_levels())
+    {
+        const auto& kernels{swl::get_pcm_kernels(level)};
+
+        REQUIRE(kernels.level == level);
+
+        for(const auto format : pcm_formats)
+        {
+            SECTION("Conversion from " + pcm_format_name(format) + ", " + simd_level_name(level))
+            {
+                const auto size{swl::pcm_format_size(format)};
+
+                //Starts at an odd offset so no load is aligned
+                auto data{random_bytes(sample_count * size + 1, static_cast<std::uint32_t>(format))};
+                if(format == swl::pcm_format::f32)
+                {
+                    for(std::size_t i{}; i < sample_count; ++i)
+                    {
+                        const float value{static_cast<float>(data[i * 4 + 1]) / 255.0f - 0.5f};
+                        std::memcpy(std::data(data) + 1 + i * 4, &value, sizeof(value));
+                    }
+                }
+
+                //Extremes of each format
+                if(format == swl::pcm_format::s24)
+                {
+                    const std::array<std::uint8_t, 6> extremes{0x00, 0x00, 0x80, 0xFF, 0xFF, 0x7F};
+                    std::copy(std::begin(extremes), std::end(extremes), std::begin(data) + 1);
+                }
+
+                std::vector<float> output{};
+                output.resize(sample_count);
+                kernels.convert(format)(std::data(output), std::data(data) + 1, sample_count);
+
+                std::size_t mismatches{};
+                for(std::size_t i{}; i < sample_count; ++i)
+                {
+                    if(output[i] != reference_pcm_sample(format, std::data(data) + 1 + i * size))
+                    {
+                        ++mismatches;
+                    }
+                }
+
+                REQUIRE(mismatches == 0);
+
+                if(format == swl::pcm_format::s24)
+                {
+                    REQUIRE(output[0] == -1.0f);
+                    REQUIRE(output[1] == Approx{1.0f}.margin(1.0e-6));
+                }
+            }
+        }
+
+        for(const std::uint32_t channel_count : {1u, 2u, 3u})
+        {
+            SECTION("Interleaving and deinterleaving " + std::to_string(channel_count) + " channels, " + simd_level_name(level))
+            {
+                const auto bytes{random_bytes(sample_count * channel_count * 4, channel_count)};
+
+                std::vector<std::vector<std::int32_t>> planar{};
+                std::vector<const std::int32_t*> planar_pointers{};
+                for(std::uint32_t j{}; j < channel_count; ++j)
+                {
+                    auto& channel{planar.emplace_back()};
+                    channel.resize(sample_count);
+                    std::memcpy(std::data(channel), std::data(bytes) + j * sample_count * 4, sample_count * 4);
+
+                    planar_pointers.push_back(std::data(channel));
+                }
+
+                const float factor{1.0f / 65536.0f};
+
+                std::vector<float> interleaved{};
+                interleaved.resize(sample_count * channel_count);
+                kernels.interleave_s32(std::data(interleaved), std::data(planar_pointers), sample_count, channel_count, factor);
+
+                std::size_t mismatches{};
+                for(std::size_t i{}; i < sample_count; ++i)
+                {
+                    for(std::uint32_t j{}; j < channel_count; ++j)
+                    {
+                        if(interleaved[i * channel_count + j] != static_cast<float>(planar[j][i]) * factor)
+                        {
+                            ++mismatches;
+                        }
+                    }
+                }
+
+                REQUIRE(mismatches == 0);
+
+                std::vector<std::vector<float>> deinterleaved{};
+                std::vector<float*> deinterleaved_pointers{};
+                for(std::uint32_t j{}; j < channel_count; ++j)
+                {
+                    deinterleaved_pointers.push_back(std::data(deinterleaved.emplace_back(sample_count)));
+                }
+
+                kernels.deinterleave(std::data(deinterleaved_pointers), std::data(interleaved), sample_count, channel_count);
+
+                for(std::size_t i{}; i < sample_count; ++i)
+                {
+                    for(std::uint32_t j{}; j < channel_count; ++j)
+                    {
+                        if(deinterleaved[j][i] != interleaved[i * channel_count + j])
+                        {
+                            ++mismatches;
+                        }
+                    }
+                }
+
+                REQUIRE(mismatches == 0);
+            }
+        }
+    }
+
+    SECTION("Planar conversion")
+    {
+        constexpr std::size_t frame_count{5000}; //more than one conversion chunk
+
+        const auto data{random_bytes(frame_count * 2 * 3, 42)};
+
+        std::vector<float> interleaved{};
+        interleaved.resize(frame_count * 2);
+        swl::convert_pcm(swl::pcm_format::s24, std::data(data), std::data(interleaved), frame_count * 2);
+
+        std::vector<float> left(frame_count);
+        std::vector<float> right(frame_count);
+        const std::array outputs{std::data(left), std::data(right)};
+        swl::convert_pcm_planar(swl::pcm_format::s24, std::data(data), std::data(outputs), frame_count, 2);
+
+        std::size_t mismatches{};
+        for(std::size_t i{}; i < frame_count; ++i)
+        {
+            if(left[i] != interleaved[i * 2] || right[i] != interleaved[i * 2 + 1])
+            {
+                ++mismatches;
+            }
+        }
+
+        REQUIRE(mismatches == 0);
+    }
+}
+
+TEST_CASE("PCM conversion benchmark", "[pcm_bench]")
+{
+    constexpr std::size_t sample_count{48000 * 2};
+
+    const auto data{random_bytes(sample_count * 4, 7)};
+
+    std::vector<std::int32_t> left(sample_count / 2);
+    std::vector<std::int32_t> right(sample_count / 2);
+    const std::array<const std::int32_t*, 2> planar{std::data(left), std::data(right)};
+
+    std::vector<float> output{};
+    output.resize(sample_count);
+
+    for(const auto level : supported_simd_levels())
+    {
+        const auto& kernels{swl::get_pcm_kernels(level)};
+        const auto name{simd_level_name(level)};
+
+        for(const auto format : {swl::pcm_format::u8, swl::pcm_format::s16, swl::pcm_format::s24, swl::pcm_format::s32})
+        {
+            BENCHMARK("1s of stereo " + pcm_format_name(format) + ", " + name)
+            {
+                kernels.convert(format)(std::data(output), std::data(data), sample_count);
+                return output[0];
+            };
+        }
+
+        BENCHMARK("1s of planar stereo s32 interleaving, " + name)
+        {
+            kernels.interleave_s32(std::data(output), std::data(planar), sample_count / 2, 2, 1.0f / 32768.0f);
+            return output[0];
+        };
+    }
+}
+
+static std::vector<float> read_all(swl::sound_reader& reader, std::size_t frame_count)
+{
+    std::vector<float> output{};
+    output.resize(frame_count * reader.info().channel_count);
+
+    reader.read(std::data(output), frame_count);
+
+    return output;
+}
+
+static float max_sine_error(const std::vector<float>& samples, std::uint32_t channel_count, double frequency, double amplitude, std::uint32_t sample_rate, std::size_t margin)
+{
+    const double step{2.0 * 3.14159265358979 * frequency / sample_rate};
+    const std::size_t frame_count{std::size(samples) / channel_count};
+
+    double output{};
+    for(std::size_t i{margin}; i < frame_count - margin; ++i)
+    {
+        const double expected{amplitude * std::sin(step * static_cast<double>(i))};
+
+        for(std::size_t j{}; j < channel_count; ++j)
+        {
+            output = std::max(output, std::abs(samples[i * channel_count + j] - expected));
+        }
+    }
+
+    return static_cast<float>(output);
+}
+
+TEST_CASE("Resampling reader", "[resampler]")
+{
+    constexpr std::size_t frame_count{9600};
+
+    SECTION("Frequency and length")
+    {
+        auto source{std::make_unique<synthetic_reader>(2, 1000.0f, 0.5f, 44100)};
+        const auto source_ptr{source.get()};
+
+        swl::resampling_reader reader{std::move(source), 48000};
+
+        REQUIRE(reader.info().frequency == 48000);
+        REQUIRE(reader.info().channel_count == 2);
+        REQUIRE(reader.info().seekable);
+        REQUIRE(&reader.source() == source_ptr);
+
+        auto same{swl::make_resampling_reader(std::make_unique<synthetic_reader>(1, 1000.0f, 0.5f, 48000), 48000)};
+        REQUIRE(dynamic_cast<synthetic_reader*>(same.get()) != nullptr);
+
+        auto other{swl::make_resampling_reader(std::make_unique<synthetic_reader>(1, 1000.0f, 0.5f, 22050), 48000)};
+        REQUIRE(dynamic_cast<swl::resampling_reader*>(other.get()) != nullptr);
+    }
+
+    for(const auto quality : {swl::resampling_quality::linear, swl::resampling_quality::sinc})
+    {
+        const bool linear{quality == swl::resampling_quality::linear};
+        const std::string name{linear ? "linear" : "sinc"};
+        const float tolerance{linear ? 1.0e-2f : 1.0e-3f};
+
+        for(const auto& [from, to] : {std::pair{44100u, 48000u}, std::pair{48000u, 44100u}, std::pair{22050u, 48000u}, std::pair{48000u, 32000u}})
+        {
+            SECTION("Sine wave " + std::to_string(from) + " -> " + std::to_string(to) + ", " + name)
+            {
+                swl::resampling_reader reader{std::make_unique<synthetic_reader>(2, 1000.0f, 0.5f, from), to, quality};
+
+                REQUIRE(max_sine_error(read_all(reader, frame_count), 2, 1000.0, 0.5, to, 64) < tolerance);
+                REQUIRE(reader.tell() == frame_count);
+            }
+        }
+
+        SECTION("Block size independence, " + name)
+        {
+            swl::resampling_reader reference{std::make_unique<synthetic_reader>(2, 440.0f, 0.5f, 44100), 48000, quality};
+            const auto expected{read_all(reference, frame_count)};
+
+            swl::resampling_reader reader{std::make_unique<synthetic_reader>(2, 440.0f, 0.5f, 44100), 48000, quality};
+
+            std::vector<float> output{};
+            output.resize(frame_count * 2);
+
+            std::mt19937 generator{42};
+            std::uniform_int_distribution<std::size_t> distribution{1, 700};
+
+            std::size_t position{};
+            while(position < frame_count)
+            {
+                const auto count{std::min(distribution(generator), frame_count - position)};
+
+                reader.read(std::data(output) + position * 2, count);
+                position += count;
+            }
+
+            REQUIRE(count_mismatches(expected, output, 0.0f) == 0);
+        }
+
+        SECTION("Seek, " + name)
+        {
+            swl::resampling_reader reference{std::make_unique<synthetic_reader>(1, 440.0f, 0.5f, 44100), 48000, quality};
+            const auto expected{read_all(reference, frame_count)};
+
+            swl::resampling_reader reader{std::make_unique<synthetic_reader>(1, 440.0f, 0.5f, 44100), 48000, quality};
+            read_all(reader, 100);
+
+            constexpr std::size_t offset{4321};
+            reader.seek(offset);
+            REQUIRE(reader.tell() == offset);
+
+            const auto output{read_all(reader, frame_count - offset)};
+
+            REQUIRE(count_mismatches(std::vector<float>{std::begin(expected) + offset, std::end(expected)}, output, 1.0e-6f) == 0);
+        }
+    }
+}
+
+TEST_CASE("Resampling reader benchmark", "[resampler_bench]")
+{
+    constexpr std::size_t frame_count{4800};
+
+    std::vector<float> output{};
+    output.resize(frame_count * 2);
+
+    for(const auto quality : {swl::resampling_quality::linear, swl::resampling_quality::sinc})
+    {
+        const std::string name{quality == swl::resampling_quality::linear ? "linear" : "sinc"};
+
+        swl::resampling_reader reader{std::make_unique<synthetic_reader>(2, 440.0f, 0.5f, 44100), 48000, quality};
+
+        BENCHMARK("Stereo 44100 -> 48000, 4800 frames, " + name)
+        {
+            reader.read(std::data(output), frame_count);
+            return output[0];
+        };
+    }
+}
+
+static void write_uint(std::vector<std::uint8_t>& output, std::uint32_t value, std::size_t size)
+{
+    for(std::size_t i{}; i < size; ++i)
+    {
+        output.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+    }
+}
+
+//16 bits PCM RIFF file, with a different tone for each seed
+static std::vector<std::uint8_t> make_wave_file(std::uint32_t channel_count, std::uint32_t frame_count, std::uint32_t seed, std::uint32_t frequency = 48000)
+{
+    const std::uint32_t data_size{frame_count * channel_count * 2};
+
+    std::vector<std::uint8_t> output{'R', 'I', 'F', 'F'};
+    write_uint(output, 36 + data_size, 4);
+    output.insert(std::end(output), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    write_uint(output, 16, 4);
+    write_uint(output, 1, 2);
+    write_uint(output, channel_count, 2);
+    write_uint(output, frequency, 4);
+    write_uint(output, frequency * channel_count * 2, 4);
+    write_uint(output, channel_count * 2, 2);
+    write_uint(output, 16, 2);
+    output.insert(std::end(output), {'d', 'a', 't', 'a'});
+    write_uint(output, data_size, 4);
+
+    for(std::uint32_t i{}; i < frame_count * channel_count; ++i)
+    {
+        const auto value{static_cast<std::int16_t>(16000.0 * std::sin(0.01 * (seed + 1) * i))};
+        write_uint(output, static_cast<std::uint16_t>(value), 2);
+    }
+
+    return output;
+}
+
+TEST_CASE("Sound cache", "[sound_cache]")
+{
+    constexpr std::uint32_t frame_count{4800};
+    constexpr std::size_t sound_size{frame_count * 2 * sizeof(float)};
+
+    const auto first {make_wave_file(2, frame_count, 0)};
+    const auto second{make_wave_file(2, frame_count, 1)};
+
+    //Memory sources keep a copy of their content
+    const std::size_t entry_size{sound_size + std::size(first)};
+
+    SECTION("Readers share the decoded data")
+    {
+        swl::sound_cache cache{};
+
+        auto reader{cache.open(first)};
+        auto other {cache.open(first)};
+
+        const auto& cached{dynamic_cast<swl::cached_sound_reader&>(*reader)};
+        REQUIRE(cached.sound() == dynamic_cast<swl::cached_sound_reader&>(*other).sound());
+        REQUIRE(cached.info().frame_count == frame_count);
+        REQUIRE(cached.info().seekable);
+
+        const auto stats{cache.stats()};
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.entry_count == 1);
+        REQUIRE(stats.resident_bytes == entry_size);
+
+        swl::wave_reader reference{first};
+
+        std::vector<float> expected{};
+        expected.resize(frame_count * 2);
+        reference.read(std::data(expected), frame_count);
+
+        std::vector<float> output{};
+        output.resize(frame_count * 2);
+
+        //Independent cursors
+        REQUIRE(other->read(std::data(output), 100));
+        REQUIRE(reader->read(std::data(output), frame_count));
+        REQUIRE(output == expected);
+        REQUIRE(other->tell() == 100);
+
+        REQUIRE_FALSE(reader->read(std::data(output), 1));
+        REQUIRE(output[0] == 0.0f);
+    }
+
+    SECTION("Least recently used sounds are evicted")
+    {
+        swl::sound_cache cache{entry_size + entry_size / 2};
+
+        const auto sound{cache.load(first)};
+        cache.load(second);
+
+        auto stats{cache.stats()};
+        REQUIRE(stats.evictions == 1);
+        REQUIRE(stats.entry_count == 1);
+        REQUIRE(stats.resident_bytes == entry_size);
+
+        //Still alive for its users
+        REQUIRE(std::size(sound->samples) == frame_count * 2);
+
+        cache.load(second);
+        cache.load(first);
+
+        stats = cache.stats();
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.misses == 3);
+
+        cache.set_budget(0);
+        REQUIRE(cache.stats().resident_bytes == 0);
+
+        cache.load(first);
+        REQUIRE(cache.stats().entry_count == 0);
+    }
+
+    SECTION("open_file uses the default cache for decoded sounds")
+    {
+        swl::default_sound_cache().clear();
+
+        auto reader{swl::open_file(first, swl::sound_reader_options::decoded)};
+        REQUIRE(dynamic_cast<swl::cached_sound_reader*>(reader.get()) != nullptr);
+
+        swl::open_file(first, swl::sound_reader_options::decoded);
+        REQUIRE(swl::default_sound_cache().stats().entry_count == 1);
+
+        auto streamed{swl::open_file(first, swl::sound_reader_options::none)};
+        REQUIRE(dynamic_cast<swl::wave_reader*>(streamed.get()) != nullptr);
+
+        //Decoded sounds are not prefetched
+        using cpt::foundation::operator|;
+        auto prefetched{swl::open_file(first, swl::sound_reader_options::decoded | swl::sound_reader_options::prefetched)};
+        REQUIRE(dynamic_cast<swl::cached_sound_reader*>(prefetched.get()) != nullptr);
+    }
+}
+
+TEST_CASE("Sound cache benchmark", "[sound_cache_bench]")
+{
+    const auto data{make_wave_file(2, 48000, 0)};
+
+    BENCHMARK("Decode 1s stereo wave")
+    {
+        return swl::wave_reader{data, swl::sound_reader_options::decoded}.info().frame_count;
+    };
+
+    swl::sound_cache cache{};
+    cache.load(data);
+
+    BENCHMARK("Open 1s stereo wave from cache")
+    {
+        return cache.open(data)->info().frame_count;
+    };
+}
+
+static std::filesystem::path write_temporary_file(const std::string& name, std::span<const std::uint8_t> data)
+{
+    const auto path{std::filesystem::temp_directory_path() / name};
+
+    std::ofstream ofs{path, std::ios_base::binary};
+    ofs.write(reinterpret_cast<const char*>(std::data(data)), static_cast<std::streamsize>(std::size(data)));
+
+    return path;
+}
+
+TEST_CASE("Memory-mapped wave reader", "[mapped_file]")
+{
+    constexpr std::uint32_t frame_count{10000};
+
+    const auto data{make_wave_file(2, frame_count, 3)};
+    const auto path{write_temporary_file("swell_mapped_test.wav", data)};
+
+    SECTION("Mapping content")
+    {
+        swl::mapped_file mapping{path};
+        REQUIRE(std::equal(std::begin(mapping.data()), std::end(mapping.data()), std::begin(data), std::end(data)));
+
+        swl::mapped_file other{std::move(mapping)};
+        REQUIRE(std::size(mapping.data()) == 0);
+        REQUIRE(std::size(other.data()) == std::size(data));
+
+        REQUIRE_THROWS(swl::mapped_file{path.parent_path() / "swell_file_that_does_not_exist.wav"});
+    }
+
+    SECTION("Same samples as the stream reader")
+    {
+        swl::wave_reader stream{path};
+        swl::wave_reader mapped{path, swl::sound_reader_options::mapped};
+
+        REQUIRE(mapped.info().frame_count == frame_count);
+
+        std::vector<float> expected{};
+        expected.resize(frame_count * 2);
+        stream.read(std::data(expected), frame_count);
+
+        std::vector<float> output{};
+        output.resize(frame_count * 2);
+        REQUIRE(mapped.read(std::data(output), frame_count));
+        REQUIRE(output == expected);
+
+        mapped.seek(1234);
+        REQUIRE(mapped.read(std::data(output), 100));
+        REQUIRE(std::equal(std::begin(output), std::begin(output) + 200, std::begin(expected) + 1234 * 2));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Wave reader throughput benchmark", "[mapped_file_bench]")
+{
+    constexpr std::uint32_t frame_count{48000 * 60};
+    constexpr std::size_t block_size{4800};
+
+    const auto path{write_temporary_file("swell_throughput_test.wav", make_wave_file(2, frame_count, 0))};
+
+    std::vector<float> output{};
+    output.resize(block_size * 2);
+
+    const std::array modes{std::pair{swl::sound_reader_options::none, "stream"}, std::pair{swl::sound_reader_options::buffered, "buffered"}, std::pair{swl::sound_reader_options::mapped, "mapped"}};
+
+    for(const auto& [options, name] : modes)
+    {
+        BENCHMARK(std::string{"Open and read 60s stereo 16 bits wave, "} + name)
+        {
+            swl::wave_reader reader{path, options};
+
+            for(std::size_t i{}; i < frame_count; i += block_size)
+            {
+                reader.read(std::data(output), block_size);
+            }
+
+            return output[0];
+        };
+    }
+
+    std::filesystem::remove(path);
+}
+
+static void wait_for_frames(const swl::prefetching_reader& reader, std::size_t frame_count)
+{
+    const auto timeout{std::chrono::steady_clock::now() + std::chrono::seconds{5}};
+
+    while(reader.buffered_frames() < frame_count && std::chrono::steady_clock::now() < timeout)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+}
+
+TEST_CASE("Prefetching reader", "[prefetcher]")
+{
+    constexpr std::uint32_t frame_count{20000};
+    constexpr std::size_t block_size{480};
+
+    const auto data{make_wave_file(2, frame_count, 5)};
+
+    swl::wave_reader reference{data};
+
+    std::vector<float> expected{};
+    expected.resize(frame_count * 2);
+    reference.read(std::data(expected), frame_count);
+
+    swl::prefetching_reader reader{std::make_unique<swl::wave_reader>(data), 4096, 1024};
+
+    REQUIRE(reader.info().frame_count == frame_count);
+    REQUIRE(reader.capacity() == 4096);
+
+    std::vector<float> output{};
+    output.resize(block_size * 2);
+
+    const auto read_block = [&](std::size_t count)
+    {
+        wait_for_frames(reader, count);
+
+        return reader.read(std::data(output), count);
+    };
+
+    const auto expected_at = [&](std::uint64_t frame, std::size_t count)
+    {
+        return std::equal(std::begin(output), std::begin(output) + count * 2, std::begin(expected) + frame * 2);
+    };
+
+    SECTION("Sequential reads")
+    {
+        for(std::size_t frame{}; frame + block_size <= frame_count; frame += block_size)
+        {
+            REQUIRE(read_block(block_size));
+            REQUIRE(expected_at(frame, block_size));
+        }
+
+        REQUIRE(reader.underruns() == 0);
+
+        //Past the end
+        REQUIRE_FALSE(reader.read(std::data(output), block_size));
+        REQUIRE(output.back() == 0.0f);
+    }
+
+    SECTION("Seek")
+    {
+        REQUIRE(read_block(block_size));
+
+        reader.seek(12345);
+        REQUIRE(reader.tell() == 12345);
+
+        REQUIRE(read_block(block_size));
+        REQUIRE(expected_at(12345, block_size));
+        REQUIRE(reader.underruns() == 0);
+    }
+
+    SECTION("Loop points")
+    {
+        constexpr std::uint64_t loop_begin{1000};
+        constexpr std::uint64_t loop_end{3100};
+
+        reader.set_loop_points(loop_begin, loop_end);
+
+        //Same pattern as audio_world::get_sound_data
+        std::uint64_t frame{};
+        for(std::size_t i{}; i < 40; ++i)
+        {
+            const auto position{reader.tell()};
+            REQUIRE(position == frame);
+
+            if(position + block_size > loop_end)
+            {
+                const auto first{loop_end - position};
+
+                REQUIRE(read_block(first));
+                REQUIRE(expected_at(position, first));
+
+                reader.seek(loop_begin);
+                REQUIRE(reader.tell() == loop_begin);
+
+                REQUIRE(read_block(block_size - first));
+                REQUIRE(std::equal(std::begin(output), std::begin(output) + (block_size - first) * 2, std::begin(expected) + loop_begin * 2));
+
+                frame = loop_begin + block_size - first;
+            }
+            else
+            {
+                REQUIRE(read_block(block_size));
+                REQUIRE(expected_at(position, block_size));
+
+                frame += block_size;
+            }
+        }
+
+        REQUIRE(reader.underruns() == 0);
+    }
+
+    SECTION("Underruns are counted")
+    {
+        swl::prefetching_reader slow{std::make_unique<synthetic_reader>(2, 440.0f, 0.5f), 4096, 1024};
+
+        std::size_t underruns{};
+        for(std::size_t i{}; i < 1000 && underruns == 0; ++i)
+        {
+            slow.read(std::data(output), block_size);
+            underruns = slow.underruns();
+        }
+
+        REQUIRE(underruns > 0);
+        REQUIRE(slow.underrun_frames() > 0);
+    }
+
+    SECTION("Resampled loop points")
+    {
+        constexpr std::uint64_t loop_begin{1000};
+        constexpr std::uint64_t loop_end{3100};
+
+        //Wave readers do not copy memory sources
+        const auto resampled_data{make_wave_file(2, frame_count, 5, 44100)};
+
+        auto source{std::make_unique<swl::prefetching_reader>(std::make_unique<swl::wave_reader>(resampled_data), 4096, 1024)};
+        auto resampled{swl::make_resampling_reader(std::move(source), 48000)};
+
+        auto& prefetcher{dynamic_cast<swl::prefetching_reader&>(*resampled)};
+        REQUIRE(dynamic_cast<swl::resampling_reader*>(&prefetcher.source()) != nullptr);
+        REQUIRE(prefetcher.info().frequency == 48000);
+
+        //Same reference as the output, without prefetching
+        swl::resampling_reader reference_resampler{std::make_unique<swl::wave_reader>(resampled_data), 48000};
+
+        std::vector<float> resampled_expected{};
+        resampled_expected.resize(loop_end * 2);
+        reference_resampler.read(std::data(resampled_expected), loop_end);
+
+        prefetcher.set_loop_points(loop_begin, loop_end);
+
+        std::uint64_t frame{};
+        for(std::size_t i{}; i < 40; ++i)
+        {
+            const auto position{prefetcher.tell()};
+            REQUIRE(position == frame);
+
+            const auto count{position + block_size > loop_end ? loop_end - position : block_size};
+
+            wait_for_frames(prefetcher, count);
+            prefetcher.read(std::data(output), count);
+            REQUIRE(std::equal(std::begin(output), std::begin(output) + count * 2, std::begin(resampled_expected) + position * 2));
+
+            if(position + count == loop_end)
+            {
+                prefetcher.seek(loop_begin);
+                frame = loop_begin;
+            }
+            else
+            {
+                frame += count;
+            }
+        }
+
+        REQUIRE(prefetcher.underruns() == 0);
+    }
+}
+
+TEST_CASE("Offline renderer", "[offline]")
+{
+    constexpr std::size_t frame_count{480};
+    constexpr std::size_t block_count{8};
+
+    SECTION("Same output as a manually driven world")
+    {
+        const auto reference{render_synthetic(0, 37, block_count, frame_count)};
+
+        swl::audio_world world{48000};
+        swl::listener listener{2};
+        auto sounds{make_synthetic_sounds(world, 37)};
+
+        swl::memory_sink sink{};
+        swl::offline_renderer renderer{world, frame_count};
+        renderer.add_output(listener, &sink);
+
+        const auto stats{renderer.render(block_count * frame_count)};
+
+        REQUIRE(stats.frame_count == block_count * frame_count);
+        REQUIRE(stats.block_count == block_count);
+        REQUIRE(stats.nanoseconds_per_frame > 0.0);
+        REQUIRE(sink.channel_count() == 2);
+        REQUIRE(std::equal(std::begin(sink.samples()), std::end(sink.samples()), std::begin(reference), std::end(reference)));
+        REQUIRE(sink.hash() == swl::hash_samples(reference));
+    }
+
+    SECTION("Partial blocks, several listeners and discarded outputs")
+    {
+        swl::audio_world world{48000};
+        swl::listener mono{1};
+        swl::listener stereo{2};
+        swl::listener discarded{2};
+        auto sounds{make_synthetic_sounds(world, 5)};
+
+        swl::memory_sink mono_sink{};
+        swl::memory_sink stereo_sink{};
+        swl::offline_renderer renderer{world, 256};
+        renderer.add_output(mono, &mono_sink);
+        renderer.add_output(stereo, &stereo_sink);
+        renderer.add_output(discarded);
+
+        const auto stats{renderer.render(swl::seconds{0.021})};
+
+        REQUIRE(stats.frame_count == 1008);
+        REQUIRE(stats.block_count == 4);
+        REQUIRE(std::size(mono_sink.samples()) == 1008);
+        REQUIRE(std::size(stereo_sink.samples()) == 1008 * 2);
+        REQUIRE(discarded.buffered() == 0);
+        REQUIRE(mono.queue().underflows() == 0);
+    }
+
+    SECTION("Wave file")
+    {
+        const auto path{std::filesystem::temp_directory_path() / "swell_offline_test.wav"};
+
+        swl::audio_world world{44100};
+        swl::listener listener{2};
+        auto sounds{make_synthetic_sounds(world, 3)};
+
+        swl::memory_sink memory{};
+        swl::wave_sink file{path, 44100, 2};
+
+        swl::offline_renderer renderer{world, 300};
+        renderer.add_output(listener, &memory);
+        renderer.render(1000);
+
+        file.write(memory.samples(), 2);
+        REQUIRE(file.frame_count() == 1000);
+        REQUIRE_THROWS(file.write(memory.samples(), 1));
+        file.close();
+
+        std::ifstream ifs{path, std::ios_base::binary};
+        std::vector<char> data{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+
+        const auto read_u32 = [&data](std::size_t offset)
+        {
+            std::uint32_t output{};
+            for(std::size_t i{}; i < 4; ++i)
+            {
+                output |= static_cast<std::uint32_t>(static_cast<std::uint8_t>(data[offset + i])) << (i * 8);
+            }
+
+            return output;
+        };
+
+        REQUIRE(std::size(data) == 44 + 1000 * 2 * sizeof(float));
+        REQUIRE(std::string{std::data(data), 4} == "RIFF");
+        REQUIRE(read_u32(4) == std::size(data) - 8);
+        REQUIRE(read_u32(20) == (2u << 16 | 3u)); //IEEE float, 2 channels
+        REQUIRE(read_u32(24) == 44100);
+        REQUIRE(read_u32(40) == 1000 * 2 * sizeof(float));
+
+        std::vector<float> samples{};
+        samples.resize(1000 * 2);
+        std::memcpy(std::data(samples), std::data(data) + 44, 1000 * 2 * sizeof(float));
+
+        REQUIRE(swl::hash_samples(samples) == memory.hash());
+
+        //32 bits float files are also read back by wave_reader
+        swl::wave_reader reader{path};
+        REQUIRE(reader.info().frame_count == 1000);
+        REQUIRE(reader.info().channel_count == 2);
+
+        std::vector<float> read_back{};
+        read_back.resize(1000 * 2);
+        REQUIRE(reader.read(std::data(read_back), 1000));
+        REQUIRE(read_back == samples);
+    }
+}
+
+//Renders every combination of voice count, listener count, listener layout and spatialization.
+//Output hashes are compared against the file named by SWELL_OFFLINE_BASELINE if it exists, or written to it otherwise.
+TEST_CASE("Offline rendering benchmark", "[offline_bench]")
+{
+    constexpr std::size_t frame_count{48000};
+
+    std::map<std::string, std::uint64_t> baseline{};
+    const char* const baseline_path{std::getenv("SWELL_OFFLINE_BASELINE")};
+
+    if(baseline_path)
+    {
+        std::ifstream ifs{baseline_path};
+
+        std::string name{};
+        std::uint64_t hash{};
+        while(ifs >> name >> std::hex >> hash)
+        {
+            baseline.emplace(name, hash);
+        }
+    }
+
+    const bool write_baseline{baseline_path && std::empty(baseline)};
+    std::map<std::string, std::uint64_t> hashes{};
+
+    for(const std::size_t voice_count : {1u, 16u, 64u, 256u})
+    {
+        for(const std::size_t listener_count : {1u, 4u})
+        {
+            for(const std::uint32_t channel_count : {1u, 2u})
+            {
+                for(const bool spatialization : {false, true})
+                {
+                    swl::audio_world world{48000};
+                    auto sounds{make_synthetic_sounds(world, voice_count)};
+
+                    if(spatialization)
+                    {
+                        for(std::size_t i{}; i < voice_count; ++i)
+                        {
+                            sounds[i].enable_spatialization();
+                            sounds[i].move_to(swl::vec3f{static_cast<float>(i % 7) - 3.0f, 0.0f, static_cast<float>(i % 5)});
+                        }
+                    }
+
+                    std::vector<swl::listener> listeners{};
+                    std::vector<swl::memory_sink> sinks{};
+                    listeners.reserve(listener_count);
+                    sinks.resize(listener_count);
+
+                    swl::offline_renderer renderer{world, 480};
+
+                    for(std::size_t i{}; i < listener_count; ++i)
+                    {
+                        auto& listener{listeners.emplace_back(channel_count)};
+                        listener.move_to(swl::vec3f{static_cast<float>(i), 0.0f, 0.0f});
+
+                        if(!spatialization)
+                        {
+                            listener.disable_spatialization();
+                        }
+
+                        renderer.add_output(listener, &sinks[i]);
+                    }
+
+                    const auto stats{renderer.render(frame_count)};
+
+                    std::uint64_t hash{};
+                    for(const auto& sink : sinks)
+                    {
+                        hash = hash * 31 + sink.hash();
+                    }
+
+                    const auto name{std::to_string(voice_count) + "v_" + std::to_string(listener_count) + "l_" + std::to_string(channel_count) + "ch_" + (spatialization ? "spatial" : "flat")};
+                    hashes.emplace(name, hash);
+
+                    std::cout << name << ": " << stats.nanoseconds_per_frame << " ns/frame, " << stats.realtime_factor << "x realtime, hash " << std::hex << hash << std::dec << std::endl;
+
+                    if(const auto it{baseline.find(name)}; it != std::end(baseline))
+                    {
+                        CHECK(it->second == hash);
+                    }
+                }
+            }
+        }
+    }
+
+    if(write_baseline)
+    {
+        std::ofstream ofs{baseline_path};
+
+        for(const auto& [name, hash] : hashes)
+        {
+            ofs << name << ' ' << std::hex << hash << std::dec << '\n';
+        }
+    }
+}
+
+TEST_CASE("Voice virtualization", "[virtualization]")
+{
+    constexpr std::size_t frame_count{256};
+
+    SECTION("Virtual voices come back sample-accurately")
+    {
+        const auto render = [&](float threshold)
+        {
+            swl::audio_world world{48000};
+            world.set_virtualization(swl::virtualization_info{threshold});
+
+            swl::listener listener{2};
+            swl::sound sound{world, std::make_unique<synthetic_reader>(1, 440.0f, 0.5f)};
+            sound.set_loop_points(0, 1000);
+            sound.enable_spatialization();
+            sound.move_to(swl::vec3f{1000.0f, 0.0f, 0.0f});
+            sound.start();
+
+            std::vector<float> output{};
+            output.resize(10 * frame_count * 2);
+
+            for(std::size_t i{}; i < 10; ++i)
+            {
+                if(i == 5)
+                {
+                    sound.move_to(swl::vec3f{1.0f, 0.0f, 1.0f});
+                }
+
+                world.bind_listener(listener);
+                world.generate(frame_count);
+                listener.drain_n(std::data(output) + i * frame_count * 2, frame_count);
+
+                REQUIRE(world.real_voice_count() + world.virtual_voice_count() == 1);
+            }
+
+            return std::make_pair(output, world.virtual_voice_count());
+        };
+
+        const auto [reference, reference_virtual]{render(0.0f)};
+        const auto [output, output_virtual]{render(0.01f)};
+
+        REQUIRE(reference_virtual == 0);
+        REQUIRE(output_virtual == 0);
+
+        //Silence while far away, then exactly the same samples as a voice that was never virtualized
+        REQUIRE(std::all_of(std::begin(output), std::begin(output) + 5 * frame_count * 2, [](float value){ return value == 0.0f; }));
+        REQUIRE(std::equal(std::begin(output) + 5 * frame_count * 2, std::end(output), std::begin(reference) + 5 * frame_count * 2));
+    }
+
+    SECTION("Real voice budget follows priorities")
+    {
+        const auto render = [&](bool budget)
+        {
+            swl::audio_world world{48000};
+            swl::listener listener{1};
+
+            std::vector<swl::sound> sounds{};
+            for(std::size_t i{}; i < 8; ++i)
+            {
+                auto& sound{sounds.emplace_back(world, std::make_unique<synthetic_reader>(1, 100.0f * static_cast<float>(i + 1), 0.1f))};
+                sound.set_priority(i % 3 == 0 ? 1 : 0);
+
+                //The reference plays the same voices, muted instead of virtual
+                if(!budget && i % 3 != 0)
+                {
+                    sound.set_volume(0.0f);
+                }
+
+                sound.start();
+            }
+
+            //A negative threshold never virtualizes
+            world.set_virtualization(budget ? swl::virtualization_info{0.0f, 3} : swl::virtualization_info{-1.0f});
+
+            world.bind_listener(listener);
+            world.generate(frame_count);
+
+            std::vector<float> output{};
+            output.resize(frame_count);
+            listener.drain_n(std::data(output), frame_count);
+
+            if(budget)
+            {
+                REQUIRE(world.real_voice_count() == 3);
+                REQUIRE(world.virtual_voice_count() == 5);
+
+                for(const auto& sound : sounds)
+                {
+                    REQUIRE(sound.tell() == frame_count);
+                }
+            }
+
+            return output;
+        };
+
+        const auto reference{render(false)};
+        const auto output{render(true)};
+
+        for(std::size_t i{}; i < frame_count; ++i)
+        {
+            REQUIRE(output[i] == Approx{reference[i]}.margin(1.0e-6));
+        }
+    }
+
+    SECTION("Virtual voices do not change the mix amplitude")
+    {
+        const auto render = [&](float threshold)
+        {
+            swl::audio_world world{48000};
+            world.set_virtualization(swl::virtualization_info{threshold});
+
+            swl::listener listener{1};
+
+            swl::sound audible{world, std::make_unique<synthetic_reader>(1, 440.0f, 0.8f)};
+            audible.start();
+
+            swl::sound silent{world, std::make_unique<synthetic_reader>(1, 220.0f, 0.8f)};
+            silent.set_volume(0.0f);
+            silent.start();
+
+            std::vector<float> output{};
+            output.resize(frame_count);
+
+            world.bind_listener(listener);
+            world.generate(frame_count);
+            listener.drain_n(std::data(output), frame_count);
+
+            return std::make_pair(output, world.virtual_voice_count());
+        };
+
+        const auto [reference, reference_virtual]{render(-1.0f)};
+        const auto [output, output_virtual]{render(0.0f)};
+
+        REQUIRE(reference_virtual == 0);
+        REQUIRE(output_virtual == 1);
+        REQUIRE(output == reference);
+    }
+}
+
+TEST_CASE("Voice virtualization benchmark", "[virtualization_bench]")
+{
+    constexpr std::size_t voice_count{512};
+
+    for(const float threshold : {0.0f, 0.001f})
+    {
+        swl::audio_world world{48000};
+        world.set_virtualization(swl::virtualization_info{threshold});
+
+        auto sounds{make_synthetic_sounds(world, voice_count)};
+
+        //Most voices are far away, as in a large level full of emitters
+        for(std::size_t i{}; i < voice_count; ++i)
+        {
+            sounds[i].enable_spatialization();
+            sounds[i].move_to(swl::vec3f{static_cast<float>(i % 16 == 0 ? 2 : 10000), 0.0f, 0.0f});
+        }
+
+        swl::listener listener{2};
+        swl::offline_renderer renderer{world, 480};
+        renderer.add_output(listener);
+
+        const auto stats{renderer.render(48000)};
+
+        std::cout << voice_count << " voices, threshold " << threshold << ": " << world.real_voice_count() << " real, " << stats.nanoseconds_per_frame << " ns/frame" << std::endl;
+    }
+}
+
+//Game thread updating every emitter while the audio thread generates blocks
+TEST_CASE("Sound parameters contention benchmark", "[contention_bench]")
+{
+    constexpr std::size_t voice_count{300};
+    constexpr std::size_t update_count{2000};
+
+    for(const bool contended : {false, true})
+    {
+        swl::audio_world world{48000};
+        swl::listener listener{2};
+        auto sounds{make_synthetic_sounds(world, voice_count)};
+
+        std::atomic<bool> running{true};
+        std::atomic<std::uint64_t> frames{};
+        double max_block_time{};
+
+        std::thread audio_thread{[&]()
+        {
+            swl::offline_renderer renderer{world, 256};
+            renderer.add_output(listener);
+
+            while(running.load(std::memory_order_relaxed))
+            {
+                const auto stats{renderer.render(256)};
+
+                frames.fetch_add(stats.frame_count, std::memory_order_relaxed);
+                max_block_time = std::max(max_block_time, stats.elapsed.count());
+            }
+        }};
+
+        const auto begin{std::chrono::steady_clock::now()};
+
+        if(contended)
+        {
+            for(std::size_t i{}; i < update_count; ++i)
+            {
+                for(std::size_t j{}; j < voice_count; ++j)
+                {
+                    sounds[j].move_to(swl::vec3f{static_cast<float>(i % 64), 0.0f, static_cast<float>(j % 16)});
+                    sounds[j].set_volume(0.5f + static_cast<float>(i % 2) * 0.25f);
+                }
+
+                listener.move_to(swl::vec3f{static_cast<float>(i % 8), 0.0f, 0.0f});
+            }
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{500});
+        }
+
+        const std::chrono::duration<double> time{std::chrono::steady_clock::now() - begin};
+
+        running.store(false, std::memory_order_relaxed);
+        audio_thread.join();
+
+        const auto audio_rate{time.count() * 1.0e9 / static_cast<double>(frames.load())};
+
+        if(contended)
+        {
+            std::cout << "Contended: " << time.count() * 1.0e9 / static_cast<double>(update_count * voice_count * 2) << " ns/setter, ";
+        }
+        else
+        {
+            std::cout << "Uncontended: ";
+        }
+
+        std::cout << audio_rate << " ns/frame on the audio thread, slowest block " << max_block_time * 1.0e6 << " us" << std::endl;
+    }
+}
@@ -0,0 +1,289 @@
+#include <tephra/vulkan/tlsf.hpp>
+
+#include <vector>
+#include <map>
+#include <random>
+#include <algorithm>
+#include <numeric>
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_CONSOLE_WIDTH 120
+#include <catch2/catch.hpp>
+
+//CPU-only tests of tph::vulkan::tlsf_allocator, the sub-allocator of tph::vulkan::memory_heap. No Vulkan device is needed.
+
+using tph::vulkan::tlsf_allocator;
+using tph::vulkan::memory_resource_type;
+
+namespace
+{
+
+struct live_allocation
+{
+    std::uint64_t size{};
+    std::uint32_t block{};
+    memory_resource_type type{};
+};
+
+//Checks that live allocations do not overlap, and that linear and non-linear resources never share a page
+void check_layout(const std::map<std::uint64_t, live_allocation>& allocations, std::uint64_t heap_size, std::uint64_t granularity)
+{
+    for(auto it{std::begin(allocations)}; it != std::end(allocations); ++it)
+    {
+        REQUIRE(it->first + it->second.size <= heap_size);
+
+        if(const auto next{std::next(it)}; next != std::end(allocations))
+        {
+            REQUIRE(it->first + it->second.size <= next->first);
+
+            if(it->second.type != next->second.type)
+            {
+                const auto last_page{(it->first + it->second.size - 1) / granularity};
+                const auto first_page{next->first / granularity};
+
+                REQUIRE(last_page < first_page);
+            }
+        }
+    }
+}
+
+}
+
+TEST_CASE("tlsf_allocator basic usage", "[tlsf]")
+{
+    tlsf_allocator allocator{1024};
+
+    REQUIRE(allocator.free_space() == 1024);
+    REQUIRE(allocator.free_block_count() == 1);
+    REQUIRE(allocator.largest_free_block() == 1024);
+
+    SECTION("The whole heap can be allocated, even if its size is not a power of 2")
+    {
+        tlsf_allocator odd_allocator{1000};
+
+        const auto allocation{odd_allocator.allocate(memory_resource_type::linear, 1000, 1)};
+        REQUIRE(allocation.has_value());
+        REQUIRE(allocation->offset == 0);
+        REQUIRE(odd_allocator.free_space() == 0);
+        REQUIRE(odd_allocator.free_block_count() == 0);
+        REQUIRE_FALSE(odd_allocator.allocate(memory_resource_type::linear, 1, 1).has_value());
+    }
+
+    SECTION("Alignment is respected and padding is reusable")
+    {
+        const auto first{allocator.allocate(memory_resource_type::linear, 10, 1)};
+        const auto second{allocator.allocate(memory_resource_type::linear, 16, 256)};
+
+        REQUIRE(first.has_value());
+        REQUIRE(second.has_value());
+        REQUIRE(second->offset % 256 == 0);
+        REQUIRE(allocator.allocation_count() == 2);
+        REQUIRE(allocator.free_space() == 1024 - 26);
+
+        const auto third{allocator.allocate(memory_resource_type::linear, 100, 1)};
+        REQUIRE(third.has_value());
+    }
+
+    SECTION("Freed blocks are coalesced")
+    {
+        std::vector<tlsf_allocator::allocation> allocations{};
+
+        for(std::uint32_t i{}; i < 8; ++i)
+        {
+            allocations.emplace_back(allocator.allocate(memory_resource_type::linear, 128, 1).value());
+        }
+
+        REQUIRE(allocator.free_space() == 0);
+
+        //Free one block out of two
+        for(std::size_t i{}; i < std::size(allocations); i += 2)
+        {
+            allocator.free(allocations[i].block);
+        }
+
+        REQUIRE(allocator.free_block_count() == 4);
+        REQUIRE(allocator.largest_free_block() == 128);
+        REQUIRE_FALSE(allocator.allocate(memory_resource_type::linear, 256, 1).has_value());
+
+        for(std::size_t i{1}; i < std::size(allocations); i += 2)
+        {
+            allocator.free(allocations[i].block);
+        }
+
+        REQUIRE(allocator.allocation_count() == 0);
+        REQUIRE(allocator.free_block_count() == 1);
+        REQUIRE(allocator.largest_free_block() == 1024);
+    }
+}
+
+TEST_CASE("tlsf_allocator linear/non-linear granularity", "[tlsf]")
+{
+    tlsf_allocator allocator{4096, 1024};
+
+    const auto buffer{allocator.allocate(memory_resource_type::linear, 100, 16)};
+    const auto image{allocator.allocate(memory_resource_type::non_linear, 100, 16)};
+    const auto other_buffer{allocator.allocate(memory_resource_type::linear, 100, 16)};
+
+    REQUIRE(buffer.has_value());
+    REQUIRE(image.has_value());
+    REQUIRE(other_buffer.has_value());
+
+    std::map<std::uint64_t, live_allocation> allocations{};
+    allocations.emplace(buffer->offset, live_allocation{buffer->size, buffer->block, memory_resource_type::linear});
+    allocations.emplace(image->offset, live_allocation{image->size, image->block, memory_resource_type::non_linear});
+    allocations.emplace(other_buffer->offset, live_allocation{other_buffer->size, other_buffer->block, memory_resource_type::linear});
+
+    check_layout(allocations, allocator.size(), allocator.granularity());
+
+    //The space left on the first page can still be used by linear resources
+    const auto small_buffer{allocator.allocate(memory_resource_type::linear, 512, 16)};
+    REQUIRE(small_buffer.has_value());
+    allocations.emplace(small_buffer->offset, live_allocation{small_buffer->size, small_buffer->block, memory_resource_type::linear});
+
+    check_layout(allocations, allocator.size(), allocator.granularity());
+}
+
+TEST_CASE("tlsf_allocator fuzzing", "[tlsf]")
+{
+    constexpr std::uint64_t heap_size{64 * 1024 * 1024};
+    constexpr std::size_t iteration_count{200000};
+
+    for(const std::uint64_t granularity : {std::uint64_t{1}, std::uint64_t{1024}, std::uint64_t{65536}})
+    {
+        tlsf_allocator allocator{heap_size, granularity};
+        std::map<std::uint64_t, live_allocation> allocations{};
+        std::uint64_t used{};
+
+        std::mt19937_64 rng{granularity};
+        std::uniform_int_distribution<std::uint64_t> size_dist{1, 256 * 1024};
+        std::uniform_int_distribution<std::uint32_t> alignment_dist{0, 12};
+        std::bernoulli_distribution type_dist{};
+        std::bernoulli_distribution free_dist{0.45};
+
+        for(std::size_t i{}; i < iteration_count; ++i)
+        {
+            if(!std::empty(allocations) && free_dist(rng))
+            {
+                auto it{allocations.lower_bound(std::uniform_int_distribution<std::uint64_t>{0, heap_size - 1}(rng))};
+
+                if(it == std::end(allocations))
+                {
+                    it = std::begin(allocations);
+                }
+
+                allocator.free(it->second.block);
+                used -= it->second.size;
+                allocations.erase(it);
+            }
+            else
+            {
+                const auto type{type_dist(rng) ? memory_resource_type::linear : memory_resource_type::non_linear};
+                const auto size{size_dist(rng)};
+                const auto alignment{std::uint64_t{1} << alignment_dist(rng)};
+
+                if(const auto allocation{allocator.allocate(type, size, alignment)}; allocation)
+                {
+                    REQUIRE(allocation->offset % alignment == 0);
+                    REQUIRE(allocation->size == size);
+                    REQUIRE(allocations.emplace(allocation->offset, live_allocation{size, allocation->block, type}).second);
+
+                    used += size;
+                }
+            }
+
+            REQUIRE(allocator.free_space() == heap_size - used);
+            REQUIRE(allocator.allocation_count() == std::size(allocations));
+
+            if(i % 1000 == 0)
+            {
+                check_layout(allocations, heap_size, granularity);
+                REQUIRE(allocator.largest_free_block() <= allocator.free_space());
+            }
+        }
+
+        check_layout(allocations, heap_size, granularity);
+
+        for(const auto& [offset, allocation] : allocations)
+        {
+            allocator.free(allocation.block);
+        }
+
+        REQUIRE(allocator.free_space() == heap_size);
+        REQUIRE(allocator.free_block_count() == 1);
+        REQUIRE(allocator.largest_free_block() == heap_size);
+    }
+}
+
+TEST_CASE("tlsf_allocator benchmark", "[tlsf_bench]")
+{
+    constexpr std::uint64_t heap_size{256 * 1024 * 1024};
+
+    //Sizes and free order are generated beforehand, so only the allocator is measured
+    std::mt19937_64 rng{42};
+    std::uniform_int_distribution<std::uint64_t> size_dist{256, 64 * 1024};
+
+    std::vector<std::uint64_t> sizes(4096);
+    std::generate(std::begin(sizes), std::end(sizes), [&]{ return size_dist(rng); });
+
+    std::vector<std::size_t> order(std::size(sizes));
+    std::iota(std::begin(order), std::end(order), 0);
+    std::shuffle(std::begin(order), std::end(order), rng);
+
+    BENCHMARK_ADVANCED("4096 allocations then random frees")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<tlsf_allocator> allocators{};
+        std::vector<std::vector<tlsf_allocator::allocation>> allocations(static_cast<std::size_t>(meter.runs()));
+
+        for(int i{}; i < meter.runs(); ++i)
+        {
+            allocators.emplace_back(heap_size, 1024);
+            allocations[i].reserve(std::size(sizes));
+        }
+
+        meter.measure([&](int run)
+        {
+            auto& allocator{allocators[run]};
+
+            for(std::size_t i{}; i < std::size(sizes); ++i)
+            {
+                const auto type{i % 4 == 0 ? memory_resource_type::non_linear : memory_resource_type::linear};
+
+                allocations[run].emplace_back(allocator.allocate(type, sizes[i], 256).value());
+            }
+
+            for(const auto index : order)
+            {
+                allocator.free(allocations[run][index].block);
+            }
+
+            return allocator.free_block_count();
+        });
+    };
+
+    BENCHMARK_ADVANCED("Steady state churn, 4096 live allocations")(Catch::Benchmark::Chronometer meter)
+    {
+        tlsf_allocator allocator{heap_size, 1024};
+        std::vector<tlsf_allocator::allocation> allocations{};
+
+        for(std::size_t i{}; i < std::size(sizes); ++i)
+        {
+            allocations.emplace_back(allocator.allocate(memory_resource_type::linear, sizes[i], 256).value());
+        }
+
+        std::size_t next{};
+
+        meter.measure([&]
+        {
+            //Replace one allocation by one of another size, the heap stays fragmented
+            const auto index{order[next % std::size(order)]};
+            const auto size{sizes[(next * 7) % std::size(sizes)]};
+            ++next;
+
+            allocator.free(allocations[index].block);
+            allocations[index] = allocator.allocate(memory_resource_type::linear, size, 256).value();
+
+            return allocations[index].offset;
+        });
+    };
+}
@@ -195,6 +195,8 @@ static VkPhysicalDeviceFeatures parse_enabled_features(const physical_device_fea
     output.alphaToOne                              = static_cast<VkBool32>(features.alpha_to_one);
     output.multiViewport                           = static_cast<VkBool32>(features.multi_viewport);
     output.samplerAnisotropy                       = static_cast<VkBool32>(features.sampler_anisotropy);
+    output.textureCompressionETC2                  = static_cast<VkBool32>(features.texture_compression_etc2);
+    output.textureCompressionBC                    = static_cast<VkBool32>(features.texture_compression_bc);
     output.occlusionQueryPrecise                   = static_cast<VkBool32>(features.occlusion_query_precise);
     output.pipelineStatisticsQuery                 = static_cast<VkBool32>(features.pipeline_statistics_query);
     output.vertexPipelineStoresAndAtomics          = static_cast<VkBool32>(features.vertex_pipeline_stores_and_atomics);
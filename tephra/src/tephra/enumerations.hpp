@@ -470,6 +470,32 @@ enum class texture_format : std::uint32_t
     d16_unorm_s8_uint = VK_FORMAT_D16_UNORM_S8_UINT,
     d24_unorm_s8_uint = VK_FORMAT_D24_UNORM_S8_UINT,
     d32_sfloat_s8_uint = VK_FORMAT_D32_SFLOAT_S8_UINT,
+    bc1_rgb_unorm_block = VK_FORMAT_BC1_RGB_UNORM_BLOCK,
+    bc1_rgb_srgb_block = VK_FORMAT_BC1_RGB_SRGB_BLOCK,
+    bc1_rgba_unorm_block = VK_FORMAT_BC1_RGBA_UNORM_BLOCK,
+    bc1_rgba_srgb_block = VK_FORMAT_BC1_RGBA_SRGB_BLOCK,
+    bc2_unorm_block = VK_FORMAT_BC2_UNORM_BLOCK,
+    bc2_srgb_block = VK_FORMAT_BC2_SRGB_BLOCK,
+    bc3_unorm_block = VK_FORMAT_BC3_UNORM_BLOCK,
+    bc3_srgb_block = VK_FORMAT_BC3_SRGB_BLOCK,
+    bc4_unorm_block = VK_FORMAT_BC4_UNORM_BLOCK,
+    bc4_snorm_block = VK_FORMAT_BC4_SNORM_BLOCK,
+    bc5_unorm_block = VK_FORMAT_BC5_UNORM_BLOCK,
+    bc5_snorm_block = VK_FORMAT_BC5_SNORM_BLOCK,
+    bc6h_ufloat_block = VK_FORMAT_BC6H_UFLOAT_BLOCK,
+    bc6h_sfloat_block = VK_FORMAT_BC6H_SFLOAT_BLOCK,
+    bc7_unorm_block = VK_FORMAT_BC7_UNORM_BLOCK,
+    bc7_srgb_block = VK_FORMAT_BC7_SRGB_BLOCK,
+    etc2_r8g8b8_unorm_block = VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK,
+    etc2_r8g8b8_srgb_block = VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK,
+    etc2_r8g8b8a1_unorm_block = VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK,
+    etc2_r8g8b8a1_srgb_block = VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK,
+    etc2_r8g8b8a8_unorm_block = VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK,
+    etc2_r8g8b8a8_srgb_block = VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK,
+    eac_r11_unorm_block = VK_FORMAT_EAC_R11_UNORM_BLOCK,
+    eac_r11_snorm_block = VK_FORMAT_EAC_R11_SNORM_BLOCK,
+    eac_r11g11_unorm_block = VK_FORMAT_EAC_R11G11_UNORM_BLOCK,
+    eac_r11g11_snorm_block = VK_FORMAT_EAC_R11G11_SNORM_BLOCK,
 };
 
 enum class texture_aspect : std::uint32_t
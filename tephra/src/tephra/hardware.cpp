@@ -48,6 +48,9 @@ static physical_device_properties make_properties(const VkPhysicalDeviceProperti
     output.api_version.patch = VK_VERSION_PATCH(properties.apiVersion);
     output.type = static_cast<physical_device_type>(properties.deviceType);
     std::copy(std::cbegin(properties.pipelineCacheUUID), std::cend(properties.pipelineCacheUUID), std::begin(output.uuid));
+    output.vendor_id = properties.vendorID;
+    output.device_id = properties.deviceID;
+    output.driver_version = properties.driverVersion;
 
     return output;
 }
@@ -76,6 +79,8 @@ static physical_device_features make_features(const VkPhysicalDeviceFeatures& fe
     output.alpha_to_one                                 = static_cast<bool>(features.alphaToOne);
     output.multi_viewport                               = static_cast<bool>(features.multiViewport);
     output.sampler_anisotropy                           = static_cast<bool>(features.samplerAnisotropy);
+    output.texture_compression_etc2                     = static_cast<bool>(features.textureCompressionETC2);
+    output.texture_compression_bc                       = static_cast<bool>(features.textureCompressionBC);
     output.occlusion_query_precise                      = static_cast<bool>(features.occlusionQueryPrecise);
     output.pipeline_statistics_query                    = static_cast<bool>(features.pipelineStatisticsQuery);
     output.vertex_pipeline_stores_and_atomics           = static_cast<bool>(features.vertexPipelineStoresAndAtomics);
@@ -54,6 +54,9 @@ struct physical_device_properties
     tph::version api_version{};
     std::string name{};
     std::array<std::uint8_t, 16> uuid{};
+    std::uint32_t vendor_id{};
+    std::uint32_t device_id{};
+    std::uint32_t driver_version{};
 };
 
 struct physical_device_features
@@ -78,6 +81,8 @@ struct physical_device_features
     bool alpha_to_one{};
     bool multi_viewport{};
     bool sampler_anisotropy{};
+    bool texture_compression_etc2{};
+    bool texture_compression_bc{};
     bool occlusion_query_precise{};
     bool pipeline_statistics_query{};
     bool vertex_pipeline_stores_and_atomics{};
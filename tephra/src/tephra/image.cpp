@@ -26,6 +26,7 @@
 #include <memory>
 #include <fstream>
 #include <cstring>
+#include <algorithm>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
@@ -38,6 +39,17 @@
 #include "vulkan/vulkan_functions.hpp"
 
 #include "device.hpp"
+#include "texture.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define TEPHRA_MIPMAPS_SSE2
+
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #define TEPHRA_MIPMAPS_NEON
+
+    #include <arm_neon.h>
+#endif
 
 using namespace tph::vulkan::functions;
 
@@ -283,6 +295,174 @@ buffer image::to_buffer() noexcept
     return buffer{std::move(m_buffer), std::move(m_memory), m_width * m_height * 4};
 }
 
+image_data decode_image(const std::filesystem::path& file)
+{
+    return decode_image(read_file<std::vector<std::uint8_t>>(file));
+}
+
+image_data decode_image(std::span<const std::uint8_t> data)
+{
+    int width{};
+    int height{};
+    int channels{};
+
+    stbi_ptr pixels{stbi_load_from_memory(std::data(data), static_cast<int>(std::size(data)), &width, &height, &channels, STBI_rgb_alpha)};
+    if(!pixels)
+        throw std::runtime_error{"Can not load image. " + std::string{stbi_failure_reason()}};
+
+    const auto size{static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 4};
+
+    image_data output{};
+    output.width = static_cast<std::uint32_t>(width);
+    output.height = static_cast<std::uint32_t>(height);
+    output.pixels.assign(pixels.get(), pixels.get() + size);
+
+    return output;
+}
+
+image_data decode_image(std::istream& stream)
+{
+    assert(stream && "Invalid stream.");
+
+    const std::string data{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+
+    return decode_image(std::span{reinterpret_cast<const std::uint8_t*>(std::data(data)), std::size(data)});
+}
+
+//Downsampling kernels, they write count pixels of a mip level from two rows of the previous one.
+//The vectorized ones need the full 2x2 footprint (2 * count pixels in each row) and return the number of pixels they wrote.
+
+static void downsample_row(const std::uint8_t* top, const std::uint8_t* bottom, std::uint8_t* output, std::uint32_t begin, std::uint32_t count, std::uint32_t width) noexcept
+{
+    for(std::uint32_t x{begin}; x < count; ++x)
+    {
+        const std::uint32_t left {x * 2 * 4};
+        const std::uint32_t right{std::min(x * 2 + 1, width - 1) * 4};
+
+        for(std::uint32_t channel{}; channel < 4; ++channel)
+        {
+            const auto sum{static_cast<std::uint32_t>(top[left + channel] + top[right + channel] + bottom[left + channel] + bottom[right + channel])};
+
+            output[x * 4 + channel] = static_cast<std::uint8_t>((sum + 2) / 4);
+        }
+    }
+}
+
+#if defined(TEPHRA_MIPMAPS_SSE2)
+
+static std::uint32_t downsample_row_vectorized(const std::uint8_t* top, const std::uint8_t* bottom, std::uint8_t* output, std::uint32_t count) noexcept
+{
+    const __m128i zero{_mm_setzero_si128()};
+    const __m128i half{_mm_set1_epi16(2)};
+
+    //Sums the 2x2 footprints of 2 output pixels, from 4 pixels of each row, in 16 bits channels
+    const auto sum_pairs = [zero](__m128i top, __m128i bottom)
+    {
+        const __m128i low  {_mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero))};
+        const __m128i high {_mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero))};
+        const __m128i first{_mm_add_epi16(low, _mm_srli_si128(low, 8))};
+        const __m128i last {_mm_add_epi16(high, _mm_srli_si128(high, 8))};
+
+        return _mm_unpacklo_epi64(first, last);
+    };
+
+    std::uint32_t x{};
+    for(; x + 4 <= count; x += 4)
+    {
+        const auto load = [](const std::uint8_t* data)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        };
+
+        const __m128i first{sum_pairs(load(top + x * 8), load(bottom + x * 8))};
+        const __m128i last {sum_pairs(load(top + x * 8 + 16), load(bottom + x * 8 + 16))};
+
+        const __m128i first_average{_mm_srli_epi16(_mm_add_epi16(first, half), 2)};
+        const __m128i last_average {_mm_srli_epi16(_mm_add_epi16(last, half), 2)};
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x * 4), _mm_packus_epi16(first_average, last_average));
+    }
+
+    return x;
+}
+
+#elif defined(TEPHRA_MIPMAPS_NEON)
+
+static std::uint32_t downsample_row_vectorized(const std::uint8_t* top, const std::uint8_t* bottom, std::uint8_t* output, std::uint32_t count) noexcept
+{
+    std::uint32_t x{};
+    for(; x + 8 <= count; x += 8)
+    {
+        //Deinterleaved, so the two pixels of a footprint are adjacent lanes of each channel
+        const uint8x16x4_t top_pixels   {vld4q_u8(top + x * 8)};
+        const uint8x16x4_t bottom_pixels{vld4q_u8(bottom + x * 8)};
+
+        uint8x8x4_t result{};
+        for(std::size_t channel{}; channel < 4; ++channel)
+        {
+            const uint16x8_t sum{vpadalq_u8(vpaddlq_u8(top_pixels.val[channel]), bottom_pixels.val[channel])};
+
+            result.val[channel] = vrshrn_n_u16(sum, 2);
+        }
+
+        vst4_u8(output + x * 4, result);
+    }
+
+    return x;
+}
+
+#else
+
+static std::uint32_t downsample_row_vectorized(const std::uint8_t*, const std::uint8_t*, std::uint8_t*, std::uint32_t) noexcept
+{
+    return 0;
+}
+
+#endif
+
+static image_data downsample(std::uint32_t width, std::uint32_t height, const std::uint8_t* pixels)
+{
+    image_data output{};
+    output.width = std::max(width / 2, 1u);
+    output.height = std::max(height / 2, 1u);
+    output.pixels.resize(static_cast<std::size_t>(output.width) * output.height * 4);
+
+    for(std::uint32_t y{}; y < output.height; ++y)
+    {
+        const std::uint8_t* top   {pixels + static_cast<std::size_t>(y * 2) * width * 4};
+        const std::uint8_t* bottom{pixels + static_cast<std::size_t>(std::min(y * 2 + 1, height - 1)) * width * 4};
+        std::uint8_t* row{std::data(output.pixels) + static_cast<std::size_t>(y) * output.width * 4};
+
+        //A single column is averaged with itself, it does not have a full footprint
+        const std::uint32_t begin{width > 1 ? downsample_row_vectorized(top, bottom, row, output.width) : 0};
+
+        downsample_row(top, bottom, row, begin, output.width, width);
+    }
+
+    return output;
+}
+
+std::vector<image_data> generate_mipmaps(std::uint32_t width, std::uint32_t height, std::span<const std::uint8_t> rgba)
+{
+    assert(std::size(rgba) >= static_cast<std::size_t>(width) * height * 4 && "tph::generate_mipmaps called with too few pixels.");
+
+    std::vector<image_data> output{};
+    output.reserve(mip_level_count(width, height) - 1);
+
+    const std::uint8_t* pixels{std::data(rgba)};
+
+    while(width > 1 || height > 1)
+    {
+        auto& level{output.emplace_back(downsample(width, height, pixels))};
+
+        width = level.width;
+        height = level.height;
+        pixels = std::data(level.pixels);
+    }
+
+    return output;
+}
+
 void set_object_name(device& dev, const image& object, const std::string& name)
 {
     VkDebugUtilsObjectNameInfoEXT info{};
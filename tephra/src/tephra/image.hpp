@@ -53,6 +53,28 @@ enum class image_format
     jpg = 3,
 };
 
+//Pixels of an image file decoded in host memory only, always 8 bits RGBA.
+//Unlike tph::image, decoding does not need a device, so it can be done on any thread.
+struct image_data
+{
+    std::uint32_t width{};
+    std::uint32_t height{};
+    std::vector<std::uint8_t> pixels{};
+};
+
+TEPHRA_API image_data decode_image(const std::filesystem::path& file);
+TEPHRA_API image_data decode_image(std::span<const std::uint8_t> data);
+TEPHRA_API image_data decode_image(std::istream& stream);
+
+//Returns the levels that follow a RGBA image in its mip chain, each one half the size of the previous one (rounded down) until 1x1.
+//Texels are averaged with a 2x2 box filter, on their encoded values.
+TEPHRA_API std::vector<image_data> generate_mipmaps(std::uint32_t width, std::uint32_t height, std::span<const std::uint8_t> rgba);
+
+inline std::vector<image_data> generate_mipmaps(const image_data& image)
+{
+    return generate_mipmaps(image.width, image.height, image.pixels);
+}
+
 class TEPHRA_API image
 {
     template<typename VulkanObject, typename... Args>
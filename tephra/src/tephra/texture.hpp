@@ -26,6 +26,8 @@
 #include "config.hpp"
 
 #include <optional>
+#include <algorithm>
+#include <bit>
 
 #include "vulkan/vulkan.hpp"
 #include "vulkan/memory.hpp"
@@ -61,6 +63,12 @@ struct texture_info
     tph::sample_count sample_count{tph::sample_count::msaa_x1};
 };
 
+//Number of levels of a complete mip chain, down to 1x1
+inline std::uint32_t mip_level_count(std::uint32_t width, std::uint32_t height) noexcept
+{
+    return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+}
+
 inline texture_aspect aspect_from_format(texture_format format) noexcept
 {
     switch(format)
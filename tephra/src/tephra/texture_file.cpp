@@ -0,0 +1,385 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "texture_file.hpp"
+#include "texture.hpp"
+
+#include <cassert>
+#include <array>
+#include <optional>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include <captal_foundation/utility.hpp>
+
+namespace tph
+{
+
+static constexpr std::array<std::uint8_t, 12> ktx2_identifier{0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+static constexpr std::size_t ktx2_header_size{80};
+static constexpr std::size_t ktx2_level_size{24};
+
+static constexpr std::size_t dds_header_size{128}; //Including the magic number
+static constexpr std::size_t dds_dx10_header_size{20};
+static constexpr std::uint32_t dds_mipmap_count_flag{0x20000};
+static constexpr std::uint32_t dds_fourcc_flag{0x04};
+static constexpr std::uint32_t dds_rgb_flag{0x40};
+static constexpr std::uint32_t dds_cubemap_flag{0x200};
+static constexpr std::uint32_t dds_volume_flag{0x200000};
+static constexpr std::uint32_t dds_texture2d_dimension{3};
+static constexpr std::uint32_t dds_texturecube_flag{0x04};
+
+static constexpr std::uint32_t fourcc(const char (&code)[5]) noexcept
+{
+    return static_cast<std::uint32_t>(code[0]) | static_cast<std::uint32_t>(code[1]) << 8 | static_cast<std::uint32_t>(code[2]) << 16 | static_cast<std::uint32_t>(code[3]) << 24;
+}
+
+static constexpr std::uint32_t dds_magic{fourcc("DDS ")};
+
+[[noreturn]] static void throw_error(const std::string& reason)
+{
+    throw std::runtime_error{"Can not load texture file. " + reason};
+}
+
+//Files are little endian
+template<typename T>
+static T read(std::span<const std::uint8_t> data, std::size_t offset) noexcept
+{
+    assert(offset + sizeof(T) <= std::size(data) && "tph::read out of bounds.");
+
+    T output{};
+    for(std::size_t i{}; i < sizeof(T); ++i)
+    {
+        output |= static_cast<T>(static_cast<T>(data[offset + i]) << (i * 8));
+    }
+
+    return output;
+}
+
+struct texel_block
+{
+    std::uint32_t width{};
+    std::uint32_t height{};
+    std::uint32_t size{};
+};
+
+static std::optional<texel_block> format_block(texture_format format) noexcept
+{
+    switch(format)
+    {
+        case texture_format::bc1_rgb_unorm_block:       [[fallthrough]];
+        case texture_format::bc1_rgb_srgb_block:        [[fallthrough]];
+        case texture_format::bc1_rgba_unorm_block:      [[fallthrough]];
+        case texture_format::bc1_rgba_srgb_block:       [[fallthrough]];
+        case texture_format::bc4_unorm_block:           [[fallthrough]];
+        case texture_format::bc4_snorm_block:           [[fallthrough]];
+        case texture_format::etc2_r8g8b8_unorm_block:   [[fallthrough]];
+        case texture_format::etc2_r8g8b8_srgb_block:    [[fallthrough]];
+        case texture_format::etc2_r8g8b8a1_unorm_block: [[fallthrough]];
+        case texture_format::etc2_r8g8b8a1_srgb_block:  [[fallthrough]];
+        case texture_format::eac_r11_unorm_block:       [[fallthrough]];
+        case texture_format::eac_r11_snorm_block:       return texel_block{4, 4, 8};
+
+        case texture_format::bc2_unorm_block:           [[fallthrough]];
+        case texture_format::bc2_srgb_block:            [[fallthrough]];
+        case texture_format::bc3_unorm_block:           [[fallthrough]];
+        case texture_format::bc3_srgb_block:            [[fallthrough]];
+        case texture_format::bc5_unorm_block:           [[fallthrough]];
+        case texture_format::bc5_snorm_block:           [[fallthrough]];
+        case texture_format::bc6h_ufloat_block:         [[fallthrough]];
+        case texture_format::bc6h_sfloat_block:         [[fallthrough]];
+        case texture_format::bc7_unorm_block:           [[fallthrough]];
+        case texture_format::bc7_srgb_block:            [[fallthrough]];
+        case texture_format::etc2_r8g8b8a8_unorm_block: [[fallthrough]];
+        case texture_format::etc2_r8g8b8a8_srgb_block:  [[fallthrough]];
+        case texture_format::eac_r11g11_unorm_block:    [[fallthrough]];
+        case texture_format::eac_r11g11_snorm_block:    return texel_block{4, 4, 16};
+
+        case texture_format::r8g8b8a8_unorm:            [[fallthrough]];
+        case texture_format::r8g8b8a8_srgb:             [[fallthrough]];
+        case texture_format::b8g8r8a8_unorm:            [[fallthrough]];
+        case texture_format::b8g8r8a8_srgb:             return texel_block{1, 1, 4};
+
+        default: return std::nullopt;
+    }
+}
+
+static std::uint64_t level_size(const texel_block& block, std::uint32_t width, std::uint32_t height) noexcept
+{
+    const std::uint64_t columns{(width + block.width - 1) / block.width};
+    const std::uint64_t rows   {(height + block.height - 1) / block.height};
+
+    return columns * rows * block.size;
+}
+
+static texture_file_data parse_ktx2(std::vector<std::uint8_t> data)
+{
+    if(std::size(data) < ktx2_header_size)
+    {
+        throw_error("KTX2 header is truncated.");
+    }
+
+    const auto format           {read<std::uint32_t>(data, 12)};
+    const auto width            {read<std::uint32_t>(data, 20)};
+    const auto height           {read<std::uint32_t>(data, 24)};
+    const auto depth            {read<std::uint32_t>(data, 28)};
+    const auto layer_count      {read<std::uint32_t>(data, 32)};
+    const auto face_count       {read<std::uint32_t>(data, 36)};
+    const auto level_count      {std::max(read<std::uint32_t>(data, 40), 1u)}; //0 means that the mip chain should be generated, only the base level is loaded
+    const auto supercompression {read<std::uint32_t>(data, 44)};
+
+    if(width == 0 || height == 0 || depth > 1 || layer_count > 1 || face_count != 1)
+    {
+        throw_error("Only 2D textures are supported.");
+    }
+
+    if(supercompression != 0)
+    {
+        throw_error("Supercompressed KTX2 files are not supported.");
+    }
+
+    texture_file_data output{};
+    output.format = static_cast<texture_format>(format);
+    output.width = width;
+    output.height = height;
+
+    const auto block{format_block(output.format)};
+    if(!block)
+    {
+        throw_error("Unsupported format (VkFormat " + std::to_string(format) + ").");
+    }
+
+    if(level_count > mip_level_count(width, height))
+    {
+        throw_error("KTX2 level count is greater than the mip chain of the texture.");
+    }
+
+    if(std::size(data) < ktx2_header_size + level_count * ktx2_level_size)
+    {
+        throw_error("KTX2 level index is truncated.");
+    }
+
+    output.levels.reserve(level_count);
+
+    for(std::uint32_t i{}; i < level_count; ++i)
+    {
+        texture_file_level level{};
+        level.width  = std::max(width >> i, 1u);
+        level.height = std::max(height >> i, 1u);
+        level.offset = read<std::uint64_t>(data, ktx2_header_size + i * ktx2_level_size);
+        level.size   = read<std::uint64_t>(data, ktx2_header_size + i * ktx2_level_size + 8);
+
+        if(level.size != level_size(*block, level.width, level.height) || level.offset > std::size(data) || level.size > std::size(data) - level.offset)
+        {
+            throw_error("KTX2 level #" + std::to_string(i) + " is invalid.");
+        }
+
+        output.levels.emplace_back(level);
+    }
+
+    output.data = std::move(data);
+
+    return output;
+}
+
+static texture_format dxgi_format(std::uint32_t format)
+{
+    switch(format)
+    {
+        case 28: return texture_format::r8g8b8a8_unorm;
+        case 29: return texture_format::r8g8b8a8_srgb;
+        case 71: return texture_format::bc1_rgba_unorm_block;
+        case 72: return texture_format::bc1_rgba_srgb_block;
+        case 74: return texture_format::bc2_unorm_block;
+        case 75: return texture_format::bc2_srgb_block;
+        case 77: return texture_format::bc3_unorm_block;
+        case 78: return texture_format::bc3_srgb_block;
+        case 80: return texture_format::bc4_unorm_block;
+        case 81: return texture_format::bc4_snorm_block;
+        case 83: return texture_format::bc5_unorm_block;
+        case 84: return texture_format::bc5_snorm_block;
+        case 87: return texture_format::b8g8r8a8_unorm;
+        case 91: return texture_format::b8g8r8a8_srgb;
+        case 95: return texture_format::bc6h_ufloat_block;
+        case 96: return texture_format::bc6h_sfloat_block;
+        case 98: return texture_format::bc7_unorm_block;
+        case 99: return texture_format::bc7_srgb_block;
+        default: throw_error("Unsupported format (DXGI_FORMAT " + std::to_string(format) + ").");
+    }
+}
+
+static texture_format fourcc_format(std::uint32_t code)
+{
+    switch(code)
+    {
+        case fourcc("DXT1"): return texture_format::bc1_rgba_unorm_block;
+        case fourcc("DXT2"): [[fallthrough]];
+        case fourcc("DXT3"): return texture_format::bc2_unorm_block;
+        case fourcc("DXT4"): [[fallthrough]];
+        case fourcc("DXT5"): return texture_format::bc3_unorm_block;
+        case fourcc("ATI1"): [[fallthrough]];
+        case fourcc("BC4U"): return texture_format::bc4_unorm_block;
+        case fourcc("BC4S"): return texture_format::bc4_snorm_block;
+        case fourcc("ATI2"): [[fallthrough]];
+        case fourcc("BC5U"): return texture_format::bc5_unorm_block;
+        case fourcc("BC5S"): return texture_format::bc5_snorm_block;
+        default: throw_error("Unsupported FourCC.");
+    }
+}
+
+static texture_file_data parse_dds(std::vector<std::uint8_t> data)
+{
+    if(std::size(data) < dds_header_size)
+    {
+        throw_error("DDS header is truncated.");
+    }
+
+    const auto flags       {read<std::uint32_t>(data, 8)};
+    const auto height      {read<std::uint32_t>(data, 12)};
+    const auto width       {read<std::uint32_t>(data, 16)};
+    const auto mipmap_count{read<std::uint32_t>(data, 28)};
+    const auto pixel_flags {read<std::uint32_t>(data, 80)};
+    const auto code        {read<std::uint32_t>(data, 84)};
+    const auto bit_count   {read<std::uint32_t>(data, 88)};
+    const auto red_mask    {read<std::uint32_t>(data, 92)};
+    const auto caps2       {read<std::uint32_t>(data, 112)};
+
+    if(width == 0 || height == 0 || (caps2 & (dds_cubemap_flag | dds_volume_flag)) != 0)
+    {
+        throw_error("Only 2D textures are supported.");
+    }
+
+    texture_file_data output{};
+    output.width = width;
+    output.height = height;
+
+    std::size_t offset{dds_header_size};
+
+    if((pixel_flags & dds_fourcc_flag) != 0 && code == fourcc("DX10"))
+    {
+        if(std::size(data) < dds_header_size + dds_dx10_header_size)
+        {
+            throw_error("DDS DX10 header is truncated.");
+        }
+
+        const auto dimension {read<std::uint32_t>(data, 132)};
+        const auto misc_flags{read<std::uint32_t>(data, 136)};
+        const auto array_size{read<std::uint32_t>(data, 140)};
+
+        if(dimension != dds_texture2d_dimension || (misc_flags & dds_texturecube_flag) != 0 || array_size > 1)
+        {
+            throw_error("Only 2D textures are supported.");
+        }
+
+        output.format = dxgi_format(read<std::uint32_t>(data, 128));
+        offset += dds_dx10_header_size;
+    }
+    else if((pixel_flags & dds_fourcc_flag) != 0)
+    {
+        output.format = fourcc_format(code);
+    }
+    else if((pixel_flags & dds_rgb_flag) != 0 && bit_count == 32)
+    {
+        output.format = red_mask == 0x000000FF ? texture_format::r8g8b8a8_unorm : texture_format::b8g8r8a8_unorm;
+    }
+    else
+    {
+        throw_error("Unsupported DDS pixel format.");
+    }
+
+    const auto block{*format_block(output.format)};
+    const std::uint32_t level_count{(flags & dds_mipmap_count_flag) != 0 ? std::max(mipmap_count, 1u) : 1u};
+
+    if(level_count > mip_level_count(width, height))
+    {
+        throw_error("DDS mipmap count is greater than the mip chain of the texture.");
+    }
+
+    output.levels.reserve(level_count);
+
+    for(std::uint32_t i{}; i < level_count; ++i)
+    {
+        texture_file_level level{};
+        level.width  = std::max(width >> i, 1u);
+        level.height = std::max(height >> i, 1u);
+        level.offset = offset;
+        level.size   = level_size(block, level.width, level.height);
+
+        if(level.size > std::size(data) - offset)
+        {
+            throw_error("DDS level #" + std::to_string(i) + " is truncated.");
+        }
+
+        offset += level.size;
+        output.levels.emplace_back(level);
+    }
+
+    output.data = std::move(data);
+
+    return output;
+}
+
+bool is_texture_file(std::span<const std::uint8_t> data) noexcept
+{
+    if(std::size(data) >= std::size(ktx2_identifier) && std::equal(std::begin(ktx2_identifier), std::end(ktx2_identifier), std::begin(data)))
+    {
+        return true;
+    }
+
+    return std::size(data) >= 4 && read<std::uint32_t>(data, 0) == dds_magic;
+}
+
+texture_file_data decode_texture_file(const std::filesystem::path& file)
+{
+    return decode_texture_file(read_file<std::vector<std::uint8_t>>(file));
+}
+
+texture_file_data decode_texture_file(std::span<const std::uint8_t> data)
+{
+    return decode_texture_file(std::vector<std::uint8_t>{std::begin(data), std::end(data)});
+}
+
+texture_file_data decode_texture_file(std::vector<std::uint8_t>&& data)
+{
+    if(std::size(data) >= std::size(ktx2_identifier) && std::equal(std::begin(ktx2_identifier), std::end(ktx2_identifier), std::begin(data)))
+    {
+        return parse_ktx2(std::move(data));
+    }
+
+    if(std::size(data) >= 4 && read<std::uint32_t>(data, 0) == dds_magic)
+    {
+        return parse_dds(std::move(data));
+    }
+
+    throw_error("Neither a KTX2 nor a DDS file.");
+}
+
+texture_file_data decode_texture_file(std::istream& stream)
+{
+    assert(stream && "Invalid stream.");
+
+    return decode_texture_file(std::vector<std::uint8_t>{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}});
+}
+
+}
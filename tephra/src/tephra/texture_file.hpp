@@ -0,0 +1,71 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef TEPHRA_TEXTURE_FILE_HPP_INCLUDED
+#define TEPHRA_TEXTURE_FILE_HPP_INCLUDED
+
+#include "config.hpp"
+
+#include <filesystem>
+#include <istream>
+#include <vector>
+#include <span>
+
+#include "enumerations.hpp"
+
+namespace tph
+{
+
+//A mip level of a texture file, its texels (or blocks of texels) are tightly packed
+struct texture_file_level
+{
+    std::uint32_t width{};
+    std::uint32_t height{};
+    std::uint64_t offset{}; //In texture_file_data::data
+    std::uint64_t size{};
+};
+
+//Content of a KTX2 or DDS file, ready to be copied to a texture of the same format.
+//Only 2D textures without array layers nor cube faces are supported, and KTX2 files must not be supercompressed.
+//Supported formats are BC1 to BC7, ETC2, EAC, and 8 bits RGBA or BGRA.
+//Files can not have more levels than a complete mip chain (see mip_level_count).
+//KTX2 files with a level count of 0 ask for the chain to be generated, only their base level is loaded and no level is generated.
+struct texture_file_data
+{
+    texture_format format{};
+    std::uint32_t width{};
+    std::uint32_t height{};
+    std::vector<texture_file_level> levels{}; //Largest level first
+    std::vector<std::uint8_t> data{};         //The whole file, levels refer to its content
+};
+
+//Returns true if data begins with the identifier of a KTX2 or DDS file
+TEPHRA_API bool is_texture_file(std::span<const std::uint8_t> data) noexcept;
+
+TEPHRA_API texture_file_data decode_texture_file(const std::filesystem::path& file);
+TEPHRA_API texture_file_data decode_texture_file(std::span<const std::uint8_t> data);
+TEPHRA_API texture_file_data decode_texture_file(std::vector<std::uint8_t>&& data);
+TEPHRA_API texture_file_data decode_texture_file(std::istream& stream);
+
+}
+
+#endif
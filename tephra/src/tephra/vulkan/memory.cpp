@@ -36,10 +36,11 @@ using namespace tph::vulkan::functions;
 namespace tph::vulkan
 {
 
-memory_heap_chunk::memory_heap_chunk(memory_heap* parent, std::uint64_t offset, std::uint64_t size) noexcept
+memory_heap_chunk::memory_heap_chunk(memory_heap* parent, std::uint64_t offset, std::uint64_t size, std::uint32_t block) noexcept
 :m_parent{parent}
 ,m_offset{offset}
 ,m_size{size}
+,m_block{block}
 {
 
 }
@@ -61,6 +62,7 @@ memory_heap_chunk::memory_heap_chunk(memory_heap_chunk&& other) noexcept
 :m_parent{std::exchange(other.m_parent, nullptr)}
 ,m_offset{other.m_offset}
 ,m_size{other.m_size}
+,m_block{other.m_block}
 ,m_mapped{other.m_mapped}
 {
 
@@ -71,6 +73,7 @@ memory_heap_chunk& memory_heap_chunk::operator=(memory_heap_chunk&& other) noexc
     std::swap(other.m_parent, m_parent);
     std::swap(other.m_offset, m_offset);
     std::swap(other.m_size, m_size);
+    std::swap(other.m_block, m_block);
     std::swap(other.m_mapped, m_mapped);
 
     return *this;
@@ -146,9 +149,9 @@ memory_heap::memory_heap(const device_context& context, std::uint32_t type, std:
 ,m_size{size}
 ,m_free_space{size}
 ,m_coherent{coherent}
-,m_heap{std::in_place_type<non_dedicated_heap>, granularity, non_coherent_atom_size}
+,m_heap{std::in_place_type<non_dedicated_heap>, size, granularity, non_coherent_atom_size}
 {
-    std::get<non_dedicated_heap>(m_heap).ranges.reserve(64);
+
 }
 
 memory_heap::memory_heap(const device_context& context, VkImage image, std::uint32_t type, std::uint64_t size)
@@ -231,14 +234,16 @@ memory_heap_chunk memory_heap::allocate_pseudo_dedicated(memory_resource_type re
 {
     assert(!dedicated() && "tph::vulkan::memory_heap::allocate_pseudo_dedicated called on a dedicated memory heap");
 
-    auto& heap{std::get<non_dedicated_heap>(m_heap)};
+    auto chunk{try_allocate(resource_type, size, 1)};
 
-    heap.ranges.emplace_back(memory_range{0, size, resource_type});
+    if(!chunk.has_value())
+    {
+        throw vulkan::error{VK_ERROR_OUT_OF_DEVICE_MEMORY};
+    }
 
-    m_free_space -= size;
-    m_allocation_count = 1;
+    assert(chunk->offset() == 0 && "tph::vulkan::memory_heap::allocate_pseudo_dedicated called on a non-empty memory heap");
 
-    return memory_heap_chunk{this, 0, size};
+    return std::move(*chunk);
 }
 
 std::optional<memory_heap_chunk> memory_heap::try_allocate(memory_resource_type resource_type, std::uint64_t size, std::uint64_t alignment)
@@ -249,116 +254,46 @@ std::optional<memory_heap_chunk> memory_heap::try_allocate(memory_resource_type
 
     std::lock_guard lock{heap.mutex};
 
-    //The whole algorithm is basically first-fit + coalescing
+    //TLSF, see tlsf.hpp
+    const auto allocation{heap.allocator.allocate(resource_type, size, alignment)};
 
-    //Push it at the begginning if the heap is empty
-    if(std::empty(heap.ranges) && size <= m_size)
+    if(!allocation.has_value())
     {
-        heap.ranges.emplace_back(memory_range{0, size, resource_type});
-
-        m_free_space -= size;
-        m_allocation_count = 1;
-
-        return std::make_optional(memory_heap_chunk{this, 0, size});
+        return std::nullopt;
     }
 
-    //Try to push it at the end
-    const auto try_push = [this, &heap, resource_type, size, alignment]
-    {
-        const memory_range& last{heap.ranges.back()};
-
-        if(last.type == resource_type)
-        {
-            const std::uint64_t end{align_up(last.offset + last.size, alignment)};
-
-            if(m_size - end >= size)
-            {
-                heap.ranges.emplace_back(memory_range{end, size, resource_type});
-
-                return std::cend(heap.ranges) - 1;
-            }
-        }
-        else
-        {
-            //Take care of the linear/non-linear granularity
-            const std::uint64_t end{align_up(last.offset + last.size, std::max(alignment, heap.granularity))};
-
-            if(m_size - end >= size)
-            {
-                heap.ranges.emplace_back(memory_range{end, size, resource_type});
+    m_free_space = heap.allocator.free_space();
+    m_allocation_count = heap.allocator.allocation_count();
 
-                return std::cend(heap.ranges) - 1;
-            }
-        }
-
-        return std::cend(heap.ranges);
-    };
+    return std::make_optional(memory_heap_chunk{this, allocation->offset, allocation->size, allocation->block});
+}
 
-    if(const auto it{try_push()}; it != std::cend(heap.ranges))
+std::uint64_t memory_heap::largest_free_block() const
+{
+    if(dedicated())
     {
-        m_free_space -= it->size;
-        m_allocation_count += 1;
-
-        return std::make_optional(memory_heap_chunk{this, it->offset, it->size});
+        return m_free_space;
     }
 
-    //Try to insert it at a suitable place
-    const auto try_insert = [&heap, resource_type, size, alignment]() -> std::vector<memory_range>::const_iterator
-    {
-        for(auto it{std::cbegin(heap.ranges)}; it != std::cend(heap.ranges) - 1; ++it)
-        {
-            const auto next{it + 1};
-
-            if(it->type == resource_type && next->type == resource_type)
-            {
-                const std::uint64_t end{align_up(it->offset + it->size, alignment)};
-
-                if(static_cast<std::int64_t>(next->offset) - static_cast<std::int64_t>(end) >= static_cast<std::int64_t>(size))
-                {
-                    return heap.ranges.insert(next, memory_range{end, size, resource_type});
-                }
-            }
-            else
-            {
-                std::uint64_t begin{};
-                if(it->type != resource_type)
-                {
-                    begin = align_up(it->offset + it->size, std::max(alignment, heap.granularity));
-                }
-                else
-                {
-                    begin = align_up(it->offset + it->size, alignment);
-                }
-
-                std::uint64_t end{};
-                if(next->type != resource_type)
-                {
-                    end = align_down(next->offset, std::max(alignment, heap.granularity));
-                }
-                else
-                {
-                    end = align_down(next->offset, alignment);
-                }
+    const auto& heap{std::get<non_dedicated_heap>(m_heap)};
 
-                if(static_cast<std::int64_t>(end) - static_cast<std::int64_t>(begin) >= static_cast<std::int64_t>(size))
-                {
-                    return heap.ranges.insert(next, memory_range{begin, size, resource_type});
-                }
-            }
-        }
+    std::lock_guard lock{heap.mutex};
 
-        return std::cend(heap.ranges);
-    };
+    return heap.allocator.largest_free_block();
+}
 
-    if(const auto it{try_insert()}; it != std::cend(heap.ranges))
+std::size_t memory_heap::free_block_count() const
+{
+    if(dedicated())
     {
-        m_free_space -= it->size;
-        m_allocation_count += 1;
-
-        return std::make_optional(memory_heap_chunk{this, it->offset, it->size});
+        return m_free_space > 0 ? 1 : 0;
     }
 
-    return std::nullopt;
+    const auto& heap{std::get<non_dedicated_heap>(m_heap)};
+
+    std::lock_guard lock{heap.mutex};
+
+    return heap.allocator.free_block_count();
 }
 
 void* memory_heap::map()
@@ -488,18 +423,10 @@ void memory_heap::unregister_chunk(const memory_heap_chunk& chunk) noexcept
 
         std::lock_guard lock{heap.mutex};
 
-        const auto predicate = [](const memory_range& range, const memory_heap_chunk& chunk)
-        {
-            return range.offset < chunk.m_offset;
-        };
-
-        const auto it{std::lower_bound(std::cbegin(heap.ranges), std::cend(heap.ranges), chunk, predicate)};
-        assert(it != std::cend(heap.ranges) && "Bad memory heap chunk.");
-
-        m_free_space += it->size;
-        m_allocation_count -= 1;
+        heap.allocator.free(chunk.m_block);
 
-        heap.ranges.erase(it);
+        m_free_space = heap.allocator.free_space();
+        m_allocation_count = heap.allocator.allocation_count();
     }
 }
 
@@ -799,6 +726,60 @@ memory_allocator::heap_sizes memory_allocator::used_memory() const
     return output;
 }
 
+memory_allocator::heap_sizes memory_allocator::free_block_count() const
+{
+    std::lock_guard lock{m_mutex};
+
+    heap_sizes output{};
+
+    for(auto& heap : m_heaps)
+    {
+        const auto flags{m_heaps_flags[m_memory_properties.memoryTypes[heap->type()].heapIndex]};
+
+        if((flags & (VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) == (VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+        {
+            output.device_shared += heap->free_block_count();
+        }
+        else if(flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        {
+            output.device_local += heap->free_block_count();
+        }
+        else if(flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            output.host_shared += heap->free_block_count();
+        }
+    }
+
+    return output;
+}
+
+memory_allocator::heap_sizes memory_allocator::largest_free_block() const
+{
+    std::lock_guard lock{m_mutex};
+
+    heap_sizes output{};
+
+    for(auto& heap : m_heaps)
+    {
+        const auto flags{m_heaps_flags[m_memory_properties.memoryTypes[heap->type()].heapIndex]};
+
+        if((flags & (VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) == (VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+        {
+            output.device_shared = std::max(output.device_shared, heap->largest_free_block());
+        }
+        else if(flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        {
+            output.device_local = std::max(output.device_local, heap->largest_free_block());
+        }
+        else if(flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            output.host_shared = std::max(output.host_shared, heap->largest_free_block());
+        }
+    }
+
+    return output;
+}
+
 memory_allocator::heap_sizes memory_allocator::allocated_memory() const
 {
     std::lock_guard lock{m_mutex};
@@ -33,24 +33,19 @@
 #include <variant>
 
 #include "vulkan.hpp"
+#include "tlsf.hpp"
 
 namespace tph::vulkan
 {
 
 class memory_heap;
 
-enum class memory_resource_type : std::uint32_t
-{
-    linear = 0,
-    non_linear = 1,
-};
-
 class TEPHRA_API memory_heap_chunk
 {
     friend class memory_heap;
 
 private:
-    explicit memory_heap_chunk(memory_heap* parent, std::uint64_t offset, std::uint64_t size) noexcept;
+    explicit memory_heap_chunk(memory_heap* parent, std::uint64_t offset, std::uint64_t size, std::uint32_t block = tlsf_allocator::npos) noexcept;
 
 public:
     constexpr memory_heap_chunk() = default;
@@ -99,6 +94,7 @@ private:
     memory_heap* m_parent{};
     std::uint64_t m_offset{};
     std::uint64_t m_size{};
+    std::uint32_t m_block{tlsf_allocator::npos};
     mutable bool m_mapped{};
 };
 
@@ -116,9 +112,10 @@ private:
 
     struct non_dedicated_heap
     {
-        non_dedicated_heap(std::uint64_t _granularity, std::uint64_t _non_coherent_atom_size)
+        non_dedicated_heap(std::uint64_t size, std::uint64_t _granularity, std::uint64_t _non_coherent_atom_size)
         :granularity{_granularity}
         ,non_coherent_atom_size{_non_coherent_atom_size}
+        ,allocator{size, _granularity}
         {
 
         }
@@ -126,7 +123,7 @@ private:
         const std::uint64_t granularity{};
         const std::uint64_t non_coherent_atom_size{};
         std::uint64_t map_count{};
-        std::vector<memory_range> ranges{};
+        tlsf_allocator allocator{};
         mutable std::mutex mutex{};
     };
 
@@ -171,6 +168,10 @@ public:
         return m_allocation_count;
     }
 
+    //Fragmentation metrics, the heap is fragmented if its largest free block is much smaller than its free space
+    std::uint64_t largest_free_block() const;
+    std::size_t free_block_count() const;
+
     bool coherent() const noexcept
     {
         return m_coherent;
@@ -248,6 +249,8 @@ public:
     heap_sizes allocation_count() const;
     heap_sizes allocated_memory() const;
     heap_sizes used_memory() const;
+    heap_sizes free_block_count() const;
+    heap_sizes largest_free_block() const;
 
     heap_sizes dedicated_heap_count() const;
     heap_sizes dedicated_allocation_count() const;
@@ -0,0 +1,395 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include "tlsf.hpp"
+
+#include <cassert>
+#include <algorithm>
+#include <bit>
+
+namespace tph::vulkan
+{
+
+tlsf_allocator::tlsf_allocator(std::uint64_t size, std::uint64_t granularity)
+:m_size{size}
+,m_granularity{granularity}
+,m_free_space{size}
+{
+    assert(size > 0 && "tph::vulkan::tlsf_allocator created with a size of 0.");
+    assert(std::has_single_bit(granularity) && "tph::vulkan::tlsf_allocator granularity must be a power of 2.");
+
+    for(auto& heads : m_heads)
+    {
+        heads.fill(npos);
+    }
+
+    m_blocks.reserve(64);
+
+    const auto index{make_block()};
+    m_blocks[index].size = size;
+
+    insert_free(index);
+}
+
+std::optional<tlsf_allocator::allocation> tlsf_allocator::allocate(memory_resource_type type, std::uint64_t size, std::uint64_t alignment)
+{
+    assert(size > 0 && "tph::vulkan::tlsf_allocator::allocate called with a size of 0.");
+    assert(std::has_single_bit(alignment) && "tph::vulkan::tlsf_allocator::allocate alignment must be a power of 2.");
+
+    if(size > m_free_space)
+    {
+        return std::nullopt;
+    }
+
+    //Good-fit search, the first blocks of the found bin are big enough for the allocation and its alignment padding,
+    //they are only unsuitable if one of their neighbours is of the other resource type
+    std::uint32_t index{npos};
+
+    if(size + alignment - 1 <= m_size)
+    {
+        if(const auto bin{find_free(mapping_search(size + alignment - 1))}; bin)
+        {
+            index = find_fitting(*bin, type, size, alignment);
+        }
+    }
+
+    //Worst case padding: the allocation may have to be moved to the next page and its end may have to be moved to the previous page.
+    //With this padding, any block of the found bin is suitable.
+    const auto other_type{type == memory_resource_type::linear ? memory_resource_type::non_linear : memory_resource_type::linear};
+
+    if(index == npos && m_granularity > 1 && m_type_count[static_cast<std::size_t>(other_type)] > 0)
+    {
+        const std::uint64_t padding{2 * (std::max(alignment, m_granularity) - 1)};
+
+        if(size + padding <= m_size)
+        {
+            if(const auto bin{find_free(mapping_search(size + padding))}; bin)
+            {
+                index = m_heads[bin->fl][bin->sl];
+            }
+        }
+    }
+
+    //The good-fit search skips the bin that may contain a block just big enough, look at it before giving up
+    if(index == npos)
+    {
+        index = find_fitting(mapping(size), type, size, alignment);
+
+        if(index == npos)
+        {
+            return std::nullopt;
+        }
+    }
+
+    const auto offset{fit(index, type, size, alignment)};
+    assert(offset.has_value() && "tph::vulkan::tlsf_allocator::allocate found an unsuitable block.");
+
+    remove_free(index);
+
+    const std::uint64_t begin{*offset};
+    const std::uint64_t end{m_blocks[index].offset + m_blocks[index].size};
+
+    if(begin > m_blocks[index].offset) //Alignment padding becomes a new free block
+    {
+        const auto left{make_block()};
+
+        m_blocks[left].offset = m_blocks[index].offset;
+        m_blocks[left].size = begin - m_blocks[index].offset;
+        m_blocks[left].prev_physical = m_blocks[index].prev_physical;
+        m_blocks[left].next_physical = index;
+
+        if(m_blocks[index].prev_physical != npos)
+        {
+            m_blocks[m_blocks[index].prev_physical].next_physical = left;
+        }
+
+        m_blocks[index].prev_physical = left;
+        m_blocks[index].offset = begin;
+
+        insert_free(left);
+    }
+
+    if(begin + size < end) //Remaining space becomes a new free block
+    {
+        const auto right{make_block()};
+
+        m_blocks[right].offset = begin + size;
+        m_blocks[right].size = end - (begin + size);
+        m_blocks[right].prev_physical = index;
+        m_blocks[right].next_physical = m_blocks[index].next_physical;
+
+        if(m_blocks[index].next_physical != npos)
+        {
+            m_blocks[m_blocks[index].next_physical].prev_physical = right;
+        }
+
+        m_blocks[index].next_physical = right;
+
+        insert_free(right);
+    }
+
+    m_blocks[index].size = size;
+    m_blocks[index].type = type;
+
+    m_free_space -= size;
+    m_allocation_count += 1;
+    m_type_count[static_cast<std::size_t>(type)] += 1;
+
+    return std::make_optional(allocation{begin, size, index});
+}
+
+void tlsf_allocator::free(std::uint32_t index) noexcept
+{
+    assert(index < std::size(m_blocks) && !m_blocks[index].free && "tph::vulkan::tlsf_allocator::free called with an invalid block.");
+
+    m_free_space += m_blocks[index].size;
+    m_allocation_count -= 1;
+    m_type_count[static_cast<std::size_t>(m_blocks[index].type)] -= 1;
+
+    //Coalescing, there is never two adjacent free blocks
+    if(const auto prev{m_blocks[index].prev_physical}; prev != npos && m_blocks[prev].free)
+    {
+        remove_free(prev);
+
+        m_blocks[prev].size += m_blocks[index].size;
+        m_blocks[prev].next_physical = m_blocks[index].next_physical;
+
+        if(m_blocks[index].next_physical != npos)
+        {
+            m_blocks[m_blocks[index].next_physical].prev_physical = prev;
+        }
+
+        release_block(index);
+        index = prev;
+    }
+
+    if(const auto next{m_blocks[index].next_physical}; next != npos && m_blocks[next].free)
+    {
+        remove_free(next);
+
+        m_blocks[index].size += m_blocks[next].size;
+        m_blocks[index].next_physical = m_blocks[next].next_physical;
+
+        if(m_blocks[next].next_physical != npos)
+        {
+            m_blocks[m_blocks[next].next_physical].prev_physical = index;
+        }
+
+        release_block(next);
+    }
+
+    insert_free(index);
+}
+
+std::uint64_t tlsf_allocator::largest_free_block() const noexcept
+{
+    if(m_fl_bitmap == 0)
+    {
+        return 0;
+    }
+
+    //Blocks of the highest non-empty bin are bigger than any other free block, but not sorted
+    const auto fl{static_cast<std::uint32_t>(std::bit_width(m_fl_bitmap) - 1)};
+    const auto sl{static_cast<std::uint32_t>(std::bit_width(m_sl_bitmaps[fl]) - 1)};
+
+    std::uint64_t output{};
+
+    for(auto index{m_heads[fl][sl]}; index != npos; index = m_blocks[index].next_free)
+    {
+        output = std::max(output, m_blocks[index].size);
+    }
+
+    return output;
+}
+
+tlsf_allocator::bin_index tlsf_allocator::mapping(std::uint64_t size) noexcept
+{
+    if(size < sl_count) //Small blocks are linearly subdivided
+    {
+        return bin_index{0, static_cast<std::uint32_t>(size)};
+    }
+
+    const auto log2{static_cast<std::uint32_t>(std::bit_width(size) - 1)};
+
+    return bin_index{log2 - sl_log2 + 1, static_cast<std::uint32_t>(size >> (log2 - sl_log2)) ^ sl_count};
+}
+
+tlsf_allocator::bin_index tlsf_allocator::mapping_search(std::uint64_t size) noexcept
+{
+    //Round up to the next bin, so any block of the returned bin is big enough
+    if(size >= sl_count)
+    {
+        size += (std::uint64_t{1} << (static_cast<std::uint32_t>(std::bit_width(size) - 1) - sl_log2)) - 1;
+    }
+
+    return mapping(size);
+}
+
+std::optional<tlsf_allocator::bin_index> tlsf_allocator::find_free(bin_index index) const noexcept
+{
+    std::uint32_t sl_map{m_sl_bitmaps[index.fl] & (~std::uint32_t{} << index.sl)};
+
+    if(sl_map == 0)
+    {
+        if(index.fl + 1 >= fl_count)
+        {
+            return std::nullopt;
+        }
+
+        const std::uint64_t fl_map{m_fl_bitmap & (~std::uint64_t{} << (index.fl + 1))};
+
+        if(fl_map == 0)
+        {
+            return std::nullopt;
+        }
+
+        index.fl = static_cast<std::uint32_t>(std::countr_zero(fl_map));
+        sl_map = m_sl_bitmaps[index.fl];
+    }
+
+    return std::make_optional(bin_index{index.fl, static_cast<std::uint32_t>(std::countr_zero(sl_map))});
+}
+
+std::uint32_t tlsf_allocator::find_fitting(bin_index index, memory_resource_type type, std::uint64_t size, std::uint64_t alignment) const noexcept
+{
+    //Only look at the first blocks of the bin to stay O(1)
+    auto current{m_heads[index.fl][index.sl]};
+
+    for(std::uint32_t i{}; i < max_candidates && current != npos; ++i, current = m_blocks[current].next_free)
+    {
+        if(fit(current, type, size, alignment).has_value())
+        {
+            return current;
+        }
+    }
+
+    return npos;
+}
+
+std::optional<std::uint64_t> tlsf_allocator::fit(std::uint32_t index, memory_resource_type type, std::uint64_t size, std::uint64_t alignment) const noexcept
+{
+    const block& current{m_blocks[index]};
+
+    std::uint64_t begin{align_up(current.offset, alignment)};
+    std::uint64_t end{current.offset + current.size};
+
+    //Neighbours of a free block are always used blocks
+    if(m_granularity > 1)
+    {
+        if(current.prev_physical != npos && m_blocks[current.prev_physical].type != type)
+        {
+            begin = align_up(current.offset, std::max(alignment, m_granularity));
+        }
+
+        if(current.next_physical != npos && m_blocks[current.next_physical].type != type)
+        {
+            end = align_down(end, m_granularity);
+        }
+    }
+
+    if(begin > end || end - begin < size)
+    {
+        return std::nullopt;
+    }
+
+    return std::make_optional(begin);
+}
+
+void tlsf_allocator::insert_free(std::uint32_t index) noexcept
+{
+    const auto [fl, sl]{mapping(m_blocks[index].size)};
+    const auto head{m_heads[fl][sl]};
+
+    m_blocks[index].free = true;
+    m_blocks[index].prev_free = npos;
+    m_blocks[index].next_free = head;
+
+    if(head != npos)
+    {
+        m_blocks[head].prev_free = index;
+    }
+
+    m_heads[fl][sl] = index;
+    m_fl_bitmap |= std::uint64_t{1} << fl;
+    m_sl_bitmaps[fl] |= std::uint32_t{1} << sl;
+    m_free_block_count += 1;
+}
+
+void tlsf_allocator::remove_free(std::uint32_t index) noexcept
+{
+    const auto [fl, sl]{mapping(m_blocks[index].size)};
+    block& current{m_blocks[index]};
+
+    if(current.prev_free != npos)
+    {
+        m_blocks[current.prev_free].next_free = current.next_free;
+    }
+    else
+    {
+        m_heads[fl][sl] = current.next_free;
+    }
+
+    if(current.next_free != npos)
+    {
+        m_blocks[current.next_free].prev_free = current.prev_free;
+    }
+
+    if(m_heads[fl][sl] == npos)
+    {
+        m_sl_bitmaps[fl] &= ~(std::uint32_t{1} << sl);
+
+        if(m_sl_bitmaps[fl] == 0)
+        {
+            m_fl_bitmap &= ~(std::uint64_t{1} << fl);
+        }
+    }
+
+    current.free = false;
+    current.prev_free = npos;
+    current.next_free = npos;
+    m_free_block_count -= 1;
+}
+
+std::uint32_t tlsf_allocator::make_block()
+{
+    if(m_unused_blocks != npos)
+    {
+        const auto index{m_unused_blocks};
+        m_unused_blocks = m_blocks[index].next_free;
+        m_blocks[index] = block{};
+
+        return index;
+    }
+
+    m_blocks.emplace_back();
+
+    return static_cast<std::uint32_t>(std::size(m_blocks) - 1);
+}
+
+void tlsf_allocator::release_block(std::uint32_t index) noexcept
+{
+    m_blocks[index] = block{};
+    m_blocks[index].next_free = m_unused_blocks;
+    m_unused_blocks = index;
+}
+
+}
@@ -0,0 +1,150 @@
+//MIT License
+//
+//Copyright (c) 2021 Alexy Pellegrini
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef TEPHRA_VULKAN_TLSF_HPP_INCLUDED
+#define TEPHRA_VULKAN_TLSF_HPP_INCLUDED
+
+#include "../config.hpp"
+
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <optional>
+#include <limits>
+
+namespace tph::vulkan
+{
+
+enum class memory_resource_type : std::uint32_t
+{
+    linear = 0,
+    non_linear = 1,
+};
+
+//Two-level segregated fit allocator, allocation and deallocation are O(1).
+//It only manages offsets, so it does not depend on any Vulkan object.
+//Linear and non-linear resources never share a page of "granularity" bytes (bufferImageGranularity).
+class TEPHRA_API tlsf_allocator
+{
+public:
+    static constexpr std::uint32_t npos{std::numeric_limits<std::uint32_t>::max()};
+
+    struct allocation
+    {
+        std::uint64_t offset{};
+        std::uint64_t size{};
+        std::uint32_t block{npos};
+    };
+
+public:
+    tlsf_allocator() = default;
+    explicit tlsf_allocator(std::uint64_t size, std::uint64_t granularity = 1);
+
+    ~tlsf_allocator() = default;
+    tlsf_allocator(const tlsf_allocator&) = delete;
+    tlsf_allocator& operator=(const tlsf_allocator&) = delete;
+    tlsf_allocator(tlsf_allocator&&) noexcept = default;
+    tlsf_allocator& operator=(tlsf_allocator&&) noexcept = default;
+
+    std::optional<allocation> allocate(memory_resource_type type, std::uint64_t size, std::uint64_t alignment);
+    void free(std::uint32_t block) noexcept;
+
+    //Size of the biggest free block, an allocation of this size with no alignment requirement can not fail
+    std::uint64_t largest_free_block() const noexcept;
+
+    std::uint64_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    std::uint64_t granularity() const noexcept
+    {
+        return m_granularity;
+    }
+
+    std::uint64_t free_space() const noexcept
+    {
+        return m_free_space;
+    }
+
+    std::size_t allocation_count() const noexcept
+    {
+        return m_allocation_count;
+    }
+
+    std::size_t free_block_count() const noexcept
+    {
+        return m_free_block_count;
+    }
+
+private:
+    static constexpr std::uint32_t sl_log2{5};
+    static constexpr std::uint32_t sl_count{1u << sl_log2};
+    static constexpr std::uint32_t fl_count{64 - sl_log2 + 1};
+    static constexpr std::uint32_t max_candidates{8};
+
+    struct block
+    {
+        std::uint64_t offset{};
+        std::uint64_t size{};
+        std::uint32_t prev_physical{npos};
+        std::uint32_t next_physical{npos};
+        std::uint32_t prev_free{npos};
+        std::uint32_t next_free{npos};
+        memory_resource_type type{};
+        bool free{};
+    };
+
+    struct bin_index
+    {
+        std::uint32_t fl{};
+        std::uint32_t sl{};
+    };
+
+    static bin_index mapping(std::uint64_t size) noexcept;
+    static bin_index mapping_search(std::uint64_t size) noexcept;
+
+    std::optional<bin_index> find_free(bin_index index) const noexcept;
+    std::uint32_t find_fitting(bin_index index, memory_resource_type type, std::uint64_t size, std::uint64_t alignment) const noexcept;
+    std::optional<std::uint64_t> fit(std::uint32_t block, memory_resource_type type, std::uint64_t size, std::uint64_t alignment) const noexcept;
+    void insert_free(std::uint32_t block) noexcept;
+    void remove_free(std::uint32_t block) noexcept;
+    std::uint32_t make_block();
+    void release_block(std::uint32_t block) noexcept;
+
+private:
+    std::uint64_t m_size{};
+    std::uint64_t m_granularity{1};
+    std::uint64_t m_free_space{};
+    std::size_t m_allocation_count{};
+    std::size_t m_free_block_count{};
+    std::array<std::size_t, 2> m_type_count{};
+    std::uint64_t m_fl_bitmap{};
+    std::array<std::uint32_t, fl_count> m_sl_bitmaps{};
+    std::array<std::array<std::uint32_t, sl_count>, fl_count> m_heads{};
+    std::vector<block> m_blocks{};
+    std::uint32_t m_unused_blocks{npos};
+};
+
+}
+
+#endif
@@ -0,0 +1,254 @@
+#include <tephra/image.hpp>
+#include <tephra/texture.hpp>
+#include <tephra/texture_file.hpp>
+
+#include <vector>
+#include <array>
+#include <random>
+#include <cstring>
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_CONSOLE_WIDTH 120
+#include <catch2/catch.hpp>
+
+//CPU-only tests of tph::generate_mipmaps and tph::decode_texture_file. No Vulkan device is needed.
+
+namespace
+{
+
+void write32(std::vector<std::uint8_t>& data, std::size_t offset, std::uint32_t value)
+{
+    for(std::size_t i{}; i < 4; ++i)
+    {
+        data[offset + i] = static_cast<std::uint8_t>(value >> (i * 8));
+    }
+}
+
+void write64(std::vector<std::uint8_t>& data, std::size_t offset, std::uint64_t value)
+{
+    for(std::size_t i{}; i < 8; ++i)
+    {
+        data[offset + i] = static_cast<std::uint8_t>(value >> (i * 8));
+    }
+}
+
+//Box filter of the level before, used as reference for the vectorized kernels
+std::vector<std::uint8_t> reference_downsample(std::uint32_t width, std::uint32_t height, const std::vector<std::uint8_t>& rgba)
+{
+    const std::uint32_t next_width {std::max(width / 2, 1u)};
+    const std::uint32_t next_height{std::max(height / 2, 1u)};
+
+    std::vector<std::uint8_t> output(static_cast<std::size_t>(next_width) * next_height * 4);
+
+    for(std::uint32_t y{}; y < next_height; ++y)
+    {
+        for(std::uint32_t x{}; x < next_width; ++x)
+        {
+            const std::uint32_t x0{std::min(x * 2, width - 1)};
+            const std::uint32_t x1{std::min(x * 2 + 1, width - 1)};
+            const std::uint32_t y0{std::min(y * 2, height - 1)};
+            const std::uint32_t y1{std::min(y * 2 + 1, height - 1)};
+
+            for(std::uint32_t c{}; c < 4; ++c)
+            {
+                const auto texel = [&](std::uint32_t tx, std::uint32_t ty)
+                {
+                    return static_cast<std::uint32_t>(rgba[(static_cast<std::size_t>(ty) * width + tx) * 4 + c]);
+                };
+
+                const auto sum{texel(x0, y0) + texel(x1, y0) + texel(x0, y1) + texel(x1, y1)};
+                output[(static_cast<std::size_t>(y) * next_width + x) * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+
+    return output;
+}
+
+std::vector<std::uint8_t> make_ktx2(std::uint32_t format, std::uint32_t width, std::uint32_t height, std::span<const std::uint64_t> sizes)
+{
+    constexpr std::array<std::uint8_t, 12> identifier{0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    std::vector<std::uint8_t> output(80 + std::size(sizes) * 24);
+    std::memcpy(std::data(output), std::data(identifier), std::size(identifier));
+    write32(output, 12, format);
+    write32(output, 16, 1);
+    write32(output, 20, width);
+    write32(output, 24, height);
+    write32(output, 36, 1);
+    write32(output, 40, static_cast<std::uint32_t>(std::size(sizes)));
+
+    //KTX2 stores the smallest level first
+    std::uint64_t offset{std::size(output)};
+    for(std::size_t i{std::size(sizes)}; i-- > 0;)
+    {
+        write64(output, 80 + i * 24, offset);
+        write64(output, 88 + i * 24, sizes[i]);
+        offset += sizes[i];
+    }
+
+    output.resize(offset);
+
+    return output;
+}
+
+std::vector<std::uint8_t> make_dds(const char (&code)[5], std::uint32_t width, std::uint32_t height, std::uint32_t level_count, std::uint64_t data_size)
+{
+    std::vector<std::uint8_t> output(128);
+    write32(output, 0, 0x20534444);
+    write32(output, 4, 124);
+    write32(output, 8, 0x1007 | 0x20000);
+    write32(output, 12, height);
+    write32(output, 16, width);
+    write32(output, 28, level_count);
+    write32(output, 76, 32);
+    write32(output, 80, 0x04);
+    std::memcpy(&output[84], code, 4);
+
+    output.resize(128 + data_size);
+
+    return output;
+}
+
+}
+
+TEST_CASE("mip_level_count", "[mipmaps]")
+{
+    REQUIRE(tph::mip_level_count(1, 1) == 1);
+    REQUIRE(tph::mip_level_count(2, 1) == 2);
+    REQUIRE(tph::mip_level_count(256, 256) == 9);
+    REQUIRE(tph::mip_level_count(300, 17) == 9);
+}
+
+TEST_CASE("generate_mipmaps matches a 2x2 box filter", "[mipmaps]")
+{
+    std::mt19937 engine{42};
+    std::uniform_int_distribution<std::uint32_t> dist{0, 255};
+
+    //Odd, tiny and wide sizes, so the vectorized loops and their tails are all used
+    for(const auto& [width, height] : {std::pair{1u, 1u}, std::pair{2u, 2u}, std::pair{7u, 3u}, std::pair{64u, 64u}, std::pair{131u, 9u}, std::pair{1u, 40u}})
+    {
+        std::vector<std::uint8_t> rgba(static_cast<std::size_t>(width) * height * 4);
+        for(auto& value : rgba)
+        {
+            value = static_cast<std::uint8_t>(dist(engine));
+        }
+
+        const auto levels{tph::generate_mipmaps(width, height, rgba)};
+        REQUIRE(std::size(levels) == tph::mip_level_count(width, height) - 1);
+
+        auto expected{rgba};
+        std::uint32_t expected_width{width};
+        std::uint32_t expected_height{height};
+
+        for(auto&& level : levels)
+        {
+            expected = reference_downsample(expected_width, expected_height, expected);
+            expected_width  = std::max(expected_width / 2, 1u);
+            expected_height = std::max(expected_height / 2, 1u);
+
+            REQUIRE(level.width == expected_width);
+            REQUIRE(level.height == expected_height);
+            REQUIRE(level.pixels == expected);
+        }
+
+        REQUIRE((std::empty(levels) || (levels.back().width == 1 && levels.back().height == 1)));
+    }
+}
+
+TEST_CASE("decode_texture_file KTX2", "[texture_file]")
+{
+    //BC7 16x8: 4x2 blocks, then 2x1, then 1x1, of 16 bytes each
+    const std::array<std::uint64_t, 3> sizes{128, 32, 16};
+    const auto data{make_ktx2(146, 16, 8, sizes)};
+
+    REQUIRE(tph::is_texture_file(data));
+
+    const auto file{tph::decode_texture_file(data)};
+    REQUIRE(file.format == tph::texture_format::bc7_srgb_block);
+    REQUIRE(file.width == 16);
+    REQUIRE(file.height == 8);
+    REQUIRE(std::size(file.levels) == 3);
+    REQUIRE(file.levels[1].width == 8);
+    REQUIRE(file.levels[1].height == 4);
+    REQUIRE(file.levels[0].offset + file.levels[0].size == std::size(data));
+
+    SECTION("Invalid level size")
+    {
+        auto invalid{data};
+        write64(invalid, 88, 127);
+
+        REQUIRE_THROWS_AS(tph::decode_texture_file(invalid), std::runtime_error);
+    }
+
+    SECTION("Supercompression")
+    {
+        auto invalid{data};
+        write32(invalid, 44, 1);
+
+        REQUIRE_THROWS_AS(tph::decode_texture_file(invalid), std::runtime_error);
+    }
+
+    SECTION("Truncated")
+    {
+        auto invalid{data};
+        invalid.resize(200);
+
+        REQUIRE_THROWS_AS(tph::decode_texture_file(invalid), std::runtime_error);
+    }
+
+    SECTION("More levels than the mip chain")
+    {
+        const std::array<std::uint64_t, 6> too_many{128, 32, 16, 16, 16, 16};
+        REQUIRE_THROWS_AS(tph::decode_texture_file(make_ktx2(146, 16, 8, too_many)), std::runtime_error);
+
+        auto invalid{data};
+        write32(invalid, 40, 40);
+
+        REQUIRE_THROWS_AS(tph::decode_texture_file(invalid), std::runtime_error);
+    }
+
+    SECTION("Level count of 0 loads the base level")
+    {
+        auto generated{data};
+        write32(generated, 40, 0);
+
+        const auto base{tph::decode_texture_file(generated)};
+        REQUIRE(std::size(base.levels) == 1);
+        REQUIRE(base.levels[0].width == 16);
+        REQUIRE(base.levels[0].height == 8);
+        REQUIRE(base.levels[0].size == 128);
+    }
+}
+
+TEST_CASE("decode_texture_file DDS", "[texture_file]")
+{
+    //DXT1 7x5: 2x2 blocks, then 1x1 (3x2), then 1x1 (1x1), of 8 bytes each
+    const auto data{make_dds("DXT1", 7, 5, 3, 48)};
+
+    REQUIRE(tph::is_texture_file(data));
+
+    const auto file{tph::decode_texture_file(data)};
+    REQUIRE(file.format == tph::texture_format::bc1_rgba_unorm_block);
+    REQUIRE(std::size(file.levels) == 3);
+    REQUIRE(file.levels[1].width == 3);
+    REQUIRE(file.levels[1].height == 2);
+    REQUIRE(file.levels[2].offset == 128 + 40);
+    REQUIRE(file.levels[2].size == 8);
+
+    REQUIRE_THROWS_AS(tph::decode_texture_file(make_dds("DXT1", 7, 5, 3, 47)), std::runtime_error);
+    REQUIRE_THROWS_AS(tph::decode_texture_file(make_dds("ABCD", 7, 5, 3, 48)), std::runtime_error);
+
+    //7x5 has a chain of 3 levels
+    REQUIRE_THROWS_AS(tph::decode_texture_file(make_dds("DXT1", 7, 5, 4, 56)), std::runtime_error);
+    REQUIRE_THROWS_AS(tph::decode_texture_file(make_dds("DXT1", 7, 5, 40, 48)), std::runtime_error);
+}
+
+TEST_CASE("is_texture_file", "[texture_file]")
+{
+    const std::array<std::uint8_t, 8> png{0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    REQUIRE(!tph::is_texture_file(png));
+    REQUIRE(!tph::is_texture_file(std::span<const std::uint8_t>{}));
+    REQUIRE_THROWS_AS(tph::decode_texture_file(png), std::runtime_error);
+}